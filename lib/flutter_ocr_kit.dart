@@ -1,6 +1,7 @@
 import 'dart:convert';
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:ui' show Rect;
 
 import 'package:ffi/ffi.dart';
 import 'package:flutter/foundation.dart';
@@ -194,59 +195,1273 @@ class OcrKit {
   /// [imagePath] - Path to image file
   /// [detThreshold] - Detection confidence threshold (0.0 - 1.0), default 0.3
   /// [recThreshold] - Recognition confidence threshold (0.0 - 1.0), default 0.5
+  /// [detector] - Detection backend; [TextDetector.classic] or
+  ///              [TextDetector.auto] for screenshots and rendered documents
+  /// [priority] - [RequestPriority.background] for library / batch work, which
+  ///              then yields the engine to interactive requests between stages
+  /// [model] - Id from [registerOcrModel]; loaded on demand instead of the
+  ///           models from [initOcr]
+  /// [halfResPostProcess] - Find text regions on a half-resolution detection
+  ///           map and refine only box edges at full resolution; cheaper on
+  ///           large, dense pages
+  /// [mergeFragments] - Join detected pieces of one printed line (split at
+  ///           wide gaps or font changes) and recognize each line once
   ///
   /// Returns [OcrResult] containing recognized text lines with bounding boxes.
   static OcrResult recognizeText(
     String imagePath, {
     double detThreshold = 0.3,
     double recThreshold = 0.5,
+    TextDetector detector = TextDetector.neural,
+    RequestPriority priority = RequestPriority.interactive,
+    String? model,
+    bool halfResPostProcess = false,
+    bool mergeFragments = false,
   }) {
-    _checkOcrInitialized();
+    if (model == null) {
+      _checkOcrInitialized();
+    }
 
     final pathPtr = imagePath.toNativeUtf8().cast<Char>();
+    Pointer<Char>? optionsPtr;
     Pointer<Char>? resultPtr;
 
     try {
-      resultPtr = _native.recognizeTextFromPath(pathPtr, detThreshold, recThreshold);
+      if (detector == TextDetector.neural &&
+          priority == RequestPriority.interactive &&
+          model == null &&
+          !halfResPostProcess &&
+          !mergeFragments) {
+        resultPtr = _native.recognizeTextFromPath(pathPtr, detThreshold, recThreshold);
+      } else {
+        optionsPtr = _ocrOptionsJson(
+                detThreshold, recThreshold, detector, priority, model, halfResPostProcess,
+                mergeFragments)
+            .toNativeUtf8()
+            .cast<Char>();
+        resultPtr = _native.recognizeTextFromPathWithOptions(pathPtr, optionsPtr);
+      }
       final jsonStr = resultPtr.cast<Utf8>().toDartString();
       return OcrResult.fromJson(jsonDecode(jsonStr));
     } finally {
       calloc.free(pathPtr);
+      if (optionsPtr != null) {
+        calloc.free(optionsPtr);
+      }
       if (resultPtr != null) {
         _native.freeString(resultPtr);
       }
     }
   }
 
+  static String _ocrOptionsJson(
+    double detThreshold,
+    double recThreshold,
+    TextDetector detector,
+    RequestPriority priority, [
+    String? model,
+    bool halfResPostProcess = false,
+    bool mergeFragments = false,
+  ]) {
+    return jsonEncode({
+      'det_threshold': detThreshold,
+      'rec_threshold': recThreshold,
+      'detector': detector.name,
+      'priority': priority.name,
+      if (model != null) 'model': model,
+      if (halfResPostProcess) 'det_half_res': true,
+      if (mergeFragments) 'merge_fragments': true,
+    });
+  }
+
   /// Detect text regions only (without recognition)
   ///
   /// Faster than full OCR when you only need text locations.
   static TextDetectionResult detectText(
     String imagePath, {
     double threshold = 0.3,
+    TextDetector detector = TextDetector.neural,
+    RequestPriority priority = RequestPriority.interactive,
+    String? model,
+    bool halfResPostProcess = false,
+    bool mergeFragments = false,
   }) {
-    _checkOcrInitialized();
+    // The classic detector needs no models
+    if (detector != TextDetector.classic && model == null) {
+      _checkOcrInitialized();
+    }
 
     final pathPtr = imagePath.toNativeUtf8().cast<Char>();
+    Pointer<Char>? optionsPtr;
     Pointer<Char>? resultPtr;
 
     try {
-      resultPtr = _native.detectTextFromPath(pathPtr, threshold);
+      if (detector == TextDetector.neural &&
+          priority == RequestPriority.interactive &&
+          model == null &&
+          !halfResPostProcess &&
+          !mergeFragments) {
+        resultPtr = _native.detectTextFromPath(pathPtr, threshold);
+      } else {
+        optionsPtr = _ocrOptionsJson(
+                threshold, 0.5, detector, priority, model, halfResPostProcess,
+                mergeFragments)
+            .toNativeUtf8()
+            .cast<Char>();
+        resultPtr = _native.detectTextFromPathWithOptions(pathPtr, optionsPtr);
+      }
       final jsonStr = resultPtr.cast<Utf8>().toDartString();
       return TextDetectionResult.fromJson(jsonDecode(jsonStr));
     } finally {
       calloc.free(pathPtr);
+      if (optionsPtr != null) {
+        calloc.free(optionsPtr);
+      }
       if (resultPtr != null) {
         _native.freeString(resultPtr);
       }
     }
   }
 
-  static void _checkLayoutInitialized() {
-    if (!_isLayoutInitialized) {
-      throw StateError(
-        'Layout detection is not initialized. Call OcrKit.init() first.',
+  /// Recognize only the lines needed to fill [fields]
+  ///
+  /// Detects the page once, then recognizes boxes a batch at a time, most
+  /// promising first (inside a field's region, or next to its anchor once
+  /// the anchor has been read), and stops as soon as every field has a value
+  /// scoring at least [minScore]. Unresolved fields come back as null.
+  ///
+  /// ```dart
+  /// final result = OcrKit.queryFields(path, [
+  ///   FieldQuerySpec(name: 'number', pattern: r'[A-Z]{2}-?\d{8}', region: 'top_third'),
+  ///   FieldQuerySpec(name: 'total', pattern: r'\d[\d,]*', anchors: ['總計', 'Total']),
+  /// ]);
+  /// ```
+  static FieldQueryResult queryFields(
+    String imagePath,
+    List<FieldQuerySpec> fields, {
+    double minScore = 0.8,
+    int maxErrors = 1,
+    double detThreshold = 0.3,
+    TextDetector detector = TextDetector.neural,
+    RequestPriority priority = RequestPriority.interactive,
+    String? model,
+  }) {
+    // Recognition needs the models whichever detector runs
+    if (model == null) {
+      _checkOcrInitialized();
+    }
+
+    final pathPtr = imagePath.toNativeUtf8().cast<Char>();
+    final queryPtr = jsonEncode({
+      'fields': fields.map((f) => f.toJson()).toList(),
+      'min_score': minScore,
+      'max_errors': maxErrors,
+      'det_threshold': detThreshold,
+      'detector': detector.name,
+      'priority': priority.name,
+      if (model != null) 'model': model,
+    }).toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.queryFieldsFromPath(pathPtr, queryPtr);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+      return FieldQueryResult.fromJson(response as Map<String, dynamic>);
+    } finally {
+      calloc.free(pathPtr);
+      calloc.free(queryPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Recognize text from a video file (screen recordings, lectures, subtitles)
+  ///
+  /// Frames are sampled every [sampleIntervalMs]; OCR only runs on frames whose
+  /// downscaled content differs from the last keyframe by more than
+  /// [changeThreshold] (mean absolute difference, 0.0 - 1.0).
+  ///
+  /// [roi] - Optional region to watch and recognize (e.g. a subtitle band)
+  ///
+  /// Returns [VideoOcrResult] with timestamped, deduplicated text segments.
+  static VideoOcrResult recognizeVideo(
+    String videoPath, {
+    double sampleIntervalMs = 500,
+    double changeThreshold = 0.02,
+    Rect? roi,
+    double detThreshold = 0.3,
+    double recThreshold = 0.5,
+  }) {
+    _checkOcrInitialized();
+
+    final pathPtr = videoPath.toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.recognizeTextFromVideo(
+        pathPtr,
+        sampleIntervalMs,
+        changeThreshold,
+        roi?.left.round() ?? 0,
+        roi?.top.round() ?? 0,
+        roi?.width.round() ?? 0,
+        roi?.height.round() ?? 0,
+        detThreshold,
+        recThreshold,
       );
+      final jsonStr = resultPtr.cast<Utf8>().toDartString();
+      return VideoOcrResult.fromJson(jsonDecode(jsonStr));
+    } finally {
+      calloc.free(pathPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  // ========================
+  // Search Index API
+  // ========================
+
+  /// Add an OCR'd page to the search index at [indexPath]
+  ///
+  /// Pages are buffered natively; call [commitSearchIndex] to persist them.
+  /// Box ids of hits are the positions of lines in [result].
+  static void addToSearchIndex(
+    String indexPath, {
+    required int docId,
+    required int page,
+    required OcrResult result,
+  }) {
+    final pathPtr = indexPath.toNativeUtf8().cast<Char>();
+    final jsonPtr = jsonEncode(result.toJson()).toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.searchIndexAddPage(pathPtr, docId, page, jsonPtr);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+    } finally {
+      calloc.free(pathPtr);
+      calloc.free(jsonPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Append buffered pages to the index file
+  ///
+  /// Returns false if the file could not be written.
+  static bool commitSearchIndex(String indexPath) {
+    final pathPtr = indexPath.toNativeUtf8().cast<Char>();
+    try {
+      return _native.searchIndexCommit(pathPtr) == 1;
+    } finally {
+      calloc.free(pathPtr);
+    }
+  }
+
+  /// Merge all index segments into one
+  ///
+  /// Each commit appends a segment, and commits merge segments on their own
+  /// once there are more than 8, so query cost stays bounded. Compacting
+  /// after large imports brings it down to one term lookup per query term.
+  static bool compactSearchIndex(String indexPath) {
+    final pathPtr = indexPath.toNativeUtf8().cast<Char>();
+    try {
+      return _native.searchIndexCompact(pathPtr) == 1;
+    } finally {
+      calloc.free(pathPtr);
+    }
+  }
+
+  /// Search the index at [indexPath]
+  ///
+  /// [minCoverage] - Fraction of query terms (CJK bigrams / Latin tokens)
+  ///                 a line must contain; 1.0 requires all of them
+  static SearchResult searchIndex(
+    String indexPath,
+    String query, {
+    int maxHits = 50,
+    double minCoverage = 1.0,
+  }) {
+    final pathPtr = indexPath.toNativeUtf8().cast<Char>();
+    final queryPtr = query.toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.searchIndexQuery(pathPtr, queryPtr, maxHits, minCoverage);
+      final jsonStr = resultPtr.cast<Utf8>().toDartString();
+      return SearchResult.fromJson(jsonDecode(jsonStr));
+    } finally {
+      calloc.free(pathPtr);
+      calloc.free(queryPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Get index size information (lines, segments, pending)
+  static Map<String, dynamic> searchIndexInfo(String indexPath) {
+    final pathPtr = indexPath.toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.searchIndexInfo(pathPtr);
+      return jsonDecode(resultPtr.cast<Utf8>().toDartString()) as Map<String, dynamic>;
+    } finally {
+      calloc.free(pathPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Close the index at [indexPath], dropping uncommitted pages
+  static void closeSearchIndex(String indexPath) {
+    final pathPtr = indexPath.toNativeUtf8().cast<Char>();
+    try {
+      _native.searchIndexClose(pathPtr);
+    } finally {
+      calloc.free(pathPtr);
+    }
+  }
+
+  // ========================
+  // Fuzzy Match API
+  // ========================
+
+  /// Find lines of [result] containing [pattern] with up to [maxErrors]
+  /// character edits (OCR misreads, dropped or extra characters)
+  ///
+  /// Matching is case-insensitive; patterns are limited to 64 characters.
+  static FuzzyMatchResult fuzzyMatch(
+    OcrResult result,
+    String pattern, {
+    int maxErrors = 1,
+  }) {
+    final jsonPtr = jsonEncode(result.toJson()).toNativeUtf8().cast<Char>();
+    final patternPtr = pattern.toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.fuzzyMatchText(jsonPtr, patternPtr, maxErrors);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+      return FuzzyMatchResult.fromJson(response as Map<String, dynamic>);
+    } finally {
+      calloc.free(jsonPtr);
+      calloc.free(patternPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Fuzzy search over every committed line of the index at [indexPath]
+  static FuzzyMatchResult searchIndexFuzzy(
+    String indexPath,
+    String pattern, {
+    int maxErrors = 1,
+    int maxHits = 50,
+  }) {
+    final pathPtr = indexPath.toNativeUtf8().cast<Char>();
+    final patternPtr = pattern.toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.searchIndexFuzzy(pathPtr, patternPtr, maxErrors, maxHits);
+      final jsonStr = resultPtr.cast<Utf8>().toDartString();
+      return FuzzyMatchResult.fromJson(jsonDecode(jsonStr));
+    } finally {
+      calloc.free(pathPtr);
+      calloc.free(patternPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  // ========================
+  // Result Store API
+  // ========================
+
+  /// Recognize [imagePaths] into the result store at [storePath]
+  ///
+  /// Results go straight into the store's binary records without JSON, so
+  /// batch jobs over many thousands of pages stay flat in memory. Read them
+  /// back with [readResultStore]. Runs at [RequestPriority.background].
+  static ResultStoreBatch recognizeFilesToStore(
+    String storePath,
+    List<String> imagePaths, {
+    double detThreshold = 0.3,
+    double recThreshold = 0.5,
+  }) {
+    _checkOcrInitialized();
+
+    final pathPtr = storePath.toNativeUtf8().cast<Char>();
+    final listPtr = jsonEncode(imagePaths).toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.resultStoreRecognizeFiles(
+          pathPtr, listPtr, detThreshold, recThreshold);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+      return ResultStoreBatch.fromJson(response as Map<String, dynamic>);
+    } finally {
+      calloc.free(pathPtr);
+      calloc.free(listPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Append an existing [result] to the store; returns its page number
+  ///
+  /// Pages are buffered natively; call [flushResultStore] to persist them.
+  static int appendToResultStore(
+    String storePath,
+    OcrResult result, {
+    String source = '',
+  }) {
+    final pathPtr = storePath.toNativeUtf8().cast<Char>();
+    final sourcePtr = source.toNativeUtf8().cast<Char>();
+    final jsonPtr = jsonEncode(result.toJson()).toNativeUtf8().cast<Char>();
+
+    try {
+      final page = _native.resultStoreAppendPage(pathPtr, sourcePtr, jsonPtr);
+      if (page < 0) {
+        throw ArgumentError('Invalid OCR result');
+      }
+      return page;
+    } finally {
+      calloc.free(pathPtr);
+      calloc.free(sourcePtr);
+      calloc.free(jsonPtr);
+    }
+  }
+
+  /// Write buffered pages to the store file
+  ///
+  /// Returns false if the file could not be written.
+  static bool flushResultStore(String storePath) {
+    final pathPtr = storePath.toNativeUtf8().cast<Char>();
+    try {
+      return _native.resultStoreFlush(pathPtr) == 1;
+    } finally {
+      calloc.free(pathPtr);
+    }
+  }
+
+  /// Read [count] stored pages starting at [firstPage]
+  static List<StoredPage> readResultStore(
+    String storePath, {
+    int firstPage = 0,
+    int count = 100,
+  }) {
+    final pathPtr = storePath.toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.resultStoreReadPages(pathPtr, firstPage, count);
+      final json = jsonDecode(resultPtr.cast<Utf8>().toDartString()) as Map<String, dynamic>;
+      return (json['pages'] as List<dynamic>)
+          .map((p) => StoredPage.fromJson(p as Map<String, dynamic>))
+          .toList();
+    } finally {
+      calloc.free(pathPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Get store size information (pages, lines, chunks, pending, bytes)
+  static Map<String, dynamic> resultStoreInfo(String storePath) {
+    final pathPtr = storePath.toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.resultStoreInfo(pathPtr);
+      return jsonDecode(resultPtr.cast<Utf8>().toDartString()) as Map<String, dynamic>;
+    } finally {
+      calloc.free(pathPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Flush and close the store at [storePath]
+  static void closeResultStore(String storePath) {
+    final pathPtr = storePath.toNativeUtf8().cast<Char>();
+    try {
+      _native.resultStoreClose(pathPtr);
+    } finally {
+      calloc.free(pathPtr);
+    }
+  }
+
+  // ========================
+  // Memory API
+  // ========================
+
+  /// Back large detection input tensors with transparent huge pages
+  ///
+  /// Fewer TLB misses on big pages where the OS supports THP (Linux/Android);
+  /// ignored elsewhere. Applies to buffers allocated after the call.
+  static void setHugePages(bool enable) {
+    _native.setOcrHugePages(enable ? 1 : 0);
+  }
+
+  /// Process memory (rss_kb, peak_rss_kb) and engine tensor buffer bytes
+  static Map<String, dynamic> getMemoryStats() {
+    Pointer<Char>? resultPtr;
+    try {
+      resultPtr = _native.getOcrMemoryStats();
+      return jsonDecode(resultPtr.cast<Utf8>().toDartString()) as Map<String, dynamic>;
+    } finally {
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  // ========================
+  // Log API
+  // ========================
+
+  /// Set which native log messages are kept
+  ///
+  /// Kept messages go to an in-memory ring read with [dumpLog]; those at
+  /// [echo] or more severe also go to logcat / os_log (errors and warnings
+  /// by default). Messages above [level] are skipped before their arguments
+  /// are evaluated, and debug messages are compiled out of release builds
+  /// entirely. Returns the resolved settings.
+  static Map<String, dynamic> setLogConfig({OcrLogLevel? level, OcrLogLevel? echo}) {
+    final configPtr = jsonEncode({
+      if (level != null) 'level': level.name,
+      if (echo != null) 'echo': echo.name,
+    }).toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.setOcrLogConfig(configPtr);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+      return response as Map<String, dynamic>;
+    } finally {
+      calloc.free(configPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Most recent native log entries, oldest first (the ring keeps 512)
+  static List<OcrLogEntry> dumpLog({int maxEntries = 0}) {
+    Pointer<Char>? resultPtr;
+    try {
+      resultPtr = _native.dumpOcrLog(maxEntries);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString()) as Map<String, dynamic>;
+      return (response['entries'] as List)
+          .map((e) => OcrLogEntry.fromJson(e as Map<String, dynamic>))
+          .toList();
+    } finally {
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Start the next [dumpLog] from messages logged after this call
+  static void clearLog() {
+    _native.clearOcrLog();
+  }
+
+  // ========================
+  // Thread Configuration API
+  // ========================
+
+  /// Set thread counts and CPU pinning for the det and rec sessions
+  ///
+  /// Pinning det to performance cores keeps it off little cores and away from
+  /// the UI thread's core. Takes effect on the next [initOcr] (call
+  /// [releaseOcr] first if already initialized). Returns the resolved configuration.
+  ///
+  /// [tasks] sizes and pins the worker pool for the CPU stages; give it cores
+  /// the sessions do not use. It only applies before the first OCR call.
+  static Map<String, dynamic> setThreadConfig({
+    OcrThreadConfig? det,
+    OcrThreadConfig? rec,
+    OcrTaskConfig? tasks,
+  }) {
+    final config = <String, dynamic>{
+      if (det != null) 'det': det.toJson(),
+      if (rec != null) 'rec': rec.toJson(),
+      if (tasks != null) 'tasks': tasks.toJson(),
+    };
+    final configPtr = jsonEncode(config).toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.setOcrThreadConfig(configPtr);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+      return response as Map<String, dynamic>;
+    } finally {
+      calloc.free(configPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Performance / efficiency core ids and per-core capacity
+  static Map<String, dynamic> getCpuTopology() {
+    Pointer<Char>? resultPtr;
+    try {
+      resultPtr = _native.getCpuTopology();
+      return jsonDecode(resultPtr.cast<Utf8>().toDartString()) as Map<String, dynamic>;
+    } finally {
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Run OCR on [imagePath] [iterations] times and report det / rec / total
+  /// latency (mean, stddev, p50, p90, p99, min, max in ms)
+  static Map<String, dynamic> benchmark(
+    String imagePath, {
+    int iterations = 20,
+    double detThreshold = 0.3,
+    double recThreshold = 0.5,
+  }) {
+    _checkOcrInitialized();
+
+    final pathPtr = imagePath.toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.benchmarkOcr(pathPtr, iterations, detThreshold, recThreshold);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+      return response as Map<String, dynamic>;
+    } finally {
+      calloc.free(pathPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Replay the golden corpus at [manifestPath] against the loaded models
+  ///
+  /// Reports per-image CER, recall and box IoU against the recorded goldens,
+  /// best-of-[iterations] det / rec latency, and drift of the optimized
+  /// kernels from their reference versions. `passed` is false if any image or
+  /// kernel is outside the tolerances. [halfResPostProcess] measures the
+  /// half-resolution detection post-processing against the same goldens.
+  static Map<String, dynamic> runGoldenCorpus(
+    String manifestPath, {
+    int iterations = 1,
+    double maxCer = 0.01,
+    double minRecall = 0.98,
+    double matchIou = 0.5,
+    bool halfResPostProcess = false,
+  }) {
+    _checkOcrInitialized();
+
+    final pathPtr = manifestPath.toNativeUtf8().cast<Char>();
+    final optionsPtr = jsonEncode({
+      'iterations': iterations,
+      'max_cer': maxCer,
+      'min_recall': minRecall,
+      'match_iou': matchIou,
+      'det_half_res': halfResPostProcess,
+    }).toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.runGoldenCorpus(pathPtr, optionsPtr);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+      return response as Map<String, dynamic>;
+    } finally {
+      calloc.free(pathPtr);
+      calloc.free(optionsPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  static void _checkLayoutInitialized() {
+    if (!_isLayoutInitialized) {
+      throw StateError(
+        'Layout detection is not initialized. Call OcrKit.init() first.',
+      );
+    }
+  }
+
+  // ========================
+  // PDF API
+  // ========================
+
+  /// Recognize a PDF file
+  ///
+  /// Born-digital pages are read from the PDF's text layer without running
+  /// detection or recognition. Image-only pages (scans) are rasterized with
+  /// the long side at [renderLongSide] px and OCR'd. Pages are processed one
+  /// at a time with [model] (a registered OCR model id; the default engine
+  /// when null). Needs a build with PDFium (OCR_KIT_WITH_PDFIUM); otherwise
+  /// throws [UnsupportedError].
+  static PdfOcrResult recognizePdf(
+    String pdfPath, {
+    String password = '',
+    int firstPage = 0,
+    int pageCount = -1,
+    bool useTextLayer = true,
+    int renderLongSide = 1920,
+    double detThreshold = 0.3,
+    double recThreshold = 0.5,
+    TextDetector detector = TextDetector.neural,
+    RequestPriority priority = RequestPriority.interactive,
+    String? model,
+  }) {
+    final options = _pdfOptionsJson(firstPage, pageCount, useTextLayer, renderLongSide,
+        detThreshold, recThreshold, detector, priority, model);
+    return PdfOcrResult.fromJson(_callPdf(
+        (pdf, pass, opts) => _native.recognizeTextFromPdf(pdf, pass, opts),
+        pdfPath, password, options));
+  }
+
+  /// Recognize a PDF page by page into the result store at [storePath]
+  ///
+  /// Same page handling as [recognizePdf], in constant memory for documents
+  /// of any length. Stored page sources are "<pdfPath>#<page>". Runs at
+  /// [RequestPriority.background] unless told otherwise.
+  static ResultStoreBatch recognizePdfToStore(
+    String storePath,
+    String pdfPath, {
+    String password = '',
+    int firstPage = 0,
+    int pageCount = -1,
+    bool useTextLayer = true,
+    int renderLongSide = 1920,
+    double detThreshold = 0.3,
+    double recThreshold = 0.5,
+    TextDetector detector = TextDetector.neural,
+    RequestPriority priority = RequestPriority.background,
+    String? model,
+  }) {
+    final options = _pdfOptionsJson(firstPage, pageCount, useTextLayer, renderLongSide,
+        detThreshold, recThreshold, detector, priority, model);
+    final storePtr = storePath.toNativeUtf8().cast<Char>();
+    try {
+      return ResultStoreBatch.fromJson(_callPdf(
+          (pdf, pass, opts) => _native.resultStoreRecognizePdf(storePtr, pdf, pass, opts),
+          pdfPath, password, options));
+    } finally {
+      calloc.free(storePtr);
+    }
+  }
+
+  static String _pdfOptionsJson(
+    int firstPage,
+    int pageCount,
+    bool useTextLayer,
+    int renderLongSide,
+    double detThreshold,
+    double recThreshold,
+    TextDetector detector,
+    RequestPriority priority,
+    String? model,
+  ) {
+    return jsonEncode({
+      'first_page': firstPage,
+      'page_count': pageCount,
+      'use_text_layer': useTextLayer,
+      'render_long_side': renderLongSide,
+      'det_threshold': detThreshold,
+      'rec_threshold': recThreshold,
+      'detector': detector.name,
+      'priority': priority.name,
+      if (model != null) 'model': model,
+    });
+  }
+
+  static Map<String, dynamic> _callPdf(
+    Pointer<Char> Function(Pointer<Char>, Pointer<Char>, Pointer<Char>) call,
+    String pdfPath,
+    String password,
+    String options,
+  ) {
+    final pdfPtr = pdfPath.toNativeUtf8().cast<Char>();
+    final passwordPtr = password.toNativeUtf8().cast<Char>();
+    final optionsPtr = options.toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = call(pdfPtr, passwordPtr, optionsPtr);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString()) as Map<String, dynamic>;
+      if (response['code'] == 'PDF_UNSUPPORTED') {
+        throw UnsupportedError(response['error'] as String);
+      }
+      if (response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+      return response;
+    } finally {
+      calloc.free(pdfPtr);
+      calloc.free(passwordPtr);
+      calloc.free(optionsPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  // ========================
+  // Template API
+  // ========================
+
+  /// Register a known form (e-invoice, in-house form) under [templateId]
+  ///
+  /// [referencePath] is a clean scan of the form; [fields] give each value's
+  /// region in that image's pixels. Pages that match the form later skip
+  /// detection and only have these regions recognized.
+  static void registerTemplate(
+    String templateId,
+    String referencePath,
+    List<TemplateField> fields,
+  ) {
+    final idPtr = templateId.toNativeUtf8().cast<Char>();
+    final pathPtr = referencePath.toNativeUtf8().cast<Char>();
+    final fieldsPtr = jsonEncode(fields.map((f) => f.toJson()).toList()).toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.registerTemplate(idPtr, pathPtr, fieldsPtr);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+    } finally {
+      calloc.free(idPtr);
+      calloc.free(pathPtr);
+      calloc.free(fieldsPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Remove a template; false if none was registered under [templateId]
+  static bool unregisterTemplate(String templateId) {
+    final idPtr = templateId.toNativeUtf8().cast<Char>();
+    try {
+      return _native.unregisterTemplate(idPtr) != 0;
+    } finally {
+      calloc.free(idPtr);
+    }
+  }
+
+  /// Registered templates and how many pages each has matched
+  static List<TemplateInfo> listTemplates() {
+    Pointer<Char>? resultPtr;
+    try {
+      resultPtr = _native.listTemplates();
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString()) as Map<String, dynamic>;
+      return (response['templates'] as List)
+          .map((t) => TemplateInfo.fromJson(t as Map<String, dynamic>))
+          .toList();
+    } finally {
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// OCR a page that may be one of the registered templates
+  ///
+  /// A page whose signature is close to a template ([maxEdgeDistance],
+  /// [maxRegionDistance]) and aligns to it with at least [minInliers] anchor
+  /// matches has only that template's fields recognized. Any other page goes
+  /// through full OCR, returned in [TemplateOcrResult.fallback].
+  static TemplateOcrResult recognizeWithTemplates(
+    String imagePath, {
+    double maxEdgeDistance = 0.3,
+    double maxRegionDistance = 0.25,
+    int minInliers = 15,
+    double detThreshold = 0.3,
+    double recThreshold = 0.5,
+    TextDetector detector = TextDetector.neural,
+    RequestPriority priority = RequestPriority.interactive,
+    String? model,
+  }) {
+    if (model == null) {
+      _checkOcrInitialized();
+    }
+
+    final pathPtr = imagePath.toNativeUtf8().cast<Char>();
+    final optionsPtr = jsonEncode({
+      'max_edge_distance': maxEdgeDistance,
+      'max_region_distance': maxRegionDistance,
+      'min_inliers': minInliers,
+      'det_threshold': detThreshold,
+      'rec_threshold': recThreshold,
+      'detector': detector.name,
+      'priority': priority.name,
+      if (model != null) 'model': model,
+    }).toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.recognizeWithTemplates(pathPtr, optionsPtr);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+      return TemplateOcrResult.fromJson(response as Map<String, dynamic>);
+    } finally {
+      calloc.free(pathPtr);
+      calloc.free(optionsPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  // ========================
+  // Page Cache API
+  // ========================
+
+  /// OCR a page and keep it open for re-runs at other thresholds
+  ///
+  /// The page's image, detection map and every box read are cached, so
+  /// [recognizePage] with a new `detThreshold` only re-extracts boxes and
+  /// recognizes the ones not read before, and a new `recThreshold` runs no
+  /// model at all. [detector] and [model] are fixed for the page. Close pages
+  /// with [closePage]; the least recently used ones are also dropped when the
+  /// cache goes over its budget ([setPageCacheBudget]).
+  static PageOcrResult openPage(
+    String imagePath, {
+    double detThreshold = 0.3,
+    double recThreshold = 0.5,
+    TextDetector detector = TextDetector.neural,
+    RequestPriority priority = RequestPriority.interactive,
+    String? model,
+    bool halfResPostProcess = false,
+    bool mergeFragments = false,
+  }) {
+    if (model == null) {
+      _checkOcrInitialized();
+    }
+
+    final pathPtr = imagePath.toNativeUtf8().cast<Char>();
+    final optionsPtr = _ocrOptionsJson(
+            detThreshold, recThreshold, detector, priority, model, halfResPostProcess,
+            mergeFragments)
+        .toNativeUtf8()
+        .cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.openOcrPage(pathPtr, optionsPtr);
+      return _pageResult(resultPtr);
+    } finally {
+      calloc.free(pathPtr);
+      calloc.free(optionsPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Re-run an open page at new thresholds
+  ///
+  /// Throws [StateError] when the page was closed or evicted; open it again.
+  static PageOcrResult recognizePage(
+    int page, {
+    double detThreshold = 0.3,
+    double recThreshold = 0.5,
+    RequestPriority priority = RequestPriority.interactive,
+    bool halfResPostProcess = false,
+    bool mergeFragments = false,
+  }) {
+    final optionsPtr = _ocrOptionsJson(
+            detThreshold, recThreshold, TextDetector.neural, priority, null, halfResPostProcess,
+            mergeFragments)
+        .toNativeUtf8()
+        .cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.recognizeOcrPage(page, optionsPtr);
+      return _pageResult(resultPtr);
+    } finally {
+      calloc.free(optionsPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  static PageOcrResult _pageResult(Pointer<Char> resultPtr) {
+    final response = jsonDecode(resultPtr.cast<Utf8>().toDartString()) as Map<String, dynamic>;
+    if (response['code'] == 'PAGE_NOT_FOUND') {
+      throw StateError(response['error'] as String);
+    }
+    if (response['error'] != null) {
+      throw ArgumentError(response['error']);
+    }
+    return PageOcrResult.fromJson(response);
+  }
+
+  /// Drop an open page; false if it was already closed or evicted
+  static bool closePage(int page) {
+    return _native.closeOcrPage(page) != 0;
+  }
+
+  /// Drop every open page
+  static void closeAllPages() {
+    _native.closeAllOcrPages();
+  }
+
+  /// Memory allowed for open pages in megabytes (default 64, 0 = unlimited)
+  static void setPageCacheBudget(int megabytes) {
+    if (megabytes < 0) {
+      throw ArgumentError.value(megabytes, 'megabytes', 'must be >= 0');
+    }
+    _native.setPageCacheBudget(megabytes);
+  }
+
+  /// Open pages, their memory and how many box reads the cache saved
+  static PageCacheStats getPageCacheStats() {
+    Pointer<Char>? resultPtr;
+    try {
+      resultPtr = _native.getPageCacheStats();
+      return PageCacheStats.fromJson(
+          jsonDecode(resultPtr.cast<Utf8>().toDartString()) as Map<String, dynamic>);
+    } finally {
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  // ========================
+  // Rec Cascade API
+  // ========================
+
+  /// Re-read low-confidence lines with a second, more accurate rec model
+  ///
+  /// Every line is still read by the model from [initOcr]; only lines whose
+  /// mean character probability is under [minMeanScore], or that have a
+  /// character under [minCharScore], go through [recModelPath] (e.g. the
+  /// server rec model behind the mobile one). Both models must use the same
+  /// dictionary. Call after [initOcr]; [releaseOcr] unloads it too.
+  static void enableRecCascade(
+    String recModelPath, {
+    double minMeanScore = 0.9,
+    double minCharScore = 0.5,
+  }) {
+    _checkOcrInitialized();
+
+    final pathPtr = recModelPath.toNativeUtf8().cast<Char>();
+    final optionsPtr = jsonEncode({
+      'min_mean_score': minMeanScore,
+      'min_char_score': minCharScore,
+    }).toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.enableRecCascade(pathPtr, optionsPtr);
+      final response = jsonDecode(resultPtr.cast<Utf8>().toDartString());
+      if (response is Map && response['error'] != null) {
+        throw ArgumentError(response['error']);
+      }
+    } finally {
+      calloc.free(pathPtr);
+      calloc.free(optionsPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Unload the cascade model; lines are read by the [initOcr] model only
+  static void disableRecCascade() {
+    _native.disableRecCascade();
+  }
+
+  /// How many lines the cascade escalated and how long that took
+  static RecCascadeStats getRecCascadeStats() {
+    Pointer<Char>? resultPtr;
+    try {
+      resultPtr = _native.getRecCascadeStats();
+      return RecCascadeStats.fromJson(jsonDecode(resultPtr.cast<Utf8>().toDartString()));
+    } finally {
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Restart the cascade counters
+  static void resetRecCascadeStats() {
+    _native.resetRecCascadeStats();
+  }
+
+  // ========================
+  // Scheduler API
+  // ========================
+
+  /// Queue depth and stage wait times per priority class
+  ///
+  /// Background requests ([recognizeFilesToStore], or calls with
+  /// [RequestPriority.background]) hand the engine to interactive requests
+  /// between pipeline stages; these counters show how long each class waited.
+  static SchedulerStats getSchedulerStats() {
+    Pointer<Char>? resultPtr;
+    try {
+      resultPtr = _native.getOcrSchedulerStats();
+      return SchedulerStats.fromJson(jsonDecode(resultPtr.cast<Utf8>().toDartString()));
+    } finally {
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Restart the scheduler counters
+  static void resetSchedulerStats() {
+    _native.resetOcrSchedulerStats();
+  }
+
+  // ========================
+  // Model Registry API
+  // ========================
+
+  /// Register an OCR model set (e.g. one per language or model size) under
+  /// [modelId]. Nothing is loaded until a request names it with `model:`.
+  static void registerOcrModel(
+    String modelId, {
+    required String detModelPath,
+    required String recModelPath,
+    required String dictPath,
+  }) {
+    final idPtr = modelId.toNativeUtf8().cast<Char>();
+    final detPtr = detModelPath.toNativeUtf8().cast<Char>();
+    final recPtr = recModelPath.toNativeUtf8().cast<Char>();
+    final dictPtr = dictPath.toNativeUtf8().cast<Char>();
+
+    try {
+      _native.registerOcrModel(idPtr, detPtr, recPtr, dictPtr);
+    } finally {
+      calloc.free(idPtr);
+      calloc.free(detPtr);
+      calloc.free(recPtr);
+      calloc.free(dictPtr);
+    }
+  }
+
+  /// Register a layout model (PP-DocLayout M or L) for [detectLayoutWithModel]
+  static void registerLayoutModel(String modelId, String modelPath) {
+    final idPtr = modelId.toNativeUtf8().cast<Char>();
+    final pathPtr = modelPath.toNativeUtf8().cast<Char>();
+
+    try {
+      _native.registerLayoutModel(idPtr, pathPtr);
+    } finally {
+      calloc.free(idPtr);
+      calloc.free(pathPtr);
+    }
+  }
+
+  /// Remove a registered model; returns false if [modelId] was unknown
+  static bool unregisterModel(String modelId) {
+    final idPtr = modelId.toNativeUtf8().cast<Char>();
+    try {
+      return _native.unregisterModel(idPtr) != 0;
+    } finally {
+      calloc.free(idPtr);
+    }
+  }
+
+  /// Resident memory allowed for registered models (0 = unlimited)
+  ///
+  /// When a load would exceed the budget, the least recently used models
+  /// that are not serving a request are unloaded first.
+  static void setModelMemoryBudget(int megabytes) {
+    if (megabytes < 0) {
+      throw ArgumentError.value(megabytes, 'megabytes', 'must be >= 0');
+    }
+    _native.setModelMemoryBudget(megabytes);
+  }
+
+  /// Unload every registered model that is not serving a request
+  static void unloadModels() {
+    _native.unloadModels();
+  }
+
+  /// Budget, resident total and per-model load counters
+  static ModelRegistryStatus getModelRegistryStatus() {
+    Pointer<Char>? resultPtr;
+    try {
+      resultPtr = _native.getModelRegistryStatus();
+      return ModelRegistryStatus.fromJson(jsonDecode(resultPtr.cast<Utf8>().toDartString()));
+    } finally {
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
+    }
+  }
+
+  /// Detect layout with a model from [registerLayoutModel]
+  static LayoutResult detectLayoutWithModel(
+    String modelId,
+    String imagePath, {
+    double confThreshold = 0.5,
+  }) {
+    final idPtr = modelId.toNativeUtf8().cast<Char>();
+    final pathPtr = imagePath.toNativeUtf8().cast<Char>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      resultPtr = _native.detectLayoutWithModel(idPtr, pathPtr, confThreshold);
+      final jsonStr = resultPtr.cast<Utf8>().toDartString();
+      return LayoutResult.fromJson(jsonDecode(jsonStr));
+    } finally {
+      calloc.free(idPtr);
+      calloc.free(pathPtr);
+      if (resultPtr != null) {
+        _native.freeString(resultPtr);
+      }
     }
   }
 
@@ -148,6 +148,726 @@ class OcrKitBindings {
   late final _detectTextFromPath = _detectTextFromPathPtr
       .asFunction<ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>, double)>();
 
+  // ========================
+  // Video OCR API
+  // ========================
+
+  /// Recognize text from a video file, running OCR only on changed keyframes
+  /// roiWidth/roiHeight <= 0 watches the full frame
+  ffi.Pointer<ffi.Char> recognizeTextFromVideo(
+      ffi.Pointer<ffi.Char> videoPath,
+      double sampleIntervalMs,
+      double changeThreshold,
+      int roiX,
+      int roiY,
+      int roiWidth,
+      int roiHeight,
+      double detThreshold,
+      double recThreshold) {
+    return _recognizeTextFromVideo(videoPath, sampleIntervalMs, changeThreshold,
+        roiX, roiY, roiWidth, roiHeight, detThreshold, recThreshold);
+  }
+
+  late final _recognizeTextFromVideoPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>,
+              ffi.Float,
+              ffi.Float,
+              ffi.Int32,
+              ffi.Int32,
+              ffi.Int32,
+              ffi.Int32,
+              ffi.Float,
+              ffi.Float)>>('recognizeTextFromVideo');
+  late final _recognizeTextFromVideo = _recognizeTextFromVideoPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>, double, double,
+          int, int, int, int, double, double)>();
+
+  // ========================
+  // Search Index API
+  // ========================
+
+  /// Add one OCR'd page (OCR result JSON) to a search index
+  ffi.Pointer<ffi.Char> searchIndexAddPage(ffi.Pointer<ffi.Char> indexPath,
+      int docId, int page, ffi.Pointer<ffi.Char> ocrJson) {
+    return _searchIndexAddPage(indexPath, docId, page, ocrJson);
+  }
+
+  late final _searchIndexAddPagePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>, ffi.Int32,
+              ffi.Int32, ffi.Pointer<ffi.Char>)>>('searchIndexAddPage');
+  late final _searchIndexAddPage = _searchIndexAddPagePtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, int, int, ffi.Pointer<ffi.Char>)>();
+
+  /// Append buffered pages to the index file (1 = success)
+  int searchIndexCommit(ffi.Pointer<ffi.Char> indexPath) {
+    return _searchIndexCommit(indexPath);
+  }
+
+  late final _searchIndexCommitPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Pointer<ffi.Char>)>>(
+          'searchIndexCommit');
+  late final _searchIndexCommit =
+      _searchIndexCommitPtr.asFunction<int Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Merge all index segments into one (1 = success)
+  int searchIndexCompact(ffi.Pointer<ffi.Char> indexPath) {
+    return _searchIndexCompact(indexPath);
+  }
+
+  late final _searchIndexCompactPtr =
+      _lookup<ffi.NativeFunction<ffi.Int32 Function(ffi.Pointer<ffi.Char>)>>(
+          'searchIndexCompact');
+  late final _searchIndexCompact =
+      _searchIndexCompactPtr.asFunction<int Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Query a search index
+  ffi.Pointer<ffi.Char> searchIndexQuery(ffi.Pointer<ffi.Char> indexPath,
+      ffi.Pointer<ffi.Char> query, int maxHits, double minCoverage) {
+    return _searchIndexQuery(indexPath, query, maxHits, minCoverage);
+  }
+
+  late final _searchIndexQueryPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>, ffi.Int32, ffi.Float)>>('searchIndexQuery');
+  late final _searchIndexQuery = _searchIndexQueryPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, int, double)>();
+
+  /// Get index size information
+  ffi.Pointer<ffi.Char> searchIndexInfo(ffi.Pointer<ffi.Char> indexPath) {
+    return _searchIndexInfo(indexPath);
+  }
+
+  late final _searchIndexInfoPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>)>>('searchIndexInfo');
+  late final _searchIndexInfo = _searchIndexInfoPtr
+      .asFunction<ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Unmap an index and drop uncommitted pages
+  void searchIndexClose(ffi.Pointer<ffi.Char> indexPath) {
+    return _searchIndexClose(indexPath);
+  }
+
+  late final _searchIndexClosePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char>)>>(
+          'searchIndexClose');
+  late final _searchIndexClose =
+      _searchIndexClosePtr.asFunction<void Function(ffi.Pointer<ffi.Char>)>();
+
+  // ========================
+  // Fuzzy Match API
+  // ========================
+
+  /// Approximate search over the lines of one OCR result JSON
+  ffi.Pointer<ffi.Char> fuzzyMatchText(ffi.Pointer<ffi.Char> ocrJson,
+      ffi.Pointer<ffi.Char> pattern, int maxErrors) {
+    return _fuzzyMatchText(ocrJson, pattern, maxErrors);
+  }
+
+  late final _fuzzyMatchTextPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>, ffi.Int)>>('fuzzyMatchText');
+  late final _fuzzyMatchText = _fuzzyMatchTextPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, int)>();
+
+  /// Approximate search over every committed line of a search index
+  ffi.Pointer<ffi.Char> searchIndexFuzzy(ffi.Pointer<ffi.Char> indexPath,
+      ffi.Pointer<ffi.Char> pattern, int maxErrors, int maxHits) {
+    return _searchIndexFuzzy(indexPath, pattern, maxErrors, maxHits);
+  }
+
+  late final _searchIndexFuzzyPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>, ffi.Int, ffi.Int)>>('searchIndexFuzzy');
+  late final _searchIndexFuzzy = _searchIndexFuzzyPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, int, int)>();
+
+  // ========================
+  // Result Store API
+  // ========================
+
+  /// Recognize a JSON array of image paths into a result store
+  ffi.Pointer<ffi.Char> resultStoreRecognizeFiles(
+      ffi.Pointer<ffi.Char> storePath,
+      ffi.Pointer<ffi.Char> imagePathsJson,
+      double detThreshold,
+      double recThreshold) {
+    return _resultStoreRecognizeFiles(
+        storePath, imagePathsJson, detThreshold, recThreshold);
+  }
+
+  late final _resultStoreRecognizeFilesPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Float,
+              ffi.Float)>>('resultStoreRecognizeFiles');
+  late final _resultStoreRecognizeFiles =
+      _resultStoreRecognizeFilesPtr.asFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>, double, double)>();
+
+  /// Append one OCR result JSON as a page; returns the page number or -1
+  int resultStoreAppendPage(ffi.Pointer<ffi.Char> storePath,
+      ffi.Pointer<ffi.Char> source, ffi.Pointer<ffi.Char> ocrJson) {
+    return _resultStoreAppendPage(storePath, source, ocrJson);
+  }
+
+  late final _resultStoreAppendPagePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Int Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>)>>('resultStoreAppendPage');
+  late final _resultStoreAppendPage = _resultStoreAppendPagePtr.asFunction<
+      int Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  /// Write buffered pages; returns 1 on success
+  int resultStoreFlush(ffi.Pointer<ffi.Char> storePath) {
+    return _resultStoreFlush(storePath);
+  }
+
+  late final _resultStoreFlushPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.Pointer<ffi.Char>)>>(
+          'resultStoreFlush');
+  late final _resultStoreFlush =
+      _resultStoreFlushPtr.asFunction<int Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Read a range of stored pages as JSON
+  ffi.Pointer<ffi.Char> resultStoreReadPages(
+      ffi.Pointer<ffi.Char> storePath, int firstPage, int count) {
+    return _resultStoreReadPages(storePath, firstPage, count);
+  }
+
+  late final _resultStoreReadPagesPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>, ffi.Int, ffi.Int)>>('resultStoreReadPages');
+  late final _resultStoreReadPages = _resultStoreReadPagesPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>, int, int)>();
+
+  /// Store size information
+  ffi.Pointer<ffi.Char> resultStoreInfo(ffi.Pointer<ffi.Char> storePath) {
+    return _resultStoreInfo(storePath);
+  }
+
+  late final _resultStoreInfoPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>)>>('resultStoreInfo');
+  late final _resultStoreInfo = _resultStoreInfoPtr
+      .asFunction<ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Flush and unmap a store
+  void resultStoreClose(ffi.Pointer<ffi.Char> storePath) {
+    return _resultStoreClose(storePath);
+  }
+
+  late final _resultStoreClosePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char>)>>(
+          'resultStoreClose');
+  late final _resultStoreClose =
+      _resultStoreClosePtr.asFunction<void Function(ffi.Pointer<ffi.Char>)>();
+
+  // ========================
+  // Memory API
+  // ========================
+
+  /// Back large engine input tensors with transparent huge pages
+  void setOcrHugePages(int enable) {
+    return _setOcrHugePages(enable);
+  }
+
+  late final _setOcrHugePagesPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Int)>>('setOcrHugePages');
+  late final _setOcrHugePages =
+      _setOcrHugePagesPtr.asFunction<void Function(int)>();
+
+  /// Process RSS and engine buffer usage as JSON
+  ffi.Pointer<ffi.Char> getOcrMemoryStats() {
+    return _getOcrMemoryStats();
+  }
+
+  late final _getOcrMemoryStatsPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+          'getOcrMemoryStats');
+  late final _getOcrMemoryStats =
+      _getOcrMemoryStatsPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  // ========================
+  // Log API
+  // ========================
+
+  /// Set runtime log level and platform echo (JSON)
+  ffi.Pointer<ffi.Char> setOcrLogConfig(ffi.Pointer<ffi.Char> configJson) {
+    return _setOcrLogConfig(configJson);
+  }
+
+  late final _setOcrLogConfigPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>)>>('setOcrLogConfig');
+  late final _setOcrLogConfig = _setOcrLogConfigPtr
+      .asFunction<ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Most recent in-memory log entries as JSON
+  ffi.Pointer<ffi.Char> dumpOcrLog(int maxEntries) {
+    return _dumpOcrLog(maxEntries);
+  }
+
+  late final _dumpOcrLogPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function(ffi.Int)>>(
+          'dumpOcrLog');
+  late final _dumpOcrLog =
+      _dumpOcrLogPtr.asFunction<ffi.Pointer<ffi.Char> Function(int)>();
+
+  /// Hide logged entries from later dumps
+  void clearOcrLog() {
+    return _clearOcrLog();
+  }
+
+  late final _clearOcrLogPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function()>>('clearOcrLog');
+  late final _clearOcrLog = _clearOcrLogPtr.asFunction<void Function()>();
+
+  // ========================
+  // Thread Configuration API
+  // ========================
+
+  /// Configure det/rec session threads and CPU pinning (JSON)
+  ffi.Pointer<ffi.Char> setOcrThreadConfig(ffi.Pointer<ffi.Char> configJson) {
+    return _setOcrThreadConfig(configJson);
+  }
+
+  late final _setOcrThreadConfigPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>)>>('setOcrThreadConfig');
+  late final _setOcrThreadConfig = _setOcrThreadConfigPtr
+      .asFunction<ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Performance / efficiency core ids detected from sysfs
+  ffi.Pointer<ffi.Char> getCpuTopology() {
+    return _getCpuTopology();
+  }
+
+  late final _getCpuTopologyPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+          'getCpuTopology');
+  late final _getCpuTopology =
+      _getCpuTopologyPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  /// Per-stage latency statistics over repeated runs on one image
+  ffi.Pointer<ffi.Char> benchmarkOcr(ffi.Pointer<ffi.Char> imgPath,
+      int iterations, double detThreshold, double recThreshold) {
+    return _benchmarkOcr(imgPath, iterations, detThreshold, recThreshold);
+  }
+
+  late final _benchmarkOcrPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>, ffi.Int,
+              ffi.Float, ffi.Float)>>('benchmarkOcr');
+  late final _benchmarkOcr = _benchmarkOcrPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, int, double, double)>();
+
+  // ========================
+  // OCR Options API
+  // ========================
+
+  /// Full OCR with per-request options JSON (thresholds, detector backend)
+  ffi.Pointer<ffi.Char> recognizeTextFromPathWithOptions(
+      ffi.Pointer<ffi.Char> imgPath, ffi.Pointer<ffi.Char> optionsJson) {
+    return _recognizeTextFromPathWithOptions(imgPath, optionsJson);
+  }
+
+  late final _recognizeTextFromPathWithOptionsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>)>>('recognizeTextFromPathWithOptions');
+  late final _recognizeTextFromPathWithOptions =
+      _recognizeTextFromPathWithOptionsPtr.asFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  /// Detection only with per-request options JSON
+  ffi.Pointer<ffi.Char> detectTextFromPathWithOptions(
+      ffi.Pointer<ffi.Char> imgPath, ffi.Pointer<ffi.Char> optionsJson) {
+    return _detectTextFromPathWithOptions(imgPath, optionsJson);
+  }
+
+  late final _detectTextFromPathWithOptionsPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>)>>('detectTextFromPathWithOptions');
+  late final _detectTextFromPathWithOptions =
+      _detectTextFromPathWithOptionsPtr.asFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  // ========================
+  // Template API
+  // ========================
+
+  /// Register a known form from a reference image and field regions (JSON)
+  ffi.Pointer<ffi.Char> registerTemplate(ffi.Pointer<ffi.Char> templateId,
+      ffi.Pointer<ffi.Char> referencePath, ffi.Pointer<ffi.Char> fieldsJson) {
+    return _registerTemplate(templateId, referencePath, fieldsJson);
+  }
+
+  late final _registerTemplatePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>>('registerTemplate');
+  late final _registerTemplate = _registerTemplatePtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  /// Remove a template; 1 if it was registered
+  int unregisterTemplate(ffi.Pointer<ffi.Char> templateId) {
+    return _unregisterTemplate(templateId);
+  }
+
+  late final _unregisterTemplatePtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.Pointer<ffi.Char>)>>(
+          'unregisterTemplate');
+  late final _unregisterTemplate = _unregisterTemplatePtr
+      .asFunction<int Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Registered templates as JSON
+  ffi.Pointer<ffi.Char> listTemplates() {
+    return _listTemplates();
+  }
+
+  late final _listTemplatesPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+          'listTemplates');
+  late final _listTemplates =
+      _listTemplatesPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  /// Template fields for known forms, full OCR otherwise
+  ffi.Pointer<ffi.Char> recognizeWithTemplates(
+      ffi.Pointer<ffi.Char> imgPath, ffi.Pointer<ffi.Char> optionsJson) {
+    return _recognizeWithTemplates(imgPath, optionsJson);
+  }
+
+  late final _recognizeWithTemplatesPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>>('recognizeWithTemplates');
+  late final _recognizeWithTemplates = _recognizeWithTemplatesPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  // ========================
+  // Page cache API
+  // ========================
+
+  /// Detect a page once and keep it for re-runs; returns OCR JSON with the handle
+  ffi.Pointer<ffi.Char> openOcrPage(
+      ffi.Pointer<ffi.Char> imgPath, ffi.Pointer<ffi.Char> optionsJson) {
+    return _openOcrPage(imgPath, optionsJson);
+  }
+
+  late final _openOcrPagePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>>('openOcrPage');
+  late final _openOcrPage = _openOcrPagePtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  /// Re-run an open page at new thresholds
+  ffi.Pointer<ffi.Char> recognizeOcrPage(int page, ffi.Pointer<ffi.Char> optionsJson) {
+    return _recognizeOcrPage(page, optionsJson);
+  }
+
+  late final _recognizeOcrPagePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Int, ffi.Pointer<ffi.Char>)>>('recognizeOcrPage');
+  late final _recognizeOcrPage = _recognizeOcrPagePtr
+      .asFunction<ffi.Pointer<ffi.Char> Function(int, ffi.Pointer<ffi.Char>)>();
+
+  /// Drop an open page; 1 if it was open
+  int closeOcrPage(int page) {
+    return _closeOcrPage(page);
+  }
+
+  late final _closeOcrPagePtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.Int)>>('closeOcrPage');
+  late final _closeOcrPage = _closeOcrPagePtr.asFunction<int Function(int)>();
+
+  /// Drop every open page
+  void closeAllOcrPages() {
+    return _closeAllOcrPages();
+  }
+
+  late final _closeAllOcrPagesPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function()>>('closeAllOcrPages');
+  late final _closeAllOcrPages = _closeAllOcrPagesPtr.asFunction<void Function()>();
+
+  /// Memory allowed for open pages in MB (0 = unlimited)
+  void setPageCacheBudget(int budgetMb) {
+    return _setPageCacheBudget(budgetMb);
+  }
+
+  late final _setPageCacheBudgetPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Int)>>('setPageCacheBudget');
+  late final _setPageCacheBudget = _setPageCacheBudgetPtr.asFunction<void Function(int)>();
+
+  /// Page cache occupancy and reuse counters as JSON
+  ffi.Pointer<ffi.Char> getPageCacheStats() {
+    return _getPageCacheStats();
+  }
+
+  late final _getPageCacheStatsPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+          'getPageCacheStats');
+  late final _getPageCacheStats =
+      _getPageCacheStatsPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  // ========================
+  // Rec cascade API
+  // ========================
+
+  /// Load an accurate rec model that re-reads low-confidence lines
+  ffi.Pointer<ffi.Char> enableRecCascade(
+      ffi.Pointer<ffi.Char> recModelPath, ffi.Pointer<ffi.Char> optionsJson) {
+    return _enableRecCascade(recModelPath, optionsJson);
+  }
+
+  late final _enableRecCascadePtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>>('enableRecCascade');
+  late final _enableRecCascade = _enableRecCascadePtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  /// Unload the cascade model
+  void disableRecCascade() {
+    return _disableRecCascade();
+  }
+
+  late final _disableRecCascadePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function()>>('disableRecCascade');
+  late final _disableRecCascade =
+      _disableRecCascadePtr.asFunction<void Function()>();
+
+  /// Escalation counters as JSON
+  ffi.Pointer<ffi.Char> getRecCascadeStats() {
+    return _getRecCascadeStats();
+  }
+
+  late final _getRecCascadeStatsPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+          'getRecCascadeStats');
+  late final _getRecCascadeStats =
+      _getRecCascadeStatsPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  /// Restart escalation counters
+  void resetRecCascadeStats() {
+    return _resetRecCascadeStats();
+  }
+
+  late final _resetRecCascadeStatsPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function()>>('resetRecCascadeStats');
+  late final _resetRecCascadeStats =
+      _resetRecCascadeStatsPtr.asFunction<void Function()>();
+
+  // ========================
+  // Scheduler API
+  // ========================
+
+  /// Per-priority queue depth and wait times as JSON
+  ffi.Pointer<ffi.Char> getOcrSchedulerStats() {
+    return _getOcrSchedulerStats();
+  }
+
+  late final _getOcrSchedulerStatsPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+          'getOcrSchedulerStats');
+  late final _getOcrSchedulerStats =
+      _getOcrSchedulerStatsPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  /// Restart scheduler counters
+  void resetOcrSchedulerStats() {
+    return _resetOcrSchedulerStats();
+  }
+
+  late final _resetOcrSchedulerStatsPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function()>>('resetOcrSchedulerStats');
+  late final _resetOcrSchedulerStats =
+      _resetOcrSchedulerStatsPtr.asFunction<void Function()>();
+
+  // ========================
+  // PDF API
+  // ========================
+
+  /// Recognize a PDF (text layer where usable, OCR otherwise)
+  ffi.Pointer<ffi.Char> recognizeTextFromPdf(ffi.Pointer<ffi.Char> pdfPath,
+      ffi.Pointer<ffi.Char> password, ffi.Pointer<ffi.Char> optionsJson) {
+    return _recognizeTextFromPdf(pdfPath, password, optionsJson);
+  }
+
+  late final _recognizeTextFromPdfPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>>('recognizeTextFromPdf');
+  late final _recognizeTextFromPdf = _recognizeTextFromPdfPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  /// Recognize a PDF page by page into a result store
+  ffi.Pointer<ffi.Char> resultStoreRecognizePdf(
+      ffi.Pointer<ffi.Char> storePath,
+      ffi.Pointer<ffi.Char> pdfPath,
+      ffi.Pointer<ffi.Char> password,
+      ffi.Pointer<ffi.Char> optionsJson) {
+    return _resultStoreRecognizePdf(storePath, pdfPath, password, optionsJson);
+  }
+
+  late final _resultStoreRecognizePdfPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>)>>('resultStoreRecognizePdf');
+  late final _resultStoreRecognizePdf = _resultStoreRecognizePdfPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  // ========================
+  // Model Registry API
+  // ========================
+
+  /// Register an OCR model set (det + rec + dictionary) under an id
+  void registerOcrModel(ffi.Pointer<ffi.Char> modelId, ffi.Pointer<ffi.Char> detModelPath,
+      ffi.Pointer<ffi.Char> recModelPath, ffi.Pointer<ffi.Char> dictPath) {
+    return _registerOcrModel(modelId, detModelPath, recModelPath, dictPath);
+  }
+
+  late final _registerOcrModelPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>>('registerOcrModel');
+  late final _registerOcrModel = _registerOcrModelPtr.asFunction<
+      void Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>,
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  /// Register a layout model under an id
+  void registerLayoutModel(ffi.Pointer<ffi.Char> modelId, ffi.Pointer<ffi.Char> modelPath) {
+    return _registerLayoutModel(modelId, modelPath);
+  }
+
+  late final _registerLayoutModelPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Void Function(
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>>('registerLayoutModel');
+  late final _registerLayoutModel = _registerLayoutModelPtr
+      .asFunction<void Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  /// Remove a registered model; returns 1 if it existed
+  int unregisterModel(ffi.Pointer<ffi.Char> modelId) {
+    return _unregisterModel(modelId);
+  }
+
+  late final _unregisterModelPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.Pointer<ffi.Char>)>>('unregisterModel');
+  late final _unregisterModel =
+      _unregisterModelPtr.asFunction<int Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Resident memory budget for registry models in MB (0 = unlimited)
+  void setModelMemoryBudget(int budgetMb) {
+    return _setModelMemoryBudget(budgetMb);
+  }
+
+  late final _setModelMemoryBudgetPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Int)>>('setModelMemoryBudget');
+  late final _setModelMemoryBudget =
+      _setModelMemoryBudgetPtr.asFunction<void Function(int)>();
+
+  /// Unload every idle registry model
+  void unloadModels() {
+    return _unloadModels();
+  }
+
+  late final _unloadModelsPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function()>>('unloadModels');
+  late final _unloadModels = _unloadModelsPtr.asFunction<void Function()>();
+
+  /// Registry budget and per-model load state as JSON
+  ffi.Pointer<ffi.Char> getModelRegistryStatus() {
+    return _getModelRegistryStatus();
+  }
+
+  late final _getModelRegistryStatusPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+          'getModelRegistryStatus');
+  late final _getModelRegistryStatus =
+      _getModelRegistryStatusPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  /// Layout detection with a registered layout model
+  ffi.Pointer<ffi.Char> detectLayoutWithModel(
+      ffi.Pointer<ffi.Char> modelId, ffi.Pointer<ffi.Char> imgPath, double confThreshold) {
+    return _detectLayoutWithModel(modelId, imgPath, confThreshold);
+  }
+
+  late final _detectLayoutWithModelPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>, ffi.Float)>>('detectLayoutWithModel');
+  late final _detectLayoutWithModel = _detectLayoutWithModelPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>, double)>();
+
+  // ========================
+  // Field query API
+  // ========================
+
+  /// Recognize only what it takes to resolve the fields in queryJson
+  ffi.Pointer<ffi.Char> queryFieldsFromPath(
+      ffi.Pointer<ffi.Char> imgPath, ffi.Pointer<ffi.Char> queryJson) {
+    return _queryFieldsFromPath(imgPath, queryJson);
+  }
+
+  late final _queryFieldsFromPathPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>>('queryFieldsFromPath');
+  late final _queryFieldsFromPath = _queryFieldsFromPathPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
+  // ========================
+  // Golden corpus API
+  // ========================
+
+  /// Replay a golden corpus manifest; options as JSON (iterations, tolerances)
+  ffi.Pointer<ffi.Char> runGoldenCorpus(
+      ffi.Pointer<ffi.Char> manifestPath, ffi.Pointer<ffi.Char> optionsJson) {
+    return _runGoldenCorpus(manifestPath, optionsJson);
+  }
+
+  late final _runGoldenCorpusPtr = _lookup<
+      ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>>('runGoldenCorpus');
+  late final _runGoldenCorpus = _runGoldenCorpusPtr.asFunction<
+      ffi.Pointer<ffi.Char> Function(
+          ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)>();
+
   // ========================
   // Apple Vision OCR API
   // ========================
@@ -57,6 +57,198 @@ class DetectionBox {
 // OCR Models
 // ========================
 
+/// Text detection backend
+enum TextDetector {
+  /// PP-OCR DB model (photos, camera frames, anything)
+  neural,
+
+  /// Adaptive threshold + morphology + connected components; a few ms on
+  /// screenshots, rendered PDFs and clean digital documents
+  classic,
+
+  /// Classic for clean, high-contrast images, neural otherwise
+  auto,
+}
+
+/// Scheduling class of an OCR request
+enum RequestPriority {
+  /// User is waiting on the result
+  interactive,
+
+  /// Library / batch work; runs only when no interactive stage is queued
+  background,
+}
+
+/// Native log level, most to least severe
+enum OcrLogLevel {
+  error,
+  warn,
+  info,
+  debug,
+}
+
+/// One message from the native log ring
+class OcrLogEntry {
+  final int seq;            // Write order, process-wide
+  final DateTime time;
+  final OcrLogLevel level;
+  final int thread;         // Hash of the native thread id
+  final String text;
+
+  OcrLogEntry({
+    required this.seq,
+    required this.time,
+    required this.level,
+    required this.thread,
+    required this.text,
+  });
+
+  factory OcrLogEntry.fromJson(Map<String, dynamic> json) {
+    return OcrLogEntry(
+      seq: json['seq'] as int,
+      time: DateTime.fromMicrosecondsSinceEpoch(json['time_us'] as int),
+      level: OcrLogLevel.values.byName(json['level'] as String),
+      thread: json['thread'] as int,
+      text: json['text'] as String,
+    );
+  }
+
+  @override
+  String toString() => '[${level.name}] $text';
+}
+
+/// Scheduler counters for one priority class
+class PriorityClassStats {
+  final int inFlight;        // Requests currently running
+  final int queueDepth;      // Stages waiting for the engine right now
+  final int peakQueueDepth;
+  final int requests;
+  final int stages;
+  final double meanWaitMs;   // Per stage
+  final double maxWaitMs;
+
+  PriorityClassStats({
+    required this.inFlight,
+    required this.queueDepth,
+    required this.peakQueueDepth,
+    required this.requests,
+    required this.stages,
+    required this.meanWaitMs,
+    required this.maxWaitMs,
+  });
+
+  factory PriorityClassStats.fromJson(Map<String, dynamic> json) {
+    return PriorityClassStats(
+      inFlight: json['in_flight'] as int,
+      queueDepth: json['queue_depth'] as int,
+      peakQueueDepth: json['peak_queue_depth'] as int,
+      requests: json['requests'] as int,
+      stages: json['stages'] as int,
+      meanWaitMs: (json['mean_wait_ms'] as num).toDouble(),
+      maxWaitMs: (json['max_wait_ms'] as num).toDouble(),
+    );
+  }
+
+  @override
+  String toString() {
+    return 'PriorityClassStats(inFlight: $inFlight, queue: $queueDepth, '
+        'meanWait: ${meanWaitMs.toStringAsFixed(1)}ms, maxWait: ${maxWaitMs.toStringAsFixed(1)}ms)';
+  }
+}
+
+/// Request scheduler statistics
+class SchedulerStats {
+  final PriorityClassStats interactive;
+  final PriorityClassStats background;
+  final TaskSchedulerStats tasks;
+
+  SchedulerStats({required this.interactive, required this.background, required this.tasks});
+
+  factory SchedulerStats.fromJson(Map<String, dynamic> json) {
+    return SchedulerStats(
+      interactive: PriorityClassStats.fromJson(json['interactive'] as Map<String, dynamic>),
+      background: PriorityClassStats.fromJson(json['background'] as Map<String, dynamic>),
+      tasks: TaskSchedulerStats.fromJson(json['tasks'] as Map<String, dynamic>),
+    );
+  }
+
+  @override
+  String toString() =>
+      'SchedulerStats(interactive: $interactive, background: $background, tasks: $tasks)';
+}
+
+/// Load state of one registered model
+class ModelStatus {
+  final String id;
+  final String kind;           // 'ocr' or 'layout'
+  final bool loaded;
+  final bool inUse;            // Serving a request, so not evictable
+  final int residentBytes;     // Measured at the last load
+  final int loads;
+  final int hits;              // Requests served without loading
+  final int evictions;
+
+  ModelStatus({
+    required this.id,
+    required this.kind,
+    required this.loaded,
+    required this.inUse,
+    required this.residentBytes,
+    required this.loads,
+    required this.hits,
+    required this.evictions,
+  });
+
+  factory ModelStatus.fromJson(Map<String, dynamic> json) {
+    return ModelStatus(
+      id: json['id'] as String,
+      kind: json['kind'] as String,
+      loaded: json['loaded'] as bool,
+      inUse: json['in_use'] as bool,
+      residentBytes: json['resident_bytes'] as int,
+      loads: json['loads'] as int,
+      hits: json['hits'] as int,
+      evictions: json['evictions'] as int,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'ModelStatus($id, $kind, loaded: $loaded, '
+        'resident: ${(residentBytes / (1024 * 1024)).toStringAsFixed(1)}MB)';
+  }
+}
+
+/// Model registry state
+class ModelRegistryStatus {
+  final int budgetBytes;       // 0 = unlimited
+  final int residentBytes;
+  final List<ModelStatus> models;
+
+  ModelRegistryStatus({
+    required this.budgetBytes,
+    required this.residentBytes,
+    required this.models,
+  });
+
+  factory ModelRegistryStatus.fromJson(Map<String, dynamic> json) {
+    return ModelRegistryStatus(
+      budgetBytes: json['budget_bytes'] as int,
+      residentBytes: json['resident_bytes'] as int,
+      models: (json['models'] as List<dynamic>)
+          .map((m) => ModelStatus.fromJson(m as Map<String, dynamic>))
+          .toList(),
+    );
+  }
+
+  @override
+  String toString() => 'ModelRegistryStatus(resident: $residentBytes / $budgetBytes, models: $models)';
+}
+
+TextDetector _detectorFromJson(dynamic name) {
+  return name == 'classic' ? TextDetector.classic : TextDetector.neural;
+}
+
 /// Single text line result from OCR
 class TextLine {
   final double x1;
@@ -122,6 +314,7 @@ class OcrResult {
   final int inferenceTimeMs;
   final int imageWidth;
   final int imageHeight;
+  final TextDetector detector;  // Backend that found the boxes (resolved for auto)
   final String? error;
 
   OcrResult({
@@ -131,6 +324,7 @@ class OcrResult {
     required this.inferenceTimeMs,
     required this.imageWidth,
     required this.imageHeight,
+    this.detector = TextDetector.neural,
     this.error,
   });
 
@@ -197,6 +391,7 @@ class OcrResult {
       inferenceTimeMs: json['inference_time_ms'] as int,
       imageWidth: json['image_width'] as int,
       imageHeight: json['image_height'] as int,
+      detector: _detectorFromJson(json['detector']),
     );
   }
 
@@ -223,14 +418,688 @@ class OcrResult {
   }
 }
 
+/// Text shown in a video between two timestamps
+class VideoTextSegment {
+  final double startMs;
+  final double endMs;
+  final String text;
+  final List<TextLine> lines;
+
+  VideoTextSegment({
+    required this.startMs,
+    required this.endMs,
+    required this.text,
+    required this.lines,
+  });
+
+  Duration get start => Duration(microseconds: (startMs * 1000).round());
+  Duration get end => Duration(microseconds: (endMs * 1000).round());
+
+  factory VideoTextSegment.fromJson(Map<String, dynamic> json) {
+    final linesJson = json['results'] as List<dynamic>;
+    return VideoTextSegment(
+      startMs: (json['start_ms'] as num).toDouble(),
+      endMs: (json['end_ms'] as num).toDouble(),
+      text: json['text'] as String,
+      lines: linesJson
+          .map((l) => TextLine.fromJson(l as Map<String, dynamic>))
+          .toList(),
+    );
+  }
+
+  @override
+  String toString() {
+    return 'VideoTextSegment(${startMs.toStringAsFixed(0)}-${endMs.toStringAsFixed(0)}ms: "$text")';
+  }
+}
+
+/// Video OCR result
+class VideoOcrResult {
+  final List<VideoTextSegment> segments;
+  final int count;
+  final int framesTotal;
+  final int framesSampled;
+  final int keyframes;
+  final int ocrRuns;
+  final double durationMs;
+  final int inferenceTimeMs;
+  final int videoWidth;
+  final int videoHeight;
+  final String? error;
+
+  VideoOcrResult({
+    required this.segments,
+    required this.count,
+    required this.framesTotal,
+    required this.framesSampled,
+    required this.keyframes,
+    required this.ocrRuns,
+    required this.durationMs,
+    required this.inferenceTimeMs,
+    required this.videoWidth,
+    required this.videoHeight,
+    this.error,
+  });
+
+  bool get hasError => error != null;
+  bool get isSuccess => error == null;
+
+  /// Get all segment text, one segment per line
+  String get fullText => segments.map((s) => s.text).join('\n');
+
+  factory VideoOcrResult.fromJson(Map<String, dynamic> json) {
+    if (json.containsKey('error')) {
+      return VideoOcrResult(
+        segments: [],
+        count: 0,
+        framesTotal: 0,
+        framesSampled: 0,
+        keyframes: 0,
+        ocrRuns: 0,
+        durationMs: 0,
+        inferenceTimeMs: 0,
+        videoWidth: 0,
+        videoHeight: 0,
+        error: json['error'] as String,
+      );
+    }
+
+    final segmentsJson = json['segments'] as List<dynamic>;
+    return VideoOcrResult(
+      segments: segmentsJson
+          .map((s) => VideoTextSegment.fromJson(s as Map<String, dynamic>))
+          .toList(),
+      count: json['count'] as int,
+      framesTotal: json['frames_total'] as int,
+      framesSampled: json['frames_sampled'] as int,
+      keyframes: json['keyframes'] as int,
+      ocrRuns: json['ocr_runs'] as int,
+      durationMs: (json['duration_ms'] as num).toDouble(),
+      inferenceTimeMs: json['inference_time_ms'] as int,
+      videoWidth: json['video_width'] as int,
+      videoHeight: json['video_height'] as int,
+    );
+  }
+
+  @override
+  String toString() {
+    if (hasError) {
+      return 'VideoOcrResult(error: $error)';
+    }
+    return 'VideoOcrResult(segments: $count, keyframes: $keyframes/$framesSampled, time: ${inferenceTimeMs}ms)';
+  }
+}
+
+/// One search index hit
+class SearchHit {
+  final int docId;
+  final int page;
+  final int boxId;
+  final double x1;
+  final double y1;
+  final double x2;
+  final double y2;
+  final double score;
+  final double rank;
+  final String text;
+
+  SearchHit({
+    required this.docId,
+    required this.page,
+    required this.boxId,
+    required this.x1,
+    required this.y1,
+    required this.x2,
+    required this.y2,
+    required this.score,
+    required this.rank,
+    required this.text,
+  });
+
+  Rect get rect => Rect.fromLTRB(x1, y1, x2, y2);
+
+  factory SearchHit.fromJson(Map<String, dynamic> json) {
+    return SearchHit(
+      docId: json['doc_id'] as int,
+      page: json['page'] as int,
+      boxId: json['box_id'] as int,
+      x1: (json['x1'] as num).toDouble(),
+      y1: (json['y1'] as num).toDouble(),
+      x2: (json['x2'] as num).toDouble(),
+      y2: (json['y2'] as num).toDouble(),
+      score: (json['score'] as num).toDouble(),
+      rank: (json['rank'] as num).toDouble(),
+      text: json['text'] as String,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'SearchHit(doc $docId p$page #$boxId: "$text", rank=${rank.toStringAsFixed(3)})';
+  }
+}
+
+/// Search index query result
+class SearchResult {
+  final List<SearchHit> hits;
+  final int count;
+  final int searchTimeUs;
+
+  SearchResult({
+    required this.hits,
+    required this.count,
+    required this.searchTimeUs,
+  });
+
+  factory SearchResult.fromJson(Map<String, dynamic> json) {
+    final hitsJson = json['hits'] as List<dynamic>;
+    return SearchResult(
+      hits: hitsJson
+          .map((h) => SearchHit.fromJson(h as Map<String, dynamic>))
+          .toList(),
+      count: json['count'] as int,
+      searchTimeUs: json['search_time_us'] as int? ?? 0,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'SearchResult(count: $count, time: ${searchTimeUs}us)';
+  }
+}
+
+/// Approximate match of a pattern within one OCR line
+class FuzzyMatch {
+  final int? docId; // Set for index matches
+  final int? page;
+  final int boxId;
+  final double x1;
+  final double y1;
+  final double x2;
+  final double y2;
+  final double score;
+  final String text;
+  final String match; // Matched part of [text]
+  final int start; // Character range of [match] within [text]
+  final int end;
+  final int cost; // Number of edits
+
+  FuzzyMatch({
+    this.docId,
+    this.page,
+    required this.boxId,
+    required this.x1,
+    required this.y1,
+    required this.x2,
+    required this.y2,
+    required this.score,
+    required this.text,
+    required this.match,
+    required this.start,
+    required this.end,
+    required this.cost,
+  });
+
+  Rect get rect => Rect.fromLTRB(x1, y1, x2, y2);
+
+  factory FuzzyMatch.fromJson(Map<String, dynamic> json) {
+    return FuzzyMatch(
+      docId: json['doc_id'] as int?,
+      page: json['page'] as int?,
+      boxId: json['box_id'] as int,
+      x1: (json['x1'] as num).toDouble(),
+      y1: (json['y1'] as num).toDouble(),
+      x2: (json['x2'] as num).toDouble(),
+      y2: (json['y2'] as num).toDouble(),
+      score: (json['score'] as num).toDouble(),
+      text: json['text'] as String,
+      match: json['match'] as String,
+      start: json['start'] as int,
+      end: json['end'] as int,
+      cost: json['cost'] as int,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'FuzzyMatch(#$boxId: "$match" in "$text", cost=$cost)';
+  }
+}
+
+/// Fuzzy match result, best (lowest cost) matches first
+class FuzzyMatchResult {
+  final List<FuzzyMatch> matches;
+  final int count;
+  final int searchTimeUs;
+
+  FuzzyMatchResult({
+    required this.matches,
+    required this.count,
+    required this.searchTimeUs,
+  });
+
+  factory FuzzyMatchResult.fromJson(Map<String, dynamic> json) {
+    final matchesJson = json['matches'] as List<dynamic>;
+    return FuzzyMatchResult(
+      matches: matchesJson
+          .map((m) => FuzzyMatch.fromJson(m as Map<String, dynamic>))
+          .toList(),
+      count: json['count'] as int,
+      searchTimeUs: json['search_time_us'] as int? ?? 0,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'FuzzyMatchResult(count: $count, time: ${searchTimeUs}us)';
+  }
+}
+
+/// One page read back from a result store
+class StoredPage {
+  final int page;
+  final String source; // Image path or caller-supplied name
+  final int imageWidth;
+  final int imageHeight;
+  final List<TextLine> results;
+
+  StoredPage({
+    required this.page,
+    required this.source,
+    required this.imageWidth,
+    required this.imageHeight,
+    required this.results,
+  });
+
+  String get fullText => results.map((r) => r.text).join('\n');
+
+  factory StoredPage.fromJson(Map<String, dynamic> json) {
+    final resultsJson = json['results'] as List<dynamic>;
+    return StoredPage(
+      page: json['page'] as int,
+      source: json['source'] as String,
+      imageWidth: json['image_width'] as int,
+      imageHeight: json['image_height'] as int,
+      results: resultsJson
+          .map((r) => TextLine.fromJson(r as Map<String, dynamic>))
+          .toList(),
+    );
+  }
+
+  @override
+  String toString() {
+    return 'StoredPage(#$page $source, lines: ${results.length})';
+  }
+}
+
+/// Outcome of recognizing a batch of images into a result store
+class ResultStoreBatch {
+  final int added;
+  final int firstPage; // -1 if nothing was added
+  final bool flushed;
+  final List<String> failed; // Paths that could not be loaded
+  final int inferenceTimeMs;
+
+  ResultStoreBatch({
+    required this.added,
+    required this.firstPage,
+    required this.flushed,
+    required this.failed,
+    required this.inferenceTimeMs,
+  });
+
+  factory ResultStoreBatch.fromJson(Map<String, dynamic> json) {
+    return ResultStoreBatch(
+      added: json['added'] as int,
+      firstPage: json['first_page'] as int,
+      flushed: json['flushed'] as bool,
+      failed: (json['failed'] as List<dynamic>).cast<String>(),
+      inferenceTimeMs: json['inference_time_ms'] as int,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'ResultStoreBatch(added: $added, failed: ${failed.length}, time: ${inferenceTimeMs}ms)';
+  }
+}
+
+/// One page of a PDF result
+///
+/// Boxes are in PDF points (1/72 inch), origin top-left, for both sources.
+class PdfPage {
+  final int page; // 0-based
+  final double width;
+  final double height;
+  final bool fromTextLayer; // false: rasterized and OCR'd
+  final double dpi; // Render resolution of OCR'd pages
+  final double timeMs;
+  final List<TextLine> results;
+
+  PdfPage({
+    required this.page,
+    required this.width,
+    required this.height,
+    required this.fromTextLayer,
+    required this.dpi,
+    required this.timeMs,
+    required this.results,
+  });
+
+  String get fullText => results.map((r) => r.text).join('\n');
+
+  factory PdfPage.fromJson(Map<String, dynamic> json) {
+    return PdfPage(
+      page: json['page'] as int,
+      width: (json['width'] as num).toDouble(),
+      height: (json['height'] as num).toDouble(),
+      fromTextLayer: json['source'] == 'text',
+      dpi: (json['dpi'] as num).toDouble(),
+      timeMs: (json['time_ms'] as num).toDouble(),
+      results: (json['results'] as List<dynamic>)
+          .map((r) => TextLine.fromJson(r as Map<String, dynamic>))
+          .toList(),
+    );
+  }
+
+  @override
+  String toString() {
+    return 'PdfPage(page: $page, ${fromTextLayer ? 'text layer' : 'ocr'}, '
+        'lines: ${results.length}, time: ${timeMs.toStringAsFixed(1)}ms)';
+  }
+}
+
+/// PDF recognition result
+class PdfOcrResult {
+  final List<PdfPage> pages;
+  final int documentPages;
+  final int pagesTextLayer;
+  final int pagesOcr;
+  final int inferenceTimeMs;
+
+  PdfOcrResult({
+    required this.pages,
+    required this.documentPages,
+    required this.pagesTextLayer,
+    required this.pagesOcr,
+    required this.inferenceTimeMs,
+  });
+
+  factory PdfOcrResult.fromJson(Map<String, dynamic> json) {
+    return PdfOcrResult(
+      pages: (json['pages'] as List<dynamic>)
+          .map((p) => PdfPage.fromJson(p as Map<String, dynamic>))
+          .toList(),
+      documentPages: json['document_pages'] as int,
+      pagesTextLayer: json['pages_text_layer'] as int,
+      pagesOcr: json['pages_ocr'] as int,
+      inferenceTimeMs: json['inference_time_ms'] as int,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'PdfOcrResult(pages: ${pages.length}/$documentPages, text layer: $pagesTextLayer, '
+        'ocr: $pagesOcr, time: ${inferenceTimeMs}ms)';
+  }
+}
+
+/// Threading of one inference session (det or rec)
+class OcrThreadConfig {
+  final int intraThreads;
+  final int interThreads;
+
+  /// 'performance', 'efficiency', 'all', a list of CPU ids, or null for no pinning
+  final Object? cpus;
+
+  const OcrThreadConfig({
+    this.intraThreads = 4,
+    this.interThreads = 2,
+    this.cpus,
+  });
+
+  Map<String, dynamic> toJson() => {
+    'intra_threads': intraThreads,
+    'inter_threads': interThreads,
+    'cpus': cpus,
+  };
+}
+
+/// Worker pool for the CPU stages around inference (contour scoring,
+/// cropping, decoding)
+class OcrTaskConfig {
+  final int threads;  // 0 = automatic
+
+  /// 'performance', 'efficiency', 'all', a list of CPU ids, or null for no pinning
+  final Object? cpus;
+
+  const OcrTaskConfig({
+    this.threads = 0,
+    this.cpus,
+  });
+
+  Map<String, dynamic> toJson() => {
+    'threads': threads,
+    'cpus': cpus,
+  };
+}
+
+/// Rec cascade counters since it was enabled or last reset
+class RecCascadeStats {
+  final bool enabled;
+  final int lines;            // Lines read by the fast model
+  final int escalated;        // Of those, re-read by the accurate model
+  final int changed;          // Escalated lines whose text changed
+  final double escalationRate;
+  final double escalationMs;  // Total time in the accurate model
+
+  RecCascadeStats({
+    required this.enabled,
+    required this.lines,
+    required this.escalated,
+    required this.changed,
+    required this.escalationRate,
+    required this.escalationMs,
+  });
+
+  factory RecCascadeStats.fromJson(Map<String, dynamic> json) {
+    return RecCascadeStats(
+      enabled: json['enabled'] as bool,
+      lines: json['lines'] as int,
+      escalated: json['escalated'] as int,
+      changed: json['changed'] as int,
+      escalationRate: (json['escalation_rate'] as num).toDouble(),
+      escalationMs: (json['escalation_ms'] as num).toDouble(),
+    );
+  }
+
+  @override
+  String toString() {
+    return 'RecCascadeStats(lines: $lines, escalated: $escalated, changed: $changed, '
+        'rate: ${(escalationRate * 100).toStringAsFixed(1)}%)';
+  }
+}
+
+/// Task scheduler counters
+class TaskSchedulerStats {
+  final int threads;
+  final bool running;
+  final int executed;  // Tasks run by workers
+  final int stolen;    // Of those, taken from another worker
+  final int helped;    // Tasks run by request threads while waiting
+
+  TaskSchedulerStats({
+    required this.threads,
+    required this.running,
+    required this.executed,
+    required this.stolen,
+    required this.helped,
+  });
+
+  factory TaskSchedulerStats.fromJson(Map<String, dynamic> json) {
+    return TaskSchedulerStats(
+      threads: json['threads'] as int,
+      running: json['running'] as bool,
+      executed: json['executed'] as int,
+      stolen: json['stolen'] as int,
+      helped: json['helped'] as int,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'TaskSchedulerStats(threads: $threads, executed: $executed, '
+        'stolen: $stolen, helped: $helped)';
+  }
+}
+
+/// Where a field's value sits relative to its anchor keyword
+enum FieldRelation {
+  /// Same row, to the right (or after the keyword in the same line)
+  right,
+
+  /// Under the keyword
+  below,
+
+  /// Either
+  any,
+}
+
+/// One field for [OcrKit.queryFields]; needs a [pattern], [anchors] or both
+class FieldQuerySpec {
+  final String name;
+
+  /// Value pattern (ECMAScript RegExp source) searched in the line text.
+  /// Without one, an anchored field takes the whole text next to its anchor.
+  final String? pattern;
+
+  /// Keywords the value is next to, e.g. ['總計', 'Total']
+  final List<String> anchors;
+  final FieldRelation relation;
+
+  /// Part of the page the value lies in: 'top_third', 'middle_third',
+  /// 'bottom_third', 'top_half', 'bottom_half', 'left_half', 'right_half',
+  /// or a [Rect] in fractions of the page size
+  final Object? region;
+
+  /// Recognition score the value needs; null = the query's minScore
+  final double? minScore;
+
+  const FieldQuerySpec({
+    required this.name,
+    this.pattern,
+    this.anchors = const [],
+    this.relation = FieldRelation.right,
+    this.region,
+    this.minScore,
+  });
+
+  Object? get _regionJson {
+    final area = region;
+    if (area is Rect) {
+      return [area.left, area.top, area.right, area.bottom];
+    }
+    return area;
+  }
+
+  Map<String, dynamic> toJson() => {
+    'name': name,
+    if (pattern != null) 'pattern': pattern,
+    if (anchors.isNotEmpty) 'anchors': anchors,
+    'relation': relation.name,
+    if (region != null) 'region': _regionJson,
+    if (minScore != null) 'min_score': minScore,
+  };
+}
+
+/// A resolved field
+class FieldValue {
+  final String text;  // The matched value
+  final String line;  // Whole recognized text of the box it came from
+  final double score;
+  final Rect rect;
+
+  FieldValue({
+    required this.text,
+    required this.line,
+    required this.score,
+    required this.rect,
+  });
+
+  factory FieldValue.fromJson(Map<String, dynamic> json) {
+    return FieldValue(
+      text: json['text'] as String,
+      line: json['line'] as String,
+      score: (json['score'] as num).toDouble(),
+      rect: Rect.fromLTRB(
+        (json['x1'] as num).toDouble(),
+        (json['y1'] as num).toDouble(),
+        (json['x2'] as num).toDouble(),
+        (json['y2'] as num).toDouble(),
+      ),
+    );
+  }
+
+  @override
+  String toString() => 'FieldValue("$text", score: ${score.toStringAsFixed(3)})';
+}
+
+/// Result of [OcrKit.queryFields]
+class FieldQueryResult {
+  /// Every requested field; null when it was not found
+  final Map<String, FieldValue?> fields;
+  final bool complete;        // Every field resolved
+  final int detectedBoxes;
+  final int recognizedBoxes;  // Boxes recognized before stopping
+  final int recRounds;        // Recognition batches run
+  final int inferenceTimeMs;
+
+  FieldQueryResult({
+    required this.fields,
+    required this.complete,
+    required this.detectedBoxes,
+    required this.recognizedBoxes,
+    required this.recRounds,
+    required this.inferenceTimeMs,
+  });
+
+  FieldValue? operator [](String name) => fields[name];
+
+  factory FieldQueryResult.fromJson(Map<String, dynamic> json) {
+    final fieldsJson = json['fields'] as Map<String, dynamic>;
+    return FieldQueryResult(
+      fields: fieldsJson.map((name, value) => MapEntry(
+            name,
+            value == null ? null : FieldValue.fromJson(value as Map<String, dynamic>),
+          )),
+      complete: json['complete'] as bool,
+      detectedBoxes: json['detected_boxes'] as int,
+      recognizedBoxes: json['recognized_boxes'] as int,
+      recRounds: json['rec_rounds'] as int,
+      inferenceTimeMs: json['inference_time_ms'] as int,
+    );
+  }
+
+  @override
+  String toString() {
+    return 'FieldQueryResult(complete: $complete, recognized $recognizedBoxes/$detectedBoxes boxes '
+        'in $recRounds rounds, ${inferenceTimeMs}ms)';
+  }
+}
+
 /// Text box from detection (4 corner points)
 class TextBox {
   final List<Offset> points;
   final double score;
 
+  /// Detected boxes this line was merged from (with `mergeFragments`);
+  /// empty when the box was detected as is
+  final List<TextBox> fragments;
+
   TextBox({
     required this.points,
     required this.score,
+    this.fragments = const [],
   });
 
   /// Get axis-aligned bounding rectangle
@@ -257,6 +1126,10 @@ class TextBox {
     return TextBox(
       points: points,
       score: (json['score'] as num).toDouble(),
+      fragments: (json['fragments'] as List<dynamic>?)
+              ?.map((f) => TextBox.fromJson(f as Map<String, dynamic>))
+              .toList() ??
+          const [],
     );
   }
 }
@@ -268,6 +1141,7 @@ class TextDetectionResult {
   final int inferenceTimeMs;
   final int imageWidth;
   final int imageHeight;
+  final TextDetector detector;
   final String? error;
 
   TextDetectionResult({
@@ -276,6 +1150,7 @@ class TextDetectionResult {
     required this.inferenceTimeMs,
     required this.imageWidth,
     required this.imageHeight,
+    this.detector = TextDetector.neural,
     this.error,
   });
 
@@ -305,6 +1180,7 @@ class TextDetectionResult {
       inferenceTimeMs: json['inference_time_ms'] as int,
       imageWidth: json['image_width'] as int,
       imageHeight: json['image_height'] as int,
+      detector: _detectorFromJson(json['detector']),
     );
   }
 
@@ -385,3 +1261,202 @@ class LayoutResult {
     return 'LayoutResult(count: $count, time: ${inferenceTimeMs}ms)';
   }
 }
+
+// ========================
+// Template Models
+// ========================
+
+/// A value's region on a registered form
+class TemplateField {
+  final String name;
+  final Rect roi;  // In reference image pixels
+
+  TemplateField({required this.name, required this.roi});
+
+  Map<String, dynamic> toJson() => {
+    'name': name,
+    'roi': [roi.left, roi.top, roi.right, roi.bottom],
+  };
+}
+
+/// A template field read from a matched page
+class TemplateFieldValue {
+  final String text;
+  final double score;
+  final List<Offset> points;  // Field region on the page, clockwise from top-left
+
+  TemplateFieldValue({required this.text, required this.score, required this.points});
+
+  factory TemplateFieldValue.fromJson(Map<String, dynamic> json) {
+    return TemplateFieldValue(
+      text: json['text'] as String,
+      score: (json['score'] as num).toDouble(),
+      points: (json['points'] as List<dynamic>).map((p) {
+        final pt = p as List<dynamic>;
+        return Offset((pt[0] as num).toDouble(), (pt[1] as num).toDouble());
+      }).toList(),
+    );
+  }
+
+  @override
+  String toString() => 'TemplateFieldValue($text, score: ${score.toStringAsFixed(3)})';
+}
+
+/// Result of [OcrKit.recognizeWithTemplates]
+class TemplateOcrResult {
+  final bool matched;
+  final String? templateId;
+
+  /// Fields of the matched template; null when a region read as empty
+  final Map<String, TemplateFieldValue?> fields;
+
+  /// Full-page OCR for pages that matched no template
+  final OcrResult? fallback;
+
+  final double edgeDistance;    // Signature distances to the nearest template
+  final double regionDistance;
+  final int inliers;            // Anchor matches behind the alignment
+  final int inferenceTimeMs;
+
+  TemplateOcrResult({
+    required this.matched,
+    this.templateId,
+    this.fields = const {},
+    this.fallback,
+    required this.edgeDistance,
+    required this.regionDistance,
+    required this.inliers,
+    required this.inferenceTimeMs,
+  });
+
+  TemplateFieldValue? operator [](String name) => fields[name];
+
+  factory TemplateOcrResult.fromJson(Map<String, dynamic> json) {
+    final matched = json['matched'] as bool;
+    final fieldsJson = json['fields'] as Map<String, dynamic>? ?? const {};
+    return TemplateOcrResult(
+      matched: matched,
+      templateId: json['template'] as String?,
+      fields: fieldsJson.map((name, value) => MapEntry(
+            name,
+            value == null ? null : TemplateFieldValue.fromJson(value as Map<String, dynamic>),
+          )),
+      fallback: matched ? null : OcrResult.fromJson(json),
+      edgeDistance: (json['edge_distance'] as num).toDouble(),
+      regionDistance: (json['region_distance'] as num).toDouble(),
+      inliers: json['inliers'] as int,
+      inferenceTimeMs: json['inference_time_ms'] as int,
+    );
+  }
+
+  @override
+  String toString() {
+    if (!matched) {
+      return 'TemplateOcrResult(no match, fallback: $fallback)';
+    }
+    return 'TemplateOcrResult($templateId, ${fields.length} fields, $inliers inliers, ${inferenceTimeMs}ms)';
+  }
+}
+
+/// A registered template
+class TemplateInfo {
+  final String id;
+  final int width;    // Reference image size
+  final int height;
+  final int anchors;  // Features pages are aligned against
+  final int fields;
+  final int matches;  // Pages matched since registration
+
+  TemplateInfo({
+    required this.id,
+    required this.width,
+    required this.height,
+    required this.anchors,
+    required this.fields,
+    required this.matches,
+  });
+
+  factory TemplateInfo.fromJson(Map<String, dynamic> json) {
+    return TemplateInfo(
+      id: json['id'] as String,
+      width: json['width'] as int,
+      height: json['height'] as int,
+      anchors: json['anchors'] as int,
+      fields: json['fields'] as int,
+      matches: json['matches'] as int,
+    );
+  }
+
+  @override
+  String toString() => 'TemplateInfo($id, $fields fields, $matches matches)';
+}
+
+// ========================
+// Page Cache Models
+// ========================
+
+/// Result of [OcrKit.openPage] / [OcrKit.recognizePage]
+class PageOcrResult {
+  final int page;         // Handle for recognizePage / closePage
+  final OcrResult result;
+  final int boxes;        // Boxes at this detection threshold
+  final int reused;       // Read earlier, served from the cache
+  final int recognized;   // Sent to the recognition model
+
+  PageOcrResult({
+    required this.page,
+    required this.result,
+    required this.boxes,
+    required this.reused,
+    required this.recognized,
+  });
+
+  factory PageOcrResult.fromJson(Map<String, dynamic> json) {
+    return PageOcrResult(
+      page: json['page'] as int,
+      result: OcrResult.fromJson(json),
+      boxes: json['boxes'] as int,
+      reused: json['reused'] as int,
+      recognized: json['recognized'] as int,
+    );
+  }
+
+  @override
+  String toString() => 'PageOcrResult(page $page, $reused reused, $recognized recognized, $result)';
+}
+
+/// Page cache occupancy and counters since startup
+class PageCacheStats {
+  final int pages;
+  final int bytes;
+  final int budgetBytes;  // 0 = unlimited
+  final int opens;
+  final int evictions;
+  final int reused;       // Box reads served from the cache
+  final int recognized;   // Box reads that ran the recognition model
+
+  PageCacheStats({
+    required this.pages,
+    required this.bytes,
+    required this.budgetBytes,
+    required this.opens,
+    required this.evictions,
+    required this.reused,
+    required this.recognized,
+  });
+
+  factory PageCacheStats.fromJson(Map<String, dynamic> json) {
+    return PageCacheStats(
+      pages: json['pages'] as int,
+      bytes: json['bytes'] as int,
+      budgetBytes: json['budget_bytes'] as int,
+      opens: json['opens'] as int,
+      evictions: json['evictions'] as int,
+      reused: json['reused'] as int,
+      recognized: json['recognized'] as int,
+    );
+  }
+
+  @override
+  String toString() => 'PageCacheStats($pages pages, ${bytes ~/ 1024} KB, $reused reused, $recognized recognized)';
+}
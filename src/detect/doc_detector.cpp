@@ -1,73 +1,64 @@
 #include "include/doc_detector.h"
+#include "../ocr/include/ort_env.h"
+#include "../ocr/include/ocr_log.h"
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <mutex>
 
 #ifdef __ANDROID__
-#include <android/log.h>
 #include "nnapi_provider_factory.h"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, "OcrKit", __VA_ARGS__)
 #elif defined(__APPLE__)
-#include <os/log.h>
 #include "coreml_provider_factory.h"
-#define LOGD(...) os_log(OS_LOG_DEFAULT, __VA_ARGS__)
-#else
-#define LOGD(...) do {} while(0)
 #endif
 
-// Global session management
-static Ort::Env* g_env = nullptr;
-static Ort::SessionOptions* g_session_options = nullptr;
-static Ort::Session* g_session = nullptr;
-static bool g_initialized = false;
+// Model named by ConfigManager, used by detectDocLayout
+static std::shared_ptr<LayoutModel> g_model;
+static std::mutex g_model_mutex;
 
 void releaseLayoutSession() {
-    if (g_session) {
-        delete g_session;
-        g_session = nullptr;
-    }
-    if (g_session_options) {
-        delete g_session_options;
-        g_session_options = nullptr;
-    }
-    if (g_env) {
-        delete g_env;
-        g_env = nullptr;
-    }
-    g_initialized = false;
-    LOGD("Layout session released");
+    std::lock_guard<std::mutex> lock(g_model_mutex);
+    g_model.reset();
+    LOGI("Layout session released");
 }
 
-void initOnnxSession() {
-    if (g_initialized) {
-        LOGD("Session already initialized, skipping");
-        return;
-    }
+LayoutModel::LayoutModel(const std::string& model_path) {
+#ifdef _WIN32
+    Load(ConfigManager::ConvertToWstring(model_path).c_str());
+#else
+    Load(model_path.c_str());
+#endif
+}
 
-    LOGD("Creating ONNX session...");
+#ifdef _WIN32
+LayoutModel::LayoutModel(const std::wstring& model_path) {
+    Load(model_path.c_str());
+}
+#endif
 
-    // Create environment
-    g_env = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "OcrKit");
+void LayoutModel::Load(const ORTCHAR_T* model_path) {
+    LOGD("Creating ONNX session...");
 
-    // Create session options with optimizations
-    g_session_options = new Ort::SessionOptions();
+    // Shared environment with the OCR engine (one CPU arena for all sessions)
+    env_ = &AcquireOrtEnv();
 
     // Enable graph optimizations
-    g_session_options->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    session_options_.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
 
     // Set thread count for CPU fallback
-    g_session_options->SetIntraOpNumThreads(4);
-    g_session_options->SetInterOpNumThreads(2);
+    session_options_.SetIntraOpNumThreads(4);
+    session_options_.SetInterOpNumThreads(2);
+    UseSharedAllocator(session_options_);
 
     // Enable hardware acceleration
 #ifdef __ANDROID__
     LOGD("Attempting to enable NNAPI...");
     // Use NNAPI_FLAG_USE_NONE to allow CPU fallback for unsupported ops
     uint32_t nnapi_flags = NNAPI_FLAG_USE_NONE;
-    OrtStatus* status = OrtSessionOptionsAppendExecutionProvider_Nnapi(*g_session_options, nnapi_flags);
+    OrtStatus* status = OrtSessionOptionsAppendExecutionProvider_Nnapi(session_options_, nnapi_flags);
     if (status != nullptr) {
         const char* error_msg = Ort::GetApi().GetErrorMessage(status);
-        LOGD("NNAPI failed: %s", error_msg);
+        LOGW("NNAPI failed: %s", error_msg);
         Ort::GetApi().ReleaseStatus(status);
     } else {
         LOGD("NNAPI execution provider enabled (with CPU fallback)");
@@ -76,10 +67,10 @@ void initOnnxSession() {
     LOGD("Attempting to enable Core ML...");
     // Core ML flags: 0 = default, use Neural Engine when available
     uint32_t coreml_flags = 0;
-    OrtStatus* status = OrtSessionOptionsAppendExecutionProvider_CoreML(*g_session_options, coreml_flags);
+    OrtStatus* status = OrtSessionOptionsAppendExecutionProvider_CoreML(session_options_, coreml_flags);
     if (status != nullptr) {
         const char* error_msg = Ort::GetApi().GetErrorMessage(status);
-        LOGD("Core ML failed: %s", error_msg);
+        LOGW("Core ML failed: %s", error_msg);
         Ort::GetApi().ReleaseStatus(status);
     } else {
         LOGD("Core ML execution provider enabled");
@@ -87,44 +78,51 @@ void initOnnxSession() {
 #endif
 
     // Create session
-    LOGD("Loading model: %s", ConfigManager::GetInstance().MODEL_PATH.c_str());
-    g_session = new Ort::Session(*g_env, ConfigManager::GetInstance().MODEL_PATH.c_str(), *g_session_options);
+    try {
+        session_ = std::make_unique<Ort::Session>(*env_, model_path, session_options_);
+    } catch (...) {
+        ReleaseOrtEnv();
+        throw;
+    }
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    num_inputs_ = session_->GetInputCount();
+    output_name_ = session_->GetOutputNameAllocated(0, allocator).get();
+    LOGI("ONNX session initialized successfully (%zu inputs)", num_inputs_);
+}
 
-    g_initialized = true;
-    LOGD("ONNX session initialized successfully");
+LayoutModel::~LayoutModel() {
+    session_.reset();
+    ReleaseOrtEnv();
 }
 
 std::vector<DetectionBox> detectDocLayout(const cv::Mat& image, float conf_threshold) {
+    std::shared_ptr<LayoutModel> model;
+    try {
+        // Initialize session (only once)
+        std::lock_guard<std::mutex> lock(g_model_mutex);
+        if (!g_model) {
+            g_model = std::make_shared<LayoutModel>(ConfigManager::GetInstance().MODEL_PATH);
+        }
+        model = g_model;
+    } catch (const Ort::Exception& e) {
+        LOGE("ONNX Runtime error: %s", e.what());
+        return {};
+    }
+    return model->Detect(image, conf_threshold);
+}
+
+std::vector<DetectionBox> LayoutModel::Detect(const cv::Mat& image, float conf_threshold) {
     std::vector<DetectionBox> results;
 
-    LOGD("detectDocLayout called, image size: %dx%d, threshold: %.2f", image.cols, image.rows, conf_threshold);
+    LOGD("Detect called, image size: %dx%d, threshold: %.2f", image.cols, image.rows, conf_threshold);
 
     if (image.empty()) {
-        LOGD("Error: Empty image");
+        LOGW("Empty image");
         return results;
     }
 
     try {
-        // Initialize session (only once)
-        initOnnxSession();
-
-        if (!g_session) {
-            LOGD("Error: Session not initialized");
-            return results;
-        }
-
-        // Get input/output info
-        static Ort::AllocatorWithDefaultOptions allocator;
-        static auto input_name = g_session->GetInputNameAllocated(0, allocator);
-
-        // Get number of inputs and outputs
-        size_t num_inputs = g_session->GetInputCount();
-        size_t num_outputs = g_session->GetOutputCount();
-        LOGD("Model has %zu inputs and %zu outputs", num_inputs, num_outputs);
-
-        static auto output_name_0 = g_session->GetOutputNameAllocated(0, allocator);
-        static auto output_name_1 = (num_outputs > 1) ? g_session->GetOutputNameAllocated(1, allocator) : g_session->GetOutputNameAllocated(0, allocator);
-
         // Preprocess image
         int target_width = 640;
         int target_height = 640;
@@ -140,7 +138,7 @@ std::vector<DetectionBox> detectDocLayout(const cv::Mat& image, float conf_thres
         std::vector<int64_t> image_shape = {1, 3, target_height, target_width};
         std::vector<int64_t> scale_shape = {1, 2};
 
-        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const Ort::MemoryInfo& memory_info = CpuMemoryInfo();
 
         Ort::Value image_tensor = Ort::Value::CreateTensor<float>(
             memory_info, blob.ptr<float>(), blob.total(),
@@ -150,15 +148,14 @@ std::vector<DetectionBox> detectDocLayout(const cv::Mat& image, float conf_thres
             memory_info, scale_factor.data(), scale_factor.size(),
             scale_shape.data(), scale_shape.size());
 
-        // Run inference - auto detect model type (M: 2 inputs, L: 3 inputs)
-        LOGD("Running inference with %zu inputs...", num_inputs);
+        // Run inference - model type from the input count (M: 2 inputs, L: 3 inputs)
+        LOGD("Running inference with %zu inputs...", num_inputs_);
         std::vector<Ort::Value> outputs;
         std::vector<const char*> input_names;
         std::vector<Ort::Value> input_tensors;
-        std::vector<const char*> output_names = {output_name_0.get()};
+        std::vector<const char*> output_names = {output_name_.c_str()};
 
-        // Track if we're using L model
-        bool is_l_model = (num_inputs == 3);
+        bool is_l_model = IsLargeModel();
 
         // Prepare im_shape for L model (original image size)
         std::vector<float> im_shape_data = {static_cast<float>(image.rows), static_cast<float>(image.cols)};
@@ -192,14 +189,14 @@ std::vector<DetectionBox> detectDocLayout(const cv::Mat& image, float conf_thres
 
         auto start = std::chrono::high_resolution_clock::now();
 
-        outputs = g_session->Run(
+        outputs = session_->Run(
             Ort::RunOptions{nullptr},
             input_names.data(), input_tensors.data(), input_tensors.size(),
             output_names.data(), output_names.size());
 
         auto end = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        LOGD("Inference complete in %lld ms", duration);
+        LOGD("Inference complete in %lld ms", (long long)duration);
 
         // Parse output: [N, 6] = [class_id, score, x1, y1, x2, y2]
         auto output_shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
@@ -207,6 +204,7 @@ std::vector<DetectionBox> detectDocLayout(const cv::Mat& image, float conf_thres
         LOGD("Number of raw detections: %d", num_detections);
 
         float* output_data = outputs[0].GetTensorMutableData<float>();
+        results.reserve(num_detections);
 
         // Convert to DetectionBox and restore to original image coordinates
         float inv_scale_x = is_l_model ? 1.0f : (1.0f / scale_factor[0]);
@@ -235,17 +233,16 @@ std::vector<DetectionBox> detectDocLayout(const cv::Mat& image, float conf_thres
 
                 box.score = score;
                 box.class_id = class_id;
-                box.class_name = DOC_CLASSES[class_id];
                 results.push_back(box);
             }
         }
 
     } catch (const Ort::Exception& e) {
-        LOGD("ONNX Runtime error: %s", e.what());
+        LOGE("ONNX Runtime error: %s", e.what());
     } catch (const cv::Exception& e) {
-        LOGD("OpenCV error: %s", e.what());
+        LOGE("OpenCV error: %s", e.what());
     } catch (const std::exception& e) {
-        LOGD("Error: %s", e.what());
+        LOGE("Error: %s", e.what());
     }
 
     return results;
@@ -264,7 +261,7 @@ std::string detectionsToJson(const std::vector<DetectionBox>& detections) {
         json << "\"y2\":" << box.y2 << ",";
         json << "\"score\":" << std::setprecision(4) << box.score << ",";
         json << "\"class_id\":" << box.class_id << ",";
-        json << "\"class_name\":\"" << box.class_name << "\"";
+        json << "\"class_name\":\"" << docClassName(box.class_id) << "\"";
         json << "}";
         if (i < detections.size() - 1) {
             json << ",";
@@ -3,6 +3,9 @@
 
 #include "utils.h"
 #include "config_manager.h"
+#include <onnxruntime_cxx_api.h>
+#include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -10,12 +13,11 @@
 struct DetectionBox {
     float x1, y1, x2, y2;  // Bounding box coordinates (in original image space)
     float score;           // Confidence score
-    int class_id;          // Class ID (0-22)
-    std::string class_name; // Class name
+    int class_id;          // Class ID (0-22), name in DOC_CLASSES
 };
 
 // 23 document element classes
-const std::vector<std::string> DOC_CLASSES = {
+constexpr std::array<const char*, 23> DOC_CLASSES = {
     "paragraph_title",  // 0
     "image",           // 1
     "text",            // 2
@@ -41,10 +43,42 @@ const std::vector<std::string> DOC_CLASSES = {
     "aside_text"       // 22
 };
 
-// Main detection function
+// Class name for a DetectionBox::class_id
+inline const char* docClassName(int class_id) {
+    return class_id >= 0 && class_id < static_cast<int>(DOC_CLASSES.size()) ? DOC_CLASSES[class_id] : "unknown";
+}
+
+// One loaded PP-DocLayout model (M: 2 inputs, L: 3 inputs). Sessions share
+// the env and arena from ort_env.h, so several models can be resident at once.
+class LayoutModel {
+public:
+    // Throws Ort::Exception if the model cannot be loaded
+    explicit LayoutModel(const std::string& model_path);
+#ifdef _WIN32
+    explicit LayoutModel(const std::wstring& model_path);
+#endif
+    ~LayoutModel();
+    LayoutModel(const LayoutModel&) = delete;
+    LayoutModel& operator=(const LayoutModel&) = delete;
+
+    std::vector<DetectionBox> Detect(const cv::Mat& image, float conf_threshold = 0.5);
+
+    bool IsLargeModel() const { return num_inputs_ == 3; }
+
+private:
+    void Load(const ORTCHAR_T* model_path);
+
+    Ort::Env* env_ = nullptr;
+    Ort::SessionOptions session_options_;
+    std::unique_ptr<Ort::Session> session_;
+    size_t num_inputs_ = 0;
+    std::string output_name_;
+};
+
+// Main detection function (model from ConfigManager, loaded on first call)
 std::vector<DetectionBox> detectDocLayout(const cv::Mat& image, float conf_threshold = 0.5);
 
-// Release ONNX session resources
+// Release the ConfigManager model
 void releaseLayoutSession();
 
 // Convert detections to JSON string
@@ -1,4 +1,5 @@
 #include "include/utils.h"
+#include "../ocr/include/pipeline_kernels.h"
 
 std::pair<cv::Mat, std::vector<float>> preprocessImage(const cv::Mat& img, int target_width, int target_height) {
     // PP-DocLayout: keep_ratio = false, direct resize
@@ -23,15 +24,6 @@ std::pair<cv::Mat, std::vector<float>> preprocessImage(const cv::Mat& img, int t
 
 cv::Mat imageToBlob(const cv::Mat& img) {
     // PP-DocLayout: mean=[0,0,0], std=[1,1,1] (no normalization, just scale to float)
-    // Input: HWC RGB uint8 -> Output: NCHW float32 [0, 255]
-    cv::Mat blob = cv::dnn::blobFromImage(
-        img,
-        1.0 / 255.0,  // Scale to [0, 1]
-        cv::Size(),   // Keep size
-        cv::Scalar(0, 0, 0),  // No mean subtraction
-        false,        // swapRB: already RGB
-        false,        // crop
-        CV_32F
-    );
-    return blob;
+    // Input: HWC RGB uint8 -> Output: NCHW float32 [0, 1]
+    return MakeInputBlob<LayoutInputPipeline>(img);
 }
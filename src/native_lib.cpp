@@ -10,13 +10,20 @@
 #include "detect/include/config_manager.h"
 #include "detect/include/doc_detector.h"
 #include "ocr/include/ocr_engine.h"
-
-#ifdef __ANDROID__
-#include <android/log.h>
-#endif
-
-#define LOGI(...) do {} while(0)
-#define LOGE(...) do {} while(0)
+#include "ocr/include/video_ocr.h"
+#include "ocr/include/search_index.h"
+#include "ocr/include/fuzzy_match.h"
+#include "ocr/include/result_store.h"
+#include "ocr/include/pdf_ocr.h"
+#include "ocr/include/model_registry.h"
+#include "ocr/include/task_scheduler.h"
+#include "ocr/include/golden_corpus.h"
+#include "ocr/include/box_merge.h"
+#include "ocr/include/field_query.h"
+#include "ocr/include/template_registry.h"
+#include "ocr/include/page_cache.h"
+#include "ocr/include/ocr_log.h"
+#include <nlohmann/json.hpp>
 
 using namespace std::chrono;
 
@@ -24,14 +31,45 @@ using namespace std::chrono;
 extern "C" __attribute__((visibility("default")))
 void initModel(const char* model_path) {
     ConfigManager::GetInstance().Init(std::string(model_path));
-    LOGI("Model initialized: %s\n", model_path);
+    LOGI("Model initialized: %s", model_path);
 }
 
 // Release layout model resources
 extern "C" __attribute__((visibility("default")))
 void releaseLayoutModel() {
     releaseLayoutSession();
-    LOGI("Layout model released\n");
+    LOGI("Layout model released");
+}
+
+static std::string layoutResultJson(const std::vector<DetectionBox>& results, long long inference_time,
+                                    const cv::Mat& image) {
+    std::ostringstream json;
+    json << "{\"detections\":[";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& box = results[i];
+        json << "{";
+        json << "\"x1\":" << std::fixed << std::setprecision(2) << box.x1 << ",";
+        json << "\"y1\":" << box.y1 << ",";
+        json << "\"x2\":" << box.x2 << ",";
+        json << "\"y2\":" << box.y2 << ",";
+        json << "\"score\":" << std::setprecision(4) << box.score << ",";
+        json << "\"class_id\":" << box.class_id << ",";
+        json << "\"class_name\":\"" << docClassName(box.class_id) << "\"";
+        json << "}";
+        if (i < results.size() - 1) {
+            json << ",";
+        }
+    }
+
+    json << "],";
+    json << "\"count\":" << results.size() << ",";
+    json << "\"inference_time_ms\":" << inference_time << ",";
+    json << "\"image_width\":" << image.cols << ",";
+    json << "\"image_height\":" << image.rows;
+    json << "}";
+
+    return json.str();
 }
 
 // Detect layout from image path
@@ -50,33 +88,7 @@ char* detectLayout(const char* img_path, float conf_threshold) {
         auto end = high_resolution_clock::now();
         long long inference_time = duration_cast<milliseconds>(end - start).count();
 
-        std::ostringstream json;
-        json << "{\"detections\":[";
-
-        for (size_t i = 0; i < results.size(); i++) {
-            const auto& box = results[i];
-            json << "{";
-            json << "\"x1\":" << std::fixed << std::setprecision(2) << box.x1 << ",";
-            json << "\"y1\":" << box.y1 << ",";
-            json << "\"x2\":" << box.x2 << ",";
-            json << "\"y2\":" << box.y2 << ",";
-            json << "\"score\":" << std::setprecision(4) << box.score << ",";
-            json << "\"class_id\":" << box.class_id << ",";
-            json << "\"class_name\":\"" << box.class_name << "\"";
-            json << "}";
-            if (i < results.size() - 1) {
-                json << ",";
-            }
-        }
-
-        json << "],";
-        json << "\"count\":" << results.size() << ",";
-        json << "\"inference_time_ms\":" << inference_time << ",";
-        json << "\"image_width\":" << image.cols << ",";
-        json << "\"image_height\":" << image.rows;
-        json << "}";
-
-        return json.str();
+        return layoutResultJson(results, inference_time, image);
     }).get().c_str());
 }
 
@@ -106,14 +118,16 @@ void initOcrModels(const char* det_model_path, const char* rec_model_path, const
         std::string(rec_model_path),
         std::string(dict_path)
     );
-    LOGI("OCR models initialized\n");
+    LOGI("OCR models initialized");
 }
 
 // Release OCR engine resources
 extern "C" __attribute__((visibility("default")))
 void releaseOcrEngine() {
+    // Cached det maps and reads belong to the released models
+    PageCache::GetInstance().CloseAll();
     OcrEngine::GetInstance().Release();
-    LOGI("OCR engine released\n");
+    LOGI("OCR engine released");
 }
 
 // Recognize text from image path (full OCR: detect + recognize)
@@ -131,7 +145,7 @@ char* recognizeTextFromPath(const char* img_path, float det_threshold, float rec
             return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
         }
 
-        std::vector<TextLineResult> results = OcrEngine::GetInstance().RecognizeText(
+        TextLines results = OcrEngine::GetInstance().RecognizeText(
             image, det_threshold, rec_threshold);
 
         auto end = high_resolution_clock::now();
@@ -199,7 +213,7 @@ char* recognizeTextFromBuffer(const uint8_t* buffer, int width, int height, int
             return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
         }
 
-        std::vector<TextLineResult> results = OcrEngine::GetInstance().RecognizeText(
+        TextLines results = OcrEngine::GetInstance().RecognizeText(
             image, det_threshold, rec_threshold);
 
         auto end = high_resolution_clock::now();
@@ -291,3 +305,1790 @@ char* detectTextFromPath(const char* img_path, float threshold) {
         return json.str();
     }).get().c_str());
 }
+
+// ========================
+// Video OCR Functions
+// ========================
+
+// Append a JSON string literal with special characters escaped
+static void appendJsonString(std::ostringstream& json, std::string_view text) {
+    json << "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': json << "\\\""; break;
+            case '\\': json << "\\\\"; break;
+            case '\n': json << "\\n"; break;
+            case '\r': json << "\\r"; break;
+            case '\t': json << "\\t"; break;
+            default: json << c;
+        }
+    }
+    json << "\"";
+}
+
+// Append text lines as a JSON array (same fields as recognizeTextFromPath results)
+static void appendTextLinesJson(std::ostringstream& json, const TextLines& lines) {
+    json << "[";
+    for (size_t i = 0; i < lines.size(); i++) {
+        const auto& r = lines[i];
+        json << "{";
+        json << "\"x1\":" << std::fixed << std::setprecision(2) << r.x1 << ",";
+        json << "\"y1\":" << r.y1 << ",";
+        json << "\"x2\":" << r.x2 << ",";
+        json << "\"y2\":" << r.y2 << ",";
+        json << "\"score\":" << std::setprecision(4) << r.score << ",";
+        json << "\"text\":";
+        appendJsonString(json, r.text);
+        json << "}";
+        if (i < lines.size() - 1) {
+            json << ",";
+        }
+    }
+    json << "]";
+}
+
+// Recognize text from a video file, running OCR only on keyframes where content changed
+// roi_width/roi_height <= 0 watches the full frame
+extern "C" __attribute__((visibility("default")))
+char* recognizeTextFromVideo(const char* video_path, float sample_interval_ms, float change_threshold,
+                             int roi_x, int roi_y, int roi_width, int roi_height,
+                             float det_threshold, float rec_threshold) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+
+        if (!OcrEngine::GetInstance().IsInitialized()) {
+            return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
+        }
+
+        VideoOcrOptions options;
+        options.sample_interval_ms = sample_interval_ms > 0 ? sample_interval_ms : options.sample_interval_ms;
+        options.change_threshold = change_threshold;
+        if (roi_width > 0 && roi_height > 0) {
+            options.roi = cv::Rect(roi_x, roi_y, roi_width, roi_height);
+        }
+        options.det_threshold = det_threshold;
+        options.rec_threshold = rec_threshold;
+
+        VideoOcrStats stats;
+        std::vector<VideoTextSegment> segments = recognizeVideo(video_path, options, &stats);
+
+        if (stats.frames_total == 0) {
+            return "{\"error\":\"Could not load video\",\"code\":\"VIDEO_LOAD_FAILED\"}";
+        }
+
+        auto end = high_resolution_clock::now();
+        long long inference_time = duration_cast<milliseconds>(end - start).count();
+
+        std::ostringstream json;
+        json << "{\"segments\":[";
+
+        for (size_t i = 0; i < segments.size(); i++) {
+            const auto& seg = segments[i];
+            json << "{";
+            json << "\"start_ms\":" << std::fixed << std::setprecision(1) << seg.start_ms << ",";
+            json << "\"end_ms\":" << seg.end_ms << ",";
+            json << "\"text\":";
+            appendJsonString(json, seg.text);
+            json << ",\"results\":";
+            appendTextLinesJson(json, seg.lines);
+            json << "}";
+            if (i < segments.size() - 1) {
+                json << ",";
+            }
+        }
+
+        json << "],";
+        json << "\"count\":" << segments.size() << ",";
+        json << "\"frames_total\":" << stats.frames_total << ",";
+        json << "\"frames_sampled\":" << stats.frames_sampled << ",";
+        json << "\"keyframes\":" << stats.keyframes << ",";
+        json << "\"ocr_runs\":" << stats.ocr_runs << ",";
+        json << "\"duration_ms\":" << std::setprecision(1) << stats.duration_ms << ",";
+        json << "\"inference_time_ms\":" << inference_time << ",";
+        json << "\"video_width\":" << stats.video_width << ",";
+        json << "\"video_height\":" << stats.video_height;
+        json << "}";
+
+        return json.str();
+    }).get().c_str());
+}
+
+// ========================
+// Search Index Functions
+// ========================
+
+// Parse the "results" array of an OCR result JSON into text lines
+static bool parseTextLinesJson(const char* ocr_json, TextLines& lines) {
+    nlohmann::json parsed = nlohmann::json::parse(ocr_json, nullptr, false);
+    if (parsed.is_discarded() || !parsed.contains("results") || !parsed["results"].is_array()) {
+        return false;
+    }
+
+    const auto& results = parsed["results"];
+    lines.Reserve(results.size());
+    for (const auto& item : results) {
+        const auto text = item.find("text");
+        lines.Add(item.value("x1", 0.0f), item.value("y1", 0.0f),
+                  item.value("x2", 0.0f), item.value("y2", 0.0f),
+                  item.value("score", 0.0f),
+                  text != item.end() && text->is_string() ? std::string_view(text->get_ref<const std::string&>())
+                                                          : std::string_view());
+    }
+    return true;
+}
+
+// Add one OCR'd page (OCR result JSON as returned by recognizeTextFromPath) to an index.
+// Lines are buffered until searchIndexCommit.
+extern "C" __attribute__((visibility("default")))
+char* searchIndexAddPage(const char* index_path, int doc_id, int page, const char* ocr_json) {
+    TextLines lines;
+    if (!parseTextLinesJson(ocr_json, lines)) {
+        return strdup("{\"error\":\"Invalid OCR result JSON\",\"code\":\"INVALID_JSON\"}");
+    }
+
+    std::shared_ptr<SearchIndex> index = SearchIndex::Get(index_path);
+    index->AddPage(static_cast<uint32_t>(doc_id), static_cast<uint32_t>(page), lines);
+
+    std::ostringstream json;
+    json << "{\"added\":" << lines.size() << ",\"pending\":" << index->PendingCount() << "}";
+    return strdup(json.str().c_str());
+}
+
+// Append buffered pages to the index file. Returns 1 on success, 0 on I/O failure.
+extern "C" __attribute__((visibility("default")))
+int searchIndexCommit(const char* index_path) {
+    return SearchIndex::Get(index_path)->Commit() ? 1 : 0;
+}
+
+// Merge all index segments into one. Returns 1 on success, 0 on I/O failure.
+extern "C" __attribute__((visibility("default")))
+int searchIndexCompact(const char* index_path) {
+    return SearchIndex::Get(index_path)->Compact() ? 1 : 0;
+}
+
+// Query an index; min_coverage is the fraction of query terms a line must contain (1.0 = all)
+extern "C" __attribute__((visibility("default")))
+char* searchIndexQuery(const char* index_path, const char* query, int max_hits, float min_coverage) {
+    auto start = high_resolution_clock::now();
+
+    std::vector<SearchHit> hits = SearchIndex::Get(index_path)->Search(
+        query, static_cast<size_t>(std::max(0, max_hits)), min_coverage);
+
+    auto end = high_resolution_clock::now();
+    long long search_time = duration_cast<microseconds>(end - start).count();
+
+    std::string json = searchHitsToJson(hits);
+    json.insert(json.size() - 1, ",\"search_time_us\":" + std::to_string(search_time));
+    return strdup(json.c_str());
+}
+
+// Index size information
+extern "C" __attribute__((visibility("default")))
+char* searchIndexInfo(const char* index_path) {
+    std::shared_ptr<SearchIndex> index = SearchIndex::Get(index_path);
+
+    std::ostringstream json;
+    json << "{\"lines\":" << index->LineCount() << ",";
+    json << "\"segments\":" << index->SegmentCount() << ",";
+    json << "\"pending\":" << index->PendingCount() << "}";
+    return strdup(json.str().c_str());
+}
+
+// Unmap an index and drop uncommitted pages
+extern "C" __attribute__((visibility("default")))
+void searchIndexClose(const char* index_path) {
+    SearchIndex::Close(index_path);
+}
+
+// ========================
+// Fuzzy Match Functions
+// ========================
+
+// Append match fields: matched substring and its code point range within the line
+static void appendFuzzyMatchJson(std::ostringstream& json, std::string_view text, const FuzzyMatch& m) {
+    json << "\"text\":";
+    appendJsonString(json, std::string(text));
+    json << ",\"match\":";
+    appendJsonString(json, utf8Substring(text, m.start, m.end));
+    json << ",\"start\":" << m.start << ",\"end\":" << m.end << ",\"cost\":" << m.cost;
+}
+
+// Approximate search over the lines of one OCR result (JSON as returned by recognizeTextFromPath).
+// Tolerates up to max_errors character insertions, deletions or substitutions.
+extern "C" __attribute__((visibility("default")))
+char* fuzzyMatchText(const char* ocr_json, const char* pattern, int max_errors) {
+    auto start = high_resolution_clock::now();
+
+    TextLines lines;
+    if (!parseTextLinesJson(ocr_json, lines)) {
+        return strdup("{\"error\":\"Invalid OCR result JSON\",\"code\":\"INVALID_JSON\"}");
+    }
+
+    std::vector<std::string> texts;
+    texts.reserve(lines.size());
+    for (const auto& line : lines) {
+        texts.emplace_back(line.text);
+    }
+    std::vector<FuzzyMatch> matches = fuzzyMatchTexts(pattern, texts, max_errors);
+
+    auto end = high_resolution_clock::now();
+    long long search_time = duration_cast<microseconds>(end - start).count();
+
+    std::ostringstream json;
+    json << "{\"matches\":[";
+    for (size_t i = 0; i < matches.size(); i++) {
+        const auto& m = matches[i];
+        const auto& line = lines[m.line_index];
+        json << "{\"box_id\":" << m.line_index << ",";
+        json << "\"x1\":" << std::fixed << std::setprecision(2) << line.x1 << ",";
+        json << "\"y1\":" << line.y1 << ",";
+        json << "\"x2\":" << line.x2 << ",";
+        json << "\"y2\":" << line.y2 << ",";
+        json << "\"score\":" << std::setprecision(4) << line.score << ",";
+        appendFuzzyMatchJson(json, line.text, m);
+        json << "}";
+        if (i < matches.size() - 1) {
+            json << ",";
+        }
+    }
+    json << "],\"count\":" << matches.size() << ",\"search_time_us\":" << search_time << "}";
+    return strdup(json.str().c_str());
+}
+
+// Approximate search over every committed line of an index, best matches first
+extern "C" __attribute__((visibility("default")))
+char* searchIndexFuzzy(const char* index_path, const char* pattern, int max_errors, int max_hits) {
+    auto start = high_resolution_clock::now();
+
+    struct Hit {
+        IndexLineRecord record;
+        std::string text;
+        FuzzyMatch match;
+    };
+    std::vector<Hit> hits;
+
+    FuzzyPattern matcher(pattern);
+    if (!matcher.empty()) {
+        SearchIndex::Get(index_path)->ForEachLine([&](const IndexLineRecord& record, std::string_view text) {
+            FuzzyMatch match;
+            if (matcher.Find(text, max_errors, match)) {
+                hits.push_back({record, std::string(text), match});
+            }
+        });
+    }
+
+    std::stable_sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) {
+        return a.match.cost < b.match.cost;
+    });
+    if (max_hits > 0 && hits.size() > static_cast<size_t>(max_hits)) {
+        hits.resize(max_hits);
+    }
+
+    auto end = high_resolution_clock::now();
+    long long search_time = duration_cast<microseconds>(end - start).count();
+
+    std::ostringstream json;
+    json << "{\"matches\":[";
+    for (size_t i = 0; i < hits.size(); i++) {
+        const auto& h = hits[i];
+        json << "{\"doc_id\":" << h.record.doc_id << ",";
+        json << "\"page\":" << h.record.page << ",";
+        json << "\"box_id\":" << h.record.box_id << ",";
+        json << "\"x1\":" << std::fixed << std::setprecision(2) << h.record.x1 << ",";
+        json << "\"y1\":" << h.record.y1 << ",";
+        json << "\"x2\":" << h.record.x2 << ",";
+        json << "\"y2\":" << h.record.y2 << ",";
+        json << "\"score\":" << std::setprecision(4) << h.record.score << ",";
+        appendFuzzyMatchJson(json, h.text, h.match);
+        json << "}";
+        if (i < hits.size() - 1) {
+            json << ",";
+        }
+    }
+    json << "],\"count\":" << hits.size() << ",\"search_time_us\":" << search_time << "}";
+    return strdup(json.str().c_str());
+}
+
+// ========================
+// Result Store Functions
+// ========================
+
+// Recognize a batch of images straight into a result store, without building
+// per-image JSON. image_paths_json is a JSON array of file paths.
+// Pages are numbered in store order; images that fail to load are skipped and reported.
+// Runs at background priority, yielding the engine to interactive requests.
+extern "C" __attribute__((visibility("default")))
+char* resultStoreRecognizeFiles(const char* store_path, const char* image_paths_json,
+                                float det_threshold, float rec_threshold) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+        RequestScope scope(RequestPriority::kBackground);
+
+        if (!OcrEngine::GetInstance().IsInitialized()) {
+            return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
+        }
+
+        nlohmann::json paths = nlohmann::json::parse(image_paths_json, nullptr, false);
+        if (paths.is_discarded() || !paths.is_array()) {
+            return "{\"error\":\"Invalid image path list\",\"code\":\"INVALID_JSON\"}";
+        }
+
+        std::shared_ptr<ResultStore> store = ResultStore::Get(store_path);
+        long long first_page = -1;
+        size_t added = 0;
+        std::vector<std::string> failed;
+
+        for (const auto& item : paths) {
+            std::string path = item.is_string() ? item.get<std::string>() : std::string();
+            cv::Mat image = path.empty() ? cv::Mat() : cv::imread(path);
+            if (image.empty()) {
+                failed.push_back(path);
+                continue;
+            }
+
+            TextLines results = OcrEngine::GetInstance().RecognizeText(
+                image, det_threshold, rec_threshold);
+            uint32_t page = store->AppendPage(path, image.cols, image.rows, results);
+            if (first_page < 0) {
+                first_page = page;
+            }
+            added++;
+        }
+
+        bool flushed = store->Flush();
+
+        auto end = high_resolution_clock::now();
+        long long inference_time = duration_cast<milliseconds>(end - start).count();
+
+        std::ostringstream json;
+        json << "{\"added\":" << added << ",";
+        json << "\"first_page\":" << first_page << ",";
+        json << "\"flushed\":" << (flushed ? "true" : "false") << ",";
+        json << "\"failed\":[";
+        for (size_t i = 0; i < failed.size(); i++) {
+            appendJsonString(json, failed[i]);
+            if (i < failed.size() - 1) {
+                json << ",";
+            }
+        }
+        json << "],";
+        json << "\"inference_time_ms\":" << inference_time << "}";
+        return json.str();
+    }).get().c_str());
+}
+
+// Append one already-recognized page (OCR result JSON as returned by recognizeTextFromPath).
+// Returns the page number, or -1 if the JSON is invalid. Buffered until resultStoreFlush.
+extern "C" __attribute__((visibility("default")))
+int resultStoreAppendPage(const char* store_path, const char* source, const char* ocr_json) {
+    TextLines lines;
+    if (!parseTextLinesJson(ocr_json, lines)) {
+        return -1;
+    }
+
+    nlohmann::json parsed = nlohmann::json::parse(ocr_json, nullptr, false);
+    int image_width = parsed.value("image_width", 0);
+    int image_height = parsed.value("image_height", 0);
+
+    return static_cast<int>(ResultStore::Get(store_path)->AppendPage(
+        source ? source : "", image_width, image_height, lines));
+}
+
+// Write buffered pages to the store file. Returns 1 on success, 0 on I/O failure.
+extern "C" __attribute__((visibility("default")))
+int resultStoreFlush(const char* store_path) {
+    return ResultStore::Get(store_path)->Flush() ? 1 : 0;
+}
+
+// Read stored pages [first_page, first_page + count) as JSON
+extern "C" __attribute__((visibility("default")))
+char* resultStoreReadPages(const char* store_path, int first_page, int count) {
+    std::shared_ptr<ResultStore> store = ResultStore::Get(store_path);
+
+    std::ostringstream json;
+    json << "{\"pages\":[";
+    bool first = true;
+    store->ForEachPage(static_cast<size_t>(std::max(0, first_page)), static_cast<size_t>(std::max(0, count)),
+                      [&](size_t page, const ResultPageView& view) {
+        if (!first) {
+            json << ",";
+        }
+        first = false;
+
+        json << "{\"page\":" << page << ",";
+        json << "\"source\":";
+        appendJsonString(json, std::string(view.Source()));
+        json << ",\"image_width\":" << view.record->image_width << ",";
+        json << "\"image_height\":" << view.record->image_height << ",";
+        json << "\"results\":[";
+        for (size_t i = 0; i < view.LineCount(); i++) {
+            const ResultLineRecord& r = view.lines[i];
+            json << "{";
+            json << "\"x1\":" << std::fixed << std::setprecision(2) << r.x1 << ",";
+            json << "\"y1\":" << r.y1 << ",";
+            json << "\"x2\":" << r.x2 << ",";
+            json << "\"y2\":" << r.y2 << ",";
+            json << "\"score\":" << std::setprecision(4) << r.score << ",";
+            json << "\"text\":";
+            appendJsonString(json, std::string(view.LineText(i)));
+            json << "}";
+            if (i < view.LineCount() - 1) {
+                json << ",";
+            }
+        }
+        json << "]}";
+    });
+    json << "],\"total_pages\":" << store->PageCount() << "}";
+    return strdup(json.str().c_str());
+}
+
+// Store size information
+extern "C" __attribute__((visibility("default")))
+char* resultStoreInfo(const char* store_path) {
+    std::shared_ptr<ResultStore> store = ResultStore::Get(store_path);
+
+    std::ostringstream json;
+    json << "{\"pages\":" << store->PageCount() << ",";
+    json << "\"lines\":" << store->LineCount() << ",";
+    json << "\"chunks\":" << store->ChunkCount() << ",";
+    json << "\"pending\":" << store->PendingCount() << ",";
+    json << "\"bytes\":" << store->FileSize() << "}";
+    return strdup(json.str().c_str());
+}
+
+// Flush and unmap a store
+extern "C" __attribute__((visibility("default")))
+void resultStoreClose(const char* store_path) {
+    ResultStore::Close(store_path);
+}
+
+// ========================
+// Memory Functions
+// ========================
+
+// Back large engine input tensors (det inputs above 2 MB) with transparent huge pages.
+// Takes effect for buffers allocated afterwards; no-op where the OS lacks THP.
+extern "C" __attribute__((visibility("default")))
+void setOcrHugePages(int enable) {
+    TensorBuffer::SetHugePages(enable != 0);
+}
+
+// Process RSS and engine buffer usage, for comparing configurations on device
+extern "C" __attribute__((visibility("default")))
+char* getOcrMemoryStats() {
+    ProcessMemory memory = readProcessMemory();
+
+    std::ostringstream json;
+    json << "{\"rss_kb\":" << memory.rss_kb << ",";
+    json << "\"peak_rss_kb\":" << memory.peak_rss_kb << ",";
+    json << "\"tensor_buffer_bytes\":" << TensorBuffer::TotalBytes() << ",";
+    json << "\"huge_pages\":" << (TensorBuffer::HugePagesEnabled() ? "true" : "false") << "}";
+    return strdup(json.str().c_str());
+}
+
+// ========================
+// Log Functions
+// ========================
+
+// Runtime log level and platform echo level: {"level":"info","echo":"warn"}, each
+// "error"|"warn"|"info"|"debug". Levels above the compiled-in maximum stay off;
+// "echo" defaults to "warn", so errors and warnings reach logcat / os_log.
+// Returns the resolved settings.
+extern "C" __attribute__((visibility("default")))
+char* setOcrLogConfig(const char* config_json) {
+    nlohmann::json parsed = nlohmann::json::parse(config_json, nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_object()) {
+        return strdup("{\"error\":\"Invalid log config JSON\",\"code\":\"INVALID_JSON\"}");
+    }
+    if (parsed.contains("level")) {
+        LogLevel level;
+        if (!parsed["level"].is_string() || !logLevelFromName(parsed["level"].get<std::string>(), level)) {
+            return strdup("{\"error\":\"Unknown log level\",\"code\":\"INVALID_LOG_LEVEL\"}");
+        }
+        OcrLog::SetLevel(level);
+    }
+    if (parsed.contains("echo")) {
+        LogLevel level;
+        if (!parsed["echo"].is_string() || !logLevelFromName(parsed["echo"].get<std::string>(), level)) {
+            return strdup("{\"error\":\"Unknown log level\",\"code\":\"INVALID_LOG_LEVEL\"}");
+        }
+        OcrLog::SetEchoLevel(level);
+    }
+
+    std::ostringstream json;
+    json << "{\"level\":\"" << logLevelName(OcrLog::Level()) << "\",";
+    json << "\"max_level\":\"" << logLevelName(static_cast<LogLevel>(OCR_KIT_LOG_MAX_LEVEL)) << "\",";
+    json << "\"echo\":\"" << logLevelName(OcrLog::EchoLevel()) << "\"}";
+    return strdup(json.str().c_str());
+}
+
+// Most recent log entries (up to max_entries, 0 = all kept), oldest first:
+// {"entries":[{"seq","time_us","level","thread","text"}],"written":N,"dropped":N}
+extern "C" __attribute__((visibility("default")))
+char* dumpOcrLog(int max_entries) {
+    std::vector<LogEntry> entries =
+        OcrLog::Dump(max_entries > 0 ? static_cast<size_t>(max_entries) : LOG_RING_CAPACITY);
+
+    std::ostringstream json;
+    json << "{\"entries\":[";
+    for (size_t i = 0; i < entries.size(); i++) {
+        const LogEntry& entry = entries[i];
+        json << "{\"seq\":" << entry.seq << ",";
+        json << "\"time_us\":" << entry.time_us << ",";
+        json << "\"level\":\"" << logLevelName(entry.level) << "\",";
+        json << "\"thread\":" << entry.thread << ",";
+        json << "\"text\":";
+        appendJsonString(json, entry.text);
+        json << "}";
+        if (i < entries.size() - 1) {
+            json << ",";
+        }
+    }
+    json << "],\"written\":" << OcrLog::Written() << ",";
+    json << "\"dropped\":" << OcrLog::Dropped() << "}";
+    return strdup(json.str().c_str());
+}
+
+// Hide everything logged so far from dumpOcrLog
+extern "C" __attribute__((visibility("default")))
+void clearOcrLog() {
+    OcrLog::Clear();
+}
+
+// ========================
+// Thread Configuration Functions
+// ========================
+
+// Append an integer list as a JSON array
+static void appendIntArrayJson(std::ostringstream& json, const std::vector<int>& values) {
+    json << "[";
+    for (size_t i = 0; i < values.size(); i++) {
+        json << values[i];
+        if (i < values.size() - 1) {
+            json << ",";
+        }
+    }
+    json << "]";
+}
+
+static void appendThreadConfigJson(std::ostringstream& json, const ThreadPoolConfig& config) {
+    json << "{\"intra_threads\":" << config.intra_op_threads << ",";
+    json << "\"inter_threads\":" << config.inter_op_threads << ",";
+    json << "\"cpus\":";
+    appendIntArrayJson(json, config.cpus);
+    json << "}";
+}
+
+// Parse one pool config: {"intra_threads":4,"inter_threads":2,"cpus":"performance"|[0,1]}
+static ThreadPoolConfig parseThreadConfig(const nlohmann::json& item, const CpuTopology& topology,
+                                          const ThreadPoolConfig& current) {
+    ThreadPoolConfig config = current;
+    if (!item.is_object()) {
+        return config;
+    }
+    config.intra_op_threads = std::max(1, item.value("intra_threads", current.intra_op_threads));
+    config.inter_op_threads = std::max(1, item.value("inter_threads", current.inter_op_threads));
+    if (item.contains("cpus")) {
+        const auto& cpus = item["cpus"];
+        if (cpus.is_string()) {
+            config.cpus = cpuSetByName(topology, cpus.get<std::string>());
+        } else if (cpus.is_array()) {
+            config.cpus.clear();
+            for (const auto& cpu : cpus) {
+                if (cpu.is_number_integer() && cpu.get<int>() >= 0 &&
+                    cpu.get<int>() < static_cast<int>(topology.capacity.size())) {
+                    config.cpus.push_back(cpu.get<int>());
+                }
+            }
+        } else {
+            config.cpus.clear();
+        }
+    }
+    return config;
+}
+
+// Configure det/rec session threads and the task scheduler workers, e.g.
+//   {"det":{"intra_threads":4,"cpus":"performance"},"rec":{"intra_threads":2,"cpus":[4,5]},
+//    "tasks":{"threads":2,"cpus":"efficiency"}}
+// CPU sets are "performance", "efficiency", "all", an id list, or null for no pinning.
+// Sessions apply at the next initOcrModels; "tasks" only before the first OCR
+// call starts the workers, which also limits OpenCV to one thread (the workers
+// do the parallel work). Returns the resolved configuration.
+extern "C" __attribute__((visibility("default")))
+char* setOcrThreadConfig(const char* config_json) {
+    nlohmann::json parsed = nlohmann::json::parse(config_json, nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_object()) {
+        return strdup("{\"error\":\"Invalid thread config JSON\",\"code\":\"INVALID_JSON\"}");
+    }
+
+    OcrEngine& engine = OcrEngine::GetInstance();
+    CpuTopology topology = detectCpuTopology();
+    ThreadPoolConfig det = parseThreadConfig(parsed.value("det", nlohmann::json()), topology, engine.DetThreadConfig());
+    ThreadPoolConfig rec = parseThreadConfig(parsed.value("rec", nlohmann::json()), topology, engine.RecThreadConfig());
+    engine.SetThreadConfig(det, rec);
+
+    // Task scheduler workers: {"threads":2,"cpus":...}, threads 0 = automatic
+    TaskScheduler& tasks = TaskScheduler::GetInstance();
+    nlohmann::json tasks_item = parsed.value("tasks", nlohmann::json());
+    bool tasks_applied = true;
+    if (tasks_item.is_object()) {
+        TaskSchedulerConfig config = tasks.Config();
+        config.threads = std::max(0, tasks_item.value("threads", config.threads));
+        ThreadPoolConfig pool;
+        pool.cpus = config.cpus;
+        config.cpus = parseThreadConfig(tasks_item, topology, pool).cpus;
+        tasks_applied = tasks.Configure(config);
+    }
+    TaskSchedulerConfig task_config = tasks.Config();
+
+    std::ostringstream json;
+    json << "{\"det\":";
+    appendThreadConfigJson(json, det);
+    json << ",\"rec\":";
+    appendThreadConfigJson(json, rec);
+    json << ",\"tasks\":{\"threads\":" << tasks.WorkerCount() << ",\"cpus\":";
+    appendIntArrayJson(json, task_config.cpus);
+    json << ",\"applied\":" << (tasks_applied ? "true" : "false") << "}";
+    json << ",\"pending_reinit\":" << (engine.IsInitialized() ? "true" : "false") << "}";
+    return strdup(json.str().c_str());
+}
+
+// Core classes detected from sysfs
+extern "C" __attribute__((visibility("default")))
+char* getCpuTopology() {
+    CpuTopology topology = detectCpuTopology();
+
+    std::ostringstream json;
+    json << "{\"performance\":";
+    appendIntArrayJson(json, topology.performance);
+    json << ",\"efficiency\":";
+    appendIntArrayJson(json, topology.efficiency);
+    json << ",\"capacity\":";
+    appendIntArrayJson(json, topology.capacity);
+    json << "}";
+    return strdup(json.str().c_str());
+}
+
+// Mean, standard deviation and percentiles of a latency sample, in ms
+static void appendLatencyJson(std::ostringstream& json, std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    double mean = 0.0;
+    for (double v : samples) {
+        mean += v;
+    }
+    mean /= samples.size();
+    double variance = 0.0;
+    for (double v : samples) {
+        variance += (v - mean) * (v - mean);
+    }
+    variance /= samples.size();
+
+    auto percentile = [&](double p) {
+        return samples[std::min(samples.size() - 1, static_cast<size_t>(p * (samples.size() - 1) + 0.5))];
+    };
+
+    json << std::fixed << std::setprecision(2);
+    json << "{\"mean\":" << mean << ",";
+    json << "\"stddev\":" << std::sqrt(variance) << ",";
+    json << "\"p50\":" << percentile(0.5) << ",";
+    json << "\"p90\":" << percentile(0.9) << ",";
+    json << "\"p99\":" << percentile(0.99) << ",";
+    json << "\"min\":" << samples.front() << ",";
+    json << "\"max\":" << samples.back() << "}";
+}
+
+// Run det + rec on one image `iterations` times (after one warm-up run) and
+// report per-stage latency spread, to compare thread configurations
+extern "C" __attribute__((visibility("default")))
+char* benchmarkOcr(const char* img_path, int iterations, float det_threshold, float rec_threshold) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        cv::Mat image = cv::imread(img_path);
+        if (image.empty()) {
+            return "{\"error\":\"Could not load image\",\"code\":\"IMAGE_LOAD_FAILED\"}";
+        }
+
+        OcrEngine& engine = OcrEngine::GetInstance();
+        if (!engine.IsInitialized()) {
+            return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
+        }
+
+        int runs = std::max(1, iterations);
+        std::vector<double> det_ms, rec_ms, total_ms;
+        size_t lines = 0;
+
+        for (int i = 0; i <= runs; i++) {
+            auto t0 = high_resolution_clock::now();
+            std::vector<TextBox> boxes = engine.DetectText(image, det_threshold);
+            auto t1 = high_resolution_clock::now();
+            TextLines results = engine.RecognizeBoxes(image, boxes, rec_threshold);
+            auto t2 = high_resolution_clock::now();
+
+            if (i == 0) {
+                continue;  // Warm-up: arena growth and kernel selection
+            }
+            det_ms.push_back(duration_cast<microseconds>(t1 - t0).count() / 1000.0);
+            rec_ms.push_back(duration_cast<microseconds>(t2 - t1).count() / 1000.0);
+            total_ms.push_back(duration_cast<microseconds>(t2 - t0).count() / 1000.0);
+            lines = results.size();
+        }
+
+        std::ostringstream json;
+        json << "{\"iterations\":" << runs << ",";
+        json << "\"lines\":" << lines << ",";
+        json << "\"det_ms\":";
+        appendLatencyJson(json, det_ms);
+        json << ",\"rec_ms\":";
+        appendLatencyJson(json, rec_ms);
+        json << ",\"total_ms\":";
+        appendLatencyJson(json, total_ms);
+        json << ",\"det_threads\":";
+        appendThreadConfigJson(json, engine.DetThreadConfig());
+        json << ",\"rec_threads\":";
+        appendThreadConfigJson(json, engine.RecThreadConfig());
+        json << "}";
+        return json.str();
+    }).get().c_str());
+}
+
+// ========================
+// OCR Options Functions
+// ========================
+
+// Parse request options: {"det_threshold":0.3,"rec_threshold":0.5,"detector":"neural"|"classic"|"auto",
+// "priority":"interactive"|"background","model":"<registry id>"}
+static bool parseOcrOptions(const char* options_json, OcrOptions& options, std::string* model_id = nullptr) {
+    if (!options_json || !*options_json) {
+        return true;
+    }
+    nlohmann::json parsed = nlohmann::json::parse(options_json, nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_object()) {
+        return false;
+    }
+    // value() throws on a wrongly typed field; an exception must not leave the
+    // extern "C" entry points, so it is reported as invalid JSON
+    try {
+        options.det_threshold = parsed.value("det_threshold", options.det_threshold);
+        options.rec_threshold = parsed.value("rec_threshold", options.rec_threshold);
+        options.detector = detectorBackendFromName(parsed.value("detector", std::string("neural")));
+        options.priority = requestPriorityFromName(parsed.value("priority", std::string("interactive")));
+        options.det_half_res = parsed.value("det_half_res", options.det_half_res);
+        options.merge_fragments = parsed.value("merge_fragments", options.merge_fragments);
+        if (model_id) {
+            *model_id = parsed.value("model", std::string());
+        }
+    } catch (const nlohmann::json::exception& e) {
+        LOGW("Invalid OCR options: %s", e.what());
+        return false;
+    }
+    return true;
+}
+
+// Engine for a request: the registry model when one is named, else the
+// singleton. `holder` keeps a registry model loaded until the request ends.
+static OcrEngine* resolveEngine(const std::string& model_id, std::shared_ptr<OcrEngine>& holder) {
+    if (model_id.empty()) {
+        return &OcrEngine::GetInstance();
+    }
+    holder = ModelRegistry::GetInstance().AcquireOcr(model_id);
+    return holder.get();
+}
+
+static const char* MODEL_NOT_FOUND_ERROR =
+    "{\"error\":\"Model not registered or failed to load\",\"code\":\"MODEL_NOT_FOUND\"}";
+
+// Full OCR with per-request options (see parseOcrOptions). Same result JSON as
+// recognizeTextFromPath plus "detector", the backend that actually ran.
+extern "C" __attribute__((visibility("default")))
+char* recognizeTextFromPathWithOptions(const char* img_path, const char* options_json) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+
+        OcrOptions options;
+        std::string model_id;
+        if (!parseOcrOptions(options_json, options, &model_id)) {
+            return "{\"error\":\"Invalid options JSON\",\"code\":\"INVALID_JSON\"}";
+        }
+        RequestScope scope(options.priority);
+
+        cv::Mat image = cv::imread(img_path);
+        if (image.empty()) {
+            return "{\"error\":\"Could not load image\",\"code\":\"IMAGE_LOAD_FAILED\"}";
+        }
+
+        std::shared_ptr<OcrEngine> model;
+        OcrEngine* engine = resolveEngine(model_id, model);
+        if (!engine) {
+            return MODEL_NOT_FOUND_ERROR;
+        }
+        if (!engine->IsInitialized()) {
+            return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
+        }
+
+        DetectorBackend used = options.detector;
+        TextLines results = engine->RecognizeText(image, options, &used);
+
+        auto end = high_resolution_clock::now();
+        long long inference_time = duration_cast<milliseconds>(end - start).count();
+
+        std::ostringstream json;
+        json << "{\"results\":";
+        appendTextLinesJson(json, results);
+        json << ",";
+        json << "\"count\":" << results.size() << ",";
+        json << "\"inference_time_ms\":" << inference_time << ",";
+        json << "\"image_width\":" << image.cols << ",";
+        json << "\"image_height\":" << image.rows << ",";
+        json << "\"detector\":\"" << detectorBackendName(used) << "\"";
+        json << "}";
+
+        return json.str();
+    }).get().c_str());
+}
+
+// Detection only with per-request options. The classic backend needs no models.
+extern "C" __attribute__((visibility("default")))
+char* detectTextFromPathWithOptions(const char* img_path, const char* options_json) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+
+        OcrOptions options;
+        std::string model_id;
+        if (!parseOcrOptions(options_json, options, &model_id)) {
+            return "{\"error\":\"Invalid options JSON\",\"code\":\"INVALID_JSON\"}";
+        }
+        RequestScope scope(options.priority);
+
+        cv::Mat image = cv::imread(img_path);
+        if (image.empty()) {
+            return "{\"error\":\"Could not load image\",\"code\":\"IMAGE_LOAD_FAILED\"}";
+        }
+
+        std::shared_ptr<OcrEngine> model;
+        OcrEngine* engine = resolveEngine(model_id, model);
+        if (!engine) {
+            return MODEL_NOT_FOUND_ERROR;
+        }
+
+        // Merged here rather than in the engine, to keep each line's fragments
+        bool merge = options.merge_fragments;
+        options.merge_fragments = false;
+
+        DetectorBackend used = options.detector;
+        std::vector<TextBox> fragments = engine->DetectText(image, options, &used);
+        std::vector<MergedBox> boxes;
+        if (merge) {
+            boxes = mergeCollinearBoxes(fragments);
+        } else {
+            boxes.resize(fragments.size());
+            for (size_t i = 0; i < fragments.size(); i++) {
+                boxes[i].box = fragments[i];
+                boxes[i].fragments = {i};
+            }
+        }
+
+        auto end = high_resolution_clock::now();
+        long long inference_time = duration_cast<milliseconds>(end - start).count();
+
+        // Opens a box object; the caller closes it
+        auto append_box = [](std::ostringstream& json, const TextBox& box) {
+            json << "{\"points\":[";
+            for (size_t j = 0; j < box.points.size(); j++) {
+                json << "[" << std::fixed << std::setprecision(2) << box.points[j].x << ","
+                     << box.points[j].y << "]";
+                if (j < box.points.size() - 1) json << ",";
+            }
+            json << "],\"score\":" << std::setprecision(4) << box.score;
+        };
+
+        std::ostringstream json;
+        json << "{\"boxes\":[";
+
+        for (size_t i = 0; i < boxes.size(); i++) {
+            append_box(json, boxes[i].box);
+            // Merged lines list the detected boxes they were joined from
+            if (boxes[i].fragments.size() > 1) {
+                json << ",\"fragments\":[";
+                for (size_t f = 0; f < boxes[i].fragments.size(); f++) {
+                    append_box(json, fragments[boxes[i].fragments[f]]);
+                    json << "}";
+                    if (f < boxes[i].fragments.size() - 1) json << ",";
+                }
+                json << "]";
+            }
+            json << "}";
+            if (i < boxes.size() - 1) json << ",";
+        }
+
+        json << "],";
+        json << "\"count\":" << boxes.size() << ",";
+        json << "\"inference_time_ms\":" << inference_time << ",";
+        json << "\"image_width\":" << image.cols << ",";
+        json << "\"image_height\":" << image.rows << ",";
+        json << "\"detector\":\"" << detectorBackendName(used) << "\"";
+        json << "}";
+
+        return json.str();
+    }).get().c_str());
+}
+
+// ========================
+// Field Query Functions
+// ========================
+
+// Parse a field query:
+// {"fields":[{"name":"total","pattern":"[0-9][0-9,.]*","anchors":["總計","Total"],
+//             "relation":"right","region":"bottom_half","min_score":0.9}, ...],
+//  "min_score":0.8,"max_errors":1, ...OCR options (see parseOcrOptions)}
+// "region" is a name (see fieldRegionFromName) or [left, top, right, bottom] fractions.
+static bool parseFieldQuery(const char* query_json, FieldQuery& query, std::string& error) {
+    nlohmann::json parsed = nlohmann::json::parse(query_json ? query_json : "", nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_object() || !parsed.contains("fields") || !parsed["fields"].is_array()) {
+        error = "Field query needs a \"fields\" array";
+        return false;
+    }
+    // value() throws on a wrongly typed field; report it like any bad query
+    try {
+        query.min_score = parsed.value("min_score", query.min_score);
+        query.max_errors = std::max(0, parsed.value("max_errors", query.max_errors));
+
+        for (const auto& item : parsed["fields"]) {
+            if (!item.is_object()) {
+                error = "Field entries must be objects";
+                return false;
+            }
+            FieldSpec spec;
+            spec.name = item.value("name", std::string());
+            if (spec.name.empty()) {
+                error = "Field without a name";
+                return false;
+            }
+
+            std::string pattern = item.value("pattern", std::string());
+            if (!pattern.empty()) {
+                try {
+                    spec.pattern = std::regex(pattern, std::regex::ECMAScript | std::regex::optimize);
+                    spec.has_pattern = true;
+                } catch (const std::regex_error&) {
+                    error = "Invalid pattern for field " + spec.name;
+                    return false;
+                }
+            }
+
+            auto anchors = item.find("anchors");
+            if (anchors != item.end() && anchors->is_array()) {
+                for (const auto& anchor : *anchors) {
+                    if (anchor.is_string() && !anchor.get_ref<const std::string&>().empty()) {
+                        spec.anchors.push_back(anchor.get<std::string>());
+                    }
+                }
+            }
+            spec.relation = fieldRelationFromName(item.value("relation", std::string("right")));
+
+            auto region = item.find("region");
+            if (region != item.end() && region->is_string()) {
+                if (!fieldRegionFromName(region->get<std::string>(), spec.region)) {
+                    error = "Unknown region for field " + spec.name;
+                    return false;
+                }
+                spec.has_region = true;
+            } else if (region != item.end() && region->is_array() && region->size() == 4 &&
+                       std::all_of(region->begin(), region->end(), [](const nlohmann::json& v) { return v.is_number(); })) {
+                float left = (*region)[0].get<float>(), top = (*region)[1].get<float>();
+                float right = (*region)[2].get<float>(), bottom = (*region)[3].get<float>();
+                spec.region = cv::Rect2f(left, top, right - left, bottom - top);
+                spec.has_region = spec.region.width > 0.0f && spec.region.height > 0.0f;
+            }
+
+            if (!spec.has_pattern && spec.anchors.empty()) {
+                error = "Field " + spec.name + " needs a pattern or anchors";
+                return false;
+            }
+            spec.min_score = item.value("min_score", 0.0f);
+            query.fields.push_back(std::move(spec));
+        }
+    } catch (const nlohmann::json::exception& e) {
+        error = std::string("Invalid field query: ") + e.what();
+        return false;
+    }
+    return true;
+}
+
+// Recognize only as much of the page as it takes to resolve the requested
+// fields. Result: {"fields":{"<name>":{"text","line","score","x1","y1","x2","y2"} or null},
+// "complete", "detected_boxes", "recognized_boxes", "rec_rounds", "inference_time_ms"}
+extern "C" __attribute__((visibility("default")))
+char* queryFieldsFromPath(const char* img_path, const char* query_json) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+
+        FieldQuery query;
+        std::string error;
+        if (!parseFieldQuery(query_json, query, error)) {
+            std::ostringstream json;
+            json << "{\"error\":";
+            appendJsonString(json, error);
+            json << ",\"code\":\"INVALID_FIELD_QUERY\"}";
+            return json.str();
+        }
+        OcrOptions options;
+        std::string model_id;
+        if (!parseOcrOptions(query_json, options, &model_id)) {
+            return "{\"error\":\"Invalid options JSON\",\"code\":\"INVALID_JSON\"}";
+        }
+        RequestScope scope(options.priority);
+
+        cv::Mat image = cv::imread(img_path);
+        if (image.empty()) {
+            return "{\"error\":\"Could not load image\",\"code\":\"IMAGE_LOAD_FAILED\"}";
+        }
+
+        std::shared_ptr<OcrEngine> model;
+        OcrEngine* engine = resolveEngine(model_id, model);
+        if (!engine) {
+            return MODEL_NOT_FOUND_ERROR;
+        }
+        if (!engine->IsInitialized()) {
+            return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
+        }
+
+        FieldQueryResult result = queryFields(*engine, image, query, options);
+
+        auto end = high_resolution_clock::now();
+        long long inference_time = duration_cast<milliseconds>(end - start).count();
+
+        std::ostringstream json;
+        json << "{\"fields\":{";
+        for (size_t f = 0; f < query.fields.size(); f++) {
+            const FieldValue& value = result.values[f];
+            appendJsonString(json, query.fields[f].name);
+            json << ":";
+            if (!value.found) {
+                json << "null";
+            } else {
+                json << "{\"text\":";
+                appendJsonString(json, value.text);
+                json << ",\"line\":";
+                appendJsonString(json, value.line);
+                json << ",\"score\":" << std::fixed << std::setprecision(4) << value.score;
+                json << std::setprecision(1);
+                json << ",\"x1\":" << value.x1 << ",\"y1\":" << value.y1;
+                json << ",\"x2\":" << value.x2 << ",\"y2\":" << value.y2 << "}";
+            }
+            if (f < query.fields.size() - 1) json << ",";
+        }
+        json << "},";
+        json << "\"complete\":" << (result.complete ? "true" : "false") << ",";
+        json << "\"detected_boxes\":" << result.detected << ",";
+        json << "\"recognized_boxes\":" << result.recognized << ",";
+        json << "\"rec_rounds\":" << result.rounds << ",";
+        json << "\"inference_time_ms\":" << inference_time;
+        json << "}";
+        return json.str();
+    }).get().c_str());
+}
+
+// ========================
+// Template Functions
+// ========================
+
+// Register a known form from a reference scan. fields_json:
+// [{"name":"invoice_no","roi":[x1,y1,x2,y2]}, ...] in reference image pixels.
+extern "C" __attribute__((visibility("default")))
+char* registerTemplate(const char* template_id, const char* reference_path, const char* fields_json) {
+    nlohmann::json parsed = nlohmann::json::parse(fields_json ? fields_json : "", nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_array()) {
+        return strdup("{\"error\":\"Template fields must be a JSON array\",\"code\":\"INVALID_TEMPLATE_FIELDS\"}");
+    }
+    std::vector<TemplateField> fields;
+    for (const auto& item : parsed) {
+        auto roi = item.is_object() ? item.find("roi") : item.end();
+        auto name = item.is_object() ? item.find("name") : item.end();
+        if (!item.is_object() || name == item.end() || !name->is_string() ||
+            name->get_ref<const std::string&>().empty() || roi == item.end() ||
+            !roi->is_array() || roi->size() != 4 ||
+            !std::all_of(roi->begin(), roi->end(), [](const nlohmann::json& v) { return v.is_number(); })) {
+            return strdup("{\"error\":\"Template fields need a name and a [x1,y1,x2,y2] roi\","
+                          "\"code\":\"INVALID_TEMPLATE_FIELDS\"}");
+        }
+        TemplateField field;
+        field.name = name->get<std::string>();
+        float x1 = (*roi)[0].get<float>(), y1 = (*roi)[1].get<float>();
+        float x2 = (*roi)[2].get<float>(), y2 = (*roi)[3].get<float>();
+        field.roi = cv::Rect2f(x1, y1, x2 - x1, y2 - y1);
+        if (field.roi.width <= 0.0f || field.roi.height <= 0.0f) {
+            return strdup("{\"error\":\"Template field roi is empty\",\"code\":\"INVALID_TEMPLATE_FIELDS\"}");
+        }
+        fields.push_back(std::move(field));
+    }
+
+    cv::Mat reference = cv::imread(reference_path);
+    if (reference.empty()) {
+        return strdup("{\"error\":\"Could not load image\",\"code\":\"IMAGE_LOAD_FAILED\"}");
+    }
+    if (!TemplateRegistry::GetInstance().Register(template_id, reference, fields)) {
+        return strdup("{\"error\":\"Reference image has too few features to align against\","
+                      "\"code\":\"TEMPLATE_REJECTED\"}");
+    }
+    return strdup("{\"registered\":true}");
+}
+
+extern "C" __attribute__((visibility("default")))
+int unregisterTemplate(const char* template_id) {
+    return TemplateRegistry::GetInstance().Unregister(template_id) ? 1 : 0;
+}
+
+// Registered templates with their anchor counts and matches so far
+extern "C" __attribute__((visibility("default")))
+char* listTemplates() {
+    std::vector<TemplateInfo> templates = TemplateRegistry::GetInstance().List();
+    std::ostringstream json;
+    json << "{\"templates\":[";
+    for (size_t i = 0; i < templates.size(); i++) {
+        const TemplateInfo& t = templates[i];
+        json << "{\"id\":";
+        appendJsonString(json, t.id);
+        json << ",\"width\":" << t.width << ",\"height\":" << t.height << ",";
+        json << "\"anchors\":" << t.anchors << ",";
+        json << "\"fields\":" << t.fields << ",";
+        json << "\"matches\":" << t.matches << "}";
+        if (i < templates.size() - 1) {
+            json << ",";
+        }
+    }
+    json << "]}";
+    return strdup(json.str().c_str());
+}
+
+// OCR a page against the registered templates. Options: OCR options (see
+// parseOcrOptions) plus {"max_edge_distance":0.3,"max_region_distance":0.25,
+// "min_inliers":15,"max_aspect_ratio":1.15}. A matched page returns
+// {"matched":true,"template","fields":{"<name>":{"text","score","points"} or null}, ...};
+// anything else returns "matched":false with the full-page "results" and "detector".
+extern "C" __attribute__((visibility("default")))
+char* recognizeWithTemplates(const char* img_path, const char* options_json) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+
+        OcrOptions options;
+        std::string model_id;
+        if (!parseOcrOptions(options_json, options, &model_id)) {
+            return "{\"error\":\"Invalid options JSON\",\"code\":\"INVALID_JSON\"}";
+        }
+        TemplateMatchOptions match;
+        if (options_json && *options_json) {
+            nlohmann::json parsed = nlohmann::json::parse(options_json, nullptr, false);
+            try {
+                match.max_edge_distance = parsed.value("max_edge_distance", match.max_edge_distance);
+                match.max_region_distance = parsed.value("max_region_distance", match.max_region_distance);
+                match.min_inliers = std::max(4, parsed.value("min_inliers", match.min_inliers));
+                match.max_aspect_ratio = parsed.value("max_aspect_ratio", match.max_aspect_ratio);
+            } catch (const nlohmann::json::exception& e) {
+                LOGW("Invalid template match options: %s", e.what());
+                return "{\"error\":\"Invalid options JSON\",\"code\":\"INVALID_JSON\"}";
+            }
+        }
+        RequestScope scope(options.priority);
+
+        cv::Mat image = cv::imread(img_path);
+        if (image.empty()) {
+            return "{\"error\":\"Could not load image\",\"code\":\"IMAGE_LOAD_FAILED\"}";
+        }
+
+        std::shared_ptr<OcrEngine> model;
+        OcrEngine* engine = resolveEngine(model_id, model);
+        if (!engine) {
+            return MODEL_NOT_FOUND_ERROR;
+        }
+        if (!engine->IsInitialized()) {
+            return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
+        }
+
+        TemplateOcrResult result = TemplateRegistry::GetInstance().Recognize(*engine, image, options, match);
+
+        auto end = high_resolution_clock::now();
+        long long inference_time = duration_cast<milliseconds>(end - start).count();
+
+        std::ostringstream json;
+        json << "{\"matched\":" << (result.matched ? "true" : "false") << ",";
+        if (result.matched) {
+            json << "\"template\":";
+            appendJsonString(json, result.template_id);
+            json << ",\"fields\":{";
+            for (size_t f = 0; f < result.fields.size(); f++) {
+                const TemplateFieldValue& value = result.fields[f];
+                appendJsonString(json, value.name);
+                json << ":";
+                if (!value.found) {
+                    json << "null";
+                } else {
+                    json << "{\"text\":";
+                    appendJsonString(json, value.text);
+                    json << ",\"score\":" << std::fixed << std::setprecision(4) << value.score;
+                    json << ",\"points\":[";
+                    for (size_t j = 0; j < value.points.size(); j++) {
+                        json << "[" << std::setprecision(1) << value.points[j].x << "," << value.points[j].y << "]";
+                        if (j < value.points.size() - 1) json << ",";
+                    }
+                    json << "]}";
+                }
+                if (f < result.fields.size() - 1) json << ",";
+            }
+            json << "},";
+        } else {
+            json << "\"results\":";
+            appendTextLinesJson(json, result.lines);
+            json << ",\"count\":" << result.lines.size() << ",";
+            json << "\"detector\":\"" << detectorBackendName(result.detector) << "\",";
+        }
+        json << "\"edge_distance\":" << std::fixed << std::setprecision(4) << result.edge_distance << ",";
+        json << "\"region_distance\":" << result.region_distance << ",";
+        json << "\"inliers\":" << result.inliers << ",";
+        json << "\"inference_time_ms\":" << inference_time << ",";
+        json << "\"image_width\":" << image.cols << ",";
+        json << "\"image_height\":" << image.rows;
+        json << "}";
+        return json.str();
+    }).get().c_str());
+}
+
+// ========================
+// Page Cache Functions
+// ========================
+
+static const char* PAGE_NOT_FOUND_ERROR =
+    "{\"error\":\"Page closed or evicted, open it again\",\"code\":\"PAGE_NOT_FOUND\"}";
+
+// Result JSON of recognizeTextFromPathWithOptions plus the page handle and
+// how many box reads came from the cache
+static std::string pageResultJson(int page, const PageInfo& info, const TextLines& results,
+                                  const PageOcrStats& stats, long long inference_time) {
+    std::ostringstream json;
+    json << "{\"page\":" << page << ",";
+    json << "\"results\":";
+    appendTextLinesJson(json, results);
+    json << ",";
+    json << "\"count\":" << results.size() << ",";
+    json << "\"boxes\":" << stats.boxes << ",";
+    json << "\"reused\":" << stats.reused << ",";
+    json << "\"recognized\":" << stats.recognized << ",";
+    json << "\"failed\":" << stats.failed << ",";
+    json << "\"inference_time_ms\":" << inference_time << ",";
+    json << "\"image_width\":" << info.width << ",";
+    json << "\"image_height\":" << info.height << ",";
+    json << "\"detector\":\"" << detectorBackendName(info.detector) << "\"";
+    json << "}";
+    return json.str();
+}
+
+// Decode and detect a page once, keep it, and OCR it with these options
+// (see parseOcrOptions). "model" and "detector" are fixed for the page.
+extern "C" __attribute__((visibility("default")))
+char* openOcrPage(const char* img_path, const char* options_json) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+
+        OcrOptions options;
+        std::string model_id;
+        if (!parseOcrOptions(options_json, options, &model_id)) {
+            return "{\"error\":\"Invalid options JSON\",\"code\":\"INVALID_JSON\"}";
+        }
+        RequestScope scope(options.priority);
+
+        cv::Mat image = cv::imread(img_path);
+        if (image.empty()) {
+            return "{\"error\":\"Could not load image\",\"code\":\"IMAGE_LOAD_FAILED\"}";
+        }
+
+        std::shared_ptr<OcrEngine> model;
+        OcrEngine* engine = resolveEngine(model_id, model);
+        if (!engine) {
+            return MODEL_NOT_FOUND_ERROR;
+        }
+        if (!engine->IsInitialized()) {
+            return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
+        }
+
+        PageCache& cache = PageCache::GetInstance();
+        int page = cache.Open(*engine, image, options, model_id);
+        PageInfo info;
+        if (page == 0 || !cache.Info(page, info)) {
+            return "{\"error\":\"Detection failed\",\"code\":\"DETECTION_FAILED\"}";
+        }
+        TextLines results;
+        PageOcrStats stats;
+        if (!cache.Recognize(page, *engine, options, results, &stats)) {
+            return PAGE_NOT_FOUND_ERROR;
+        }
+
+        auto end = high_resolution_clock::now();
+        return pageResultJson(page, info, results, stats, duration_cast<milliseconds>(end - start).count());
+    }).get().c_str());
+}
+
+// Re-run an open page at new thresholds: DB post-processing on the cached
+// map, rec only for boxes not read before. "model" and "detector" are ignored.
+extern "C" __attribute__((visibility("default")))
+char* recognizeOcrPage(int page, const char* options_json) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+
+        OcrOptions options;
+        if (!parseOcrOptions(options_json, options)) {
+            return "{\"error\":\"Invalid options JSON\",\"code\":\"INVALID_JSON\"}";
+        }
+        RequestScope scope(options.priority);
+
+        PageCache& cache = PageCache::GetInstance();
+        PageInfo info;
+        if (!cache.Info(page, info)) {
+            return PAGE_NOT_FOUND_ERROR;
+        }
+        std::shared_ptr<OcrEngine> model;
+        OcrEngine* engine = resolveEngine(info.model_id, model);
+        if (!engine) {
+            return MODEL_NOT_FOUND_ERROR;
+        }
+        if (!engine->IsInitialized()) {
+            return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
+        }
+
+        TextLines results;
+        PageOcrStats stats;
+        if (!cache.Recognize(page, *engine, options, results, &stats)) {
+            return PAGE_NOT_FOUND_ERROR;
+        }
+
+        auto end = high_resolution_clock::now();
+        return pageResultJson(page, info, results, stats, duration_cast<milliseconds>(end - start).count());
+    }).get().c_str());
+}
+
+extern "C" __attribute__((visibility("default")))
+int closeOcrPage(int page) {
+    return PageCache::GetInstance().Close(page) ? 1 : 0;
+}
+
+extern "C" __attribute__((visibility("default")))
+void closeAllOcrPages() {
+    PageCache::GetInstance().CloseAll();
+}
+
+// Memory allowed for open pages (images, det maps, cached reads); 0 = unlimited
+extern "C" __attribute__((visibility("default")))
+void setPageCacheBudget(int budget_mb) {
+    PageCache::GetInstance().SetMemoryBudget(static_cast<size_t>(std::max(budget_mb, 0)) * 1024 * 1024);
+}
+
+extern "C" __attribute__((visibility("default")))
+char* getPageCacheStats() {
+    PageCacheStats stats = PageCache::GetInstance().Stats();
+    std::ostringstream json;
+    json << "{\"pages\":" << stats.pages << ",";
+    json << "\"bytes\":" << stats.bytes << ",";
+    json << "\"budget_bytes\":" << stats.budget << ",";
+    json << "\"opens\":" << stats.opens << ",";
+    json << "\"evictions\":" << stats.evictions << ",";
+    json << "\"reused\":" << stats.reused << ",";
+    json << "\"recognized\":" << stats.recognized << "}";
+    return strdup(json.str().c_str());
+}
+
+// ========================
+// Rec Cascade Functions
+// ========================
+
+// Re-read unsure lines with a second, more accurate rec model (e.g. the server
+// model behind the mobile one). Options: {"min_mean_score":0.9,"min_char_score":0.5};
+// a line escalates when its mean character probability or its least probable
+// character falls below these. Needs initOcrModels first.
+extern "C" __attribute__((visibility("default")))
+char* enableRecCascade(const char* rec_model_path, const char* options_json) {
+    RecCascadeConfig config;
+    if (options_json && *options_json) {
+        nlohmann::json parsed = nlohmann::json::parse(options_json, nullptr, false);
+        if (parsed.is_discarded() || !parsed.is_object()) {
+            return strdup("{\"error\":\"Invalid cascade options JSON\",\"code\":\"INVALID_JSON\"}");
+        }
+        config.min_mean_score = parsed.value("min_mean_score", config.min_mean_score);
+        config.min_char_score = parsed.value("min_char_score", config.min_char_score);
+    }
+
+    OcrEngine& engine = OcrEngine::GetInstance();
+    if (!engine.IsInitialized()) {
+        return strdup("{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}");
+    }
+    if (!engine.EnableRecCascade(std::string(rec_model_path), config)) {
+        LOGE("Rec cascade model rejected: %s", rec_model_path);
+        return strdup("{\"error\":\"Cascade model failed to load or its vocabulary differs\","
+                      "\"code\":\"CASCADE_LOAD_FAILED\"}");
+    }
+    LOGI("Rec cascade enabled");
+    return strdup("{\"enabled\":true}");
+}
+
+extern "C" __attribute__((visibility("default")))
+void disableRecCascade() {
+    OcrEngine::GetInstance().DisableRecCascade();
+}
+
+// Lines read, escalated to the accurate model, and changed by it
+extern "C" __attribute__((visibility("default")))
+char* getRecCascadeStats() {
+    OcrEngine& engine = OcrEngine::GetInstance();
+    RecCascadeStats stats = engine.CascadeStats();
+    double rate = stats.lines > 0 ? static_cast<double>(stats.escalated) / stats.lines : 0.0;
+
+    std::ostringstream json;
+    json << "{\"enabled\":" << (engine.RecCascadeEnabled() ? "true" : "false") << ",";
+    json << "\"lines\":" << stats.lines << ",";
+    json << "\"escalated\":" << stats.escalated << ",";
+    json << "\"changed\":" << stats.changed << ",";
+    json << "\"escalation_rate\":" << std::fixed << std::setprecision(4) << rate << ",";
+    json << "\"escalation_ms\":" << std::setprecision(3) << stats.escalation_us / 1000.0 << "}";
+    return strdup(json.str().c_str());
+}
+
+extern "C" __attribute__((visibility("default")))
+void resetRecCascadeStats() {
+    OcrEngine::GetInstance().ResetCascadeStats();
+}
+
+// ========================
+// Scheduler Functions
+// ========================
+
+static void appendPriorityStatsJson(std::ostringstream& json, const PriorityClassStats& stats) {
+    double mean_wait_ms = stats.stages > 0 ? stats.total_wait_us / 1000.0 / stats.stages : 0.0;
+    json << "{\"in_flight\":" << stats.in_flight << ",";
+    json << "\"queue_depth\":" << stats.waiting << ",";
+    json << "\"peak_queue_depth\":" << stats.peak_waiting << ",";
+    json << "\"requests\":" << stats.requests << ",";
+    json << "\"stages\":" << stats.stages << ",";
+    json << "\"mean_wait_ms\":" << std::fixed << std::setprecision(3) << mean_wait_ms << ",";
+    json << "\"max_wait_ms\":" << stats.max_wait_us / 1000.0 << "}";
+}
+
+// Queue depth and stage wait times per priority class, plus task scheduler counters
+extern "C" __attribute__((visibility("default")))
+char* getOcrSchedulerStats() {
+    RequestScheduler& scheduler = RequestScheduler::GetInstance();
+    std::ostringstream json;
+    json << "{";
+    for (int p = 0; p < REQUEST_PRIORITY_COUNT; p++) {
+        RequestPriority priority = static_cast<RequestPriority>(p);
+        json << "\"" << requestPriorityName(priority) << "\":";
+        appendPriorityStatsJson(json, scheduler.Stats(priority));
+        json << ",";
+    }
+    TaskSchedulerStats tasks = TaskScheduler::GetInstance().Stats();
+    json << "\"tasks\":{\"threads\":" << tasks.threads << ",";
+    json << "\"running\":" << (tasks.running ? "true" : "false") << ",";
+    json << "\"executed\":" << tasks.executed << ",";
+    json << "\"stolen\":" << tasks.stolen << ",";
+    json << "\"helped\":" << tasks.helped << "}";
+    json << "}";
+    return strdup(json.str().c_str());
+}
+
+// Restart the counters (queue depth and in-flight gauges are kept)
+extern "C" __attribute__((visibility("default")))
+void resetOcrSchedulerStats() {
+    RequestScheduler::GetInstance().ResetStats();
+}
+
+// ========================
+// PDF Functions
+// ========================
+
+// Parse PDF options: the OCR options (see parseOcrOptions, "model" included) plus
+// {"first_page":0,"page_count":-1,"use_text_layer":true,"min_text_chars":16,"render_long_side":1920}
+static bool parsePdfOptions(const char* options_json, PdfOcrOptions& options, std::string* model_id) {
+    if (!parseOcrOptions(options_json, options.ocr, model_id)) {
+        return false;
+    }
+    if (!options_json || !*options_json) {
+        return true;
+    }
+    nlohmann::json parsed = nlohmann::json::parse(options_json, nullptr, false);
+    options.first_page = parsed.value("first_page", options.first_page);
+    options.page_count = parsed.value("page_count", options.page_count);
+    options.use_text_layer = parsed.value("use_text_layer", options.use_text_layer);
+    options.min_text_chars = parsed.value("min_text_chars", options.min_text_chars);
+    options.render_long_side = std::max(256, parsed.value("render_long_side", options.render_long_side));
+    return true;
+}
+
+// Error JSON for a failed recognizePdf, empty when it succeeded
+static std::string pdfStatusError(PdfStatus status) {
+    switch (status) {
+        case PdfStatus::kOk:
+            return "";
+        case PdfStatus::kUnsupported:
+            return "{\"error\":\"PDF support not built in\",\"code\":\"PDF_UNSUPPORTED\"}";
+        case PdfStatus::kPasswordRequired:
+            return "{\"error\":\"PDF password required\",\"code\":\"PDF_PASSWORD_REQUIRED\"}";
+        default:
+            return "{\"error\":\"Could not load PDF\",\"code\":\"PDF_LOAD_FAILED\"}";
+    }
+}
+
+static void appendPdfStatsJson(std::ostringstream& json, const PdfOcrStats& stats) {
+    json << "\"document_pages\":" << stats.document_pages << ",";
+    json << "\"pages_text_layer\":" << stats.pages_text_layer << ",";
+    json << "\"pages_ocr\":" << stats.pages_ocr << ",";
+}
+
+// Recognize a PDF. Pages with a usable text layer are read directly (no det/rec);
+// image-only pages are rasterized and OCR'd. Boxes are in points, origin top-left.
+extern "C" __attribute__((visibility("default")))
+char* recognizeTextFromPdf(const char* pdf_path, const char* password, const char* options_json) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+
+        PdfOcrOptions options;
+        std::string model_id;
+        if (!parsePdfOptions(options_json, options, &model_id)) {
+            return "{\"error\":\"Invalid options JSON\",\"code\":\"INVALID_JSON\"}";
+        }
+        RequestScope scope(options.ocr.priority);
+
+        // Held for the whole document, so unregistering mid-way can't pull it
+        std::shared_ptr<OcrEngine> model;
+        OcrEngine* engine = resolveEngine(model_id, model);
+        if (!engine) {
+            return MODEL_NOT_FOUND_ERROR;
+        }
+
+        std::ostringstream pages;
+        bool first = true;
+        PdfOcrStats stats;
+        PdfStatus status = recognizePdf(*engine, pdf_path, password ? password : "", options,
+            [&](const PdfPageResult& page) {
+                if (!first) {
+                    pages << ",";
+                }
+                first = false;
+                pages << "{\"page\":" << page.page << ",";
+                pages << "\"width\":" << std::fixed << std::setprecision(2) << page.width_pt << ",";
+                pages << "\"height\":" << page.height_pt << ",";
+                pages << "\"source\":\"" << pdfPageSourceName(page.source) << "\",";
+                pages << "\"dpi\":" << std::setprecision(1) << page.dpi << ",";
+                pages << "\"time_ms\":" << page.time_ms << ",";
+                pages << "\"results\":";
+                appendTextLinesJson(pages, page.lines);
+                pages << "}";
+            }, &stats);
+
+        std::string error = pdfStatusError(status);
+        if (!error.empty()) {
+            return error;
+        }
+
+        auto end = high_resolution_clock::now();
+        long long inference_time = duration_cast<milliseconds>(end - start).count();
+
+        std::ostringstream json;
+        json << "{\"pages\":[" << pages.str() << "],";
+        appendPdfStatsJson(json, stats);
+        json << "\"inference_time_ms\":" << inference_time << "}";
+        return json.str();
+    }).get().c_str());
+}
+
+// Recognize a PDF straight into a result store, one page at a time, so
+// documents of any length run in constant memory. Sources are "<path>#<page>".
+extern "C" __attribute__((visibility("default")))
+char* resultStoreRecognizePdf(const char* store_path, const char* pdf_path, const char* password,
+                              const char* options_json) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+
+        PdfOcrOptions options;
+        options.ocr.priority = RequestPriority::kBackground;
+        std::string model_id;
+        if (!parsePdfOptions(options_json, options, &model_id)) {
+            return "{\"error\":\"Invalid options JSON\",\"code\":\"INVALID_JSON\"}";
+        }
+        RequestScope scope(options.ocr.priority);
+
+        std::shared_ptr<OcrEngine> model;
+        OcrEngine* engine = resolveEngine(model_id, model);
+        if (!engine) {
+            return MODEL_NOT_FOUND_ERROR;
+        }
+
+        std::shared_ptr<ResultStore> store = ResultStore::Get(store_path);
+        long long first_page = -1;
+        size_t added = 0;
+        PdfOcrStats stats;
+        std::string source_prefix = std::string(pdf_path) + "#";
+
+        PdfStatus status = recognizePdf(*engine, pdf_path, password ? password : "", options,
+            [&](const PdfPageResult& page) {
+                uint32_t stored = store->AppendPage(source_prefix + std::to_string(page.page),
+                                                   static_cast<int>(page.width_pt + 0.5f),
+                                                   static_cast<int>(page.height_pt + 0.5f), page.lines);
+                if (first_page < 0) {
+                    first_page = stored;
+                }
+                added++;
+            }, &stats);
+
+        std::string error = pdfStatusError(status);
+        if (!error.empty()) {
+            return error;
+        }
+
+        bool flushed = store->Flush();
+
+        auto end = high_resolution_clock::now();
+        long long inference_time = duration_cast<milliseconds>(end - start).count();
+
+        std::ostringstream json;
+        json << "{\"added\":" << added << ",";
+        json << "\"first_page\":" << first_page << ",";
+        json << "\"flushed\":" << (flushed ? "true" : "false") << ",";
+        json << "\"failed\":[],";
+        appendPdfStatsJson(json, stats);
+        json << "\"inference_time_ms\":" << inference_time << "}";
+        return json.str();
+    }).get().c_str());
+}
+
+// ========================
+// Model Registry Functions
+// ========================
+
+// Register an OCR model set under `model_id`; it loads on first use
+extern "C" __attribute__((visibility("default")))
+void registerOcrModel(const char* model_id, const char* det_model_path, const char* rec_model_path,
+                      const char* dict_path) {
+    ModelSpec spec;
+    spec.kind = ModelKind::kOcr;
+    spec.det_model_path = det_model_path;
+    spec.rec_model_path = rec_model_path;
+    spec.dict_path = dict_path;
+    ModelRegistry::GetInstance().Register(model_id, spec);
+}
+
+// Register a layout model (PP-DocLayout M or L) under `model_id`
+extern "C" __attribute__((visibility("default")))
+void registerLayoutModel(const char* model_id, const char* model_path) {
+    ModelSpec spec;
+    spec.kind = ModelKind::kLayout;
+    spec.layout_model_path = model_path;
+    ModelRegistry::GetInstance().Register(model_id, spec);
+}
+
+extern "C" __attribute__((visibility("default")))
+int unregisterModel(const char* model_id) {
+    return ModelRegistry::GetInstance().Unregister(model_id) ? 1 : 0;
+}
+
+// Resident memory allowed for registry models; 0 = unlimited
+extern "C" __attribute__((visibility("default")))
+void setModelMemoryBudget(int budget_mb) {
+    ModelRegistry::GetInstance().SetMemoryBudget(static_cast<size_t>(std::max(budget_mb, 0)) * 1024 * 1024);
+}
+
+// Unload every registry model not serving a request
+extern "C" __attribute__((visibility("default")))
+void unloadModels() {
+    ModelRegistry::GetInstance().UnloadAll();
+}
+
+// Budget, resident total and per-model load state
+extern "C" __attribute__((visibility("default")))
+char* getModelRegistryStatus() {
+    ModelRegistry& registry = ModelRegistry::GetInstance();
+    std::vector<ModelStatus> models = registry.Status();
+    std::ostringstream json;
+    json << "{\"budget_bytes\":" << registry.MemoryBudget() << ",";
+    json << "\"resident_bytes\":" << registry.ResidentBytes() << ",";
+    json << "\"models\":[";
+    for (size_t i = 0; i < models.size(); i++) {
+        const ModelStatus& m = models[i];
+        json << "{\"id\":";
+        appendJsonString(json, m.id);
+        json << ",\"kind\":\"" << modelKindName(m.kind) << "\",";
+        json << "\"loaded\":" << (m.loaded ? "true" : "false") << ",";
+        json << "\"in_use\":" << (m.in_use ? "true" : "false") << ",";
+        json << "\"resident_bytes\":" << m.resident_bytes << ",";
+        json << "\"loads\":" << m.loads << ",";
+        json << "\"hits\":" << m.hits << ",";
+        json << "\"evictions\":" << m.evictions << "}";
+        if (i < models.size() - 1) {
+            json << ",";
+        }
+    }
+    json << "]}";
+    return strdup(json.str().c_str());
+}
+
+// detectLayout with a registry layout model
+extern "C" __attribute__((visibility("default")))
+char* detectLayoutWithModel(const char* model_id, const char* img_path, float conf_threshold) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        auto start = high_resolution_clock::now();
+
+        cv::Mat image = cv::imread(img_path);
+        if (image.empty()) {
+            return "{\"error\":\"Could not load image\",\"code\":\"IMAGE_LOAD_FAILED\"}";
+        }
+
+        std::shared_ptr<LayoutModel> model = ModelRegistry::GetInstance().AcquireLayout(model_id);
+        if (!model) {
+            return MODEL_NOT_FOUND_ERROR;
+        }
+        std::vector<DetectionBox> results = model->Detect(image, conf_threshold);
+
+        auto end = high_resolution_clock::now();
+        long long inference_time = duration_cast<milliseconds>(end - start).count();
+        return layoutResultJson(results, inference_time, image);
+    }).get().c_str());
+}
+
+// Replay a golden corpus against the loaded engine. options_json (optional):
+// {"iterations":3,"match_iou":0.5,"max_cer":0.01,"min_recall":0.98,"kernel_max_error":1e-4,
+//  "det_half_res":false}
+extern "C" __attribute__((visibility("default")))
+char* runGoldenCorpus(const char* manifest_path, const char* options_json) {
+    return strdup(std::async(std::launch::async, [=]() -> std::string {
+        OcrEngine& engine = OcrEngine::GetInstance();
+        if (!engine.IsInitialized()) {
+            return "{\"error\":\"OCR engine not initialized\",\"code\":\"ENGINE_NOT_INITIALIZED\"}";
+        }
+
+        GoldenCorpus corpus;
+        if (!loadGoldenCorpus(manifest_path, corpus)) {
+            return "{\"error\":\"Could not load golden corpus\",\"code\":\"CORPUS_LOAD_FAILED\"}";
+        }
+
+        GoldenTolerance tolerance;
+        int iterations = 1;
+        bool det_half_res = false;
+        if (options_json != nullptr && options_json[0] != '\0') {
+            nlohmann::json options = nlohmann::json::parse(options_json, nullptr, false);
+            if (options.is_object()) {
+                try {
+                    iterations = options.value("iterations", iterations);
+                    tolerance.match_iou = options.value("match_iou", tolerance.match_iou);
+                    tolerance.max_cer = options.value("max_cer", tolerance.max_cer);
+                    tolerance.min_recall = options.value("min_recall", tolerance.min_recall);
+                    tolerance.kernel_max_error = options.value("kernel_max_error", tolerance.kernel_max_error);
+                    det_half_res = options.value("det_half_res", det_half_res);
+                } catch (const nlohmann::json::exception& e) {
+                    LOGW("Invalid golden corpus options: %s", e.what());
+                    return "{\"error\":\"Invalid options JSON\",\"code\":\"INVALID_JSON\"}";
+                }
+            }
+        }
+
+        try {
+            return goldenReportToJson(runGoldenCorpus(engine, corpus, tolerance, iterations, det_half_res));
+        } catch (const std::exception& e) {
+            LOGE("runGoldenCorpus failed: %s", e.what());
+            return "{\"error\":\"Golden corpus run failed\",\"code\":\"CORPUS_RUN_FAILED\"}";
+        }
+    }).get().c_str());
+}
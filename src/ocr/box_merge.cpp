@@ -0,0 +1,156 @@
+#include "include/box_merge.h"
+#include "include/ocr_log.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+static const float MERGE_MAX_BOX_ANGLE = 10.0f;  // Steeper boxes are never merged
+static const float MERGE_MAX_OVERLAP = 0.25f;    // Fragments may overlap by this much of a line height
+
+// One box measured along its own text direction (points TL, TR, BR, BL)
+struct Fragment {
+    float angle = 0.0f;   // Of the top edge, degrees
+    float width = 0.0f;
+    float height = 0.0f;
+    float left_x = 0.0f;
+    float right_x = 0.0f;
+    cv::Point2f baseline_left;
+    cv::Point2f baseline_right;
+    bool mergeable = false;
+};
+
+static Fragment measureFragment(const TextBox& box) {
+    const auto& p = box.points;
+    Fragment f;
+    f.angle = static_cast<float>(std::atan2(p[1].y - p[0].y, p[1].x - p[0].x) * 180.0 / CV_PI);
+    f.width = static_cast<float>((cv::norm(p[1] - p[0]) + cv::norm(p[2] - p[3])) / 2.0);
+    f.height = static_cast<float>((cv::norm(p[3] - p[0]) + cv::norm(p[2] - p[1])) / 2.0);
+    f.left_x = (p[0].x + p[3].x) / 2.0f;
+    f.right_x = (p[1].x + p[2].x) / 2.0f;
+    f.baseline_left = p[3];
+    f.baseline_right = p[2];
+    f.mergeable = std::abs(f.angle) <= MERGE_MAX_BOX_ANGLE && f.height > 0.0f && f.width >= f.height;
+    return f;
+}
+
+// Gap from `last` to `next` if `next` continues the same line, else -1
+static float continuationGap(const Fragment& last, const Fragment& next, const BoxMergeOptions& options) {
+    float taller = std::max(last.height, next.height);
+    float shorter = std::min(last.height, next.height);
+    if (taller > shorter * options.max_height_ratio) {
+        return -1.0f;
+    }
+    if (std::abs(last.angle - next.angle) > options.max_angle) {
+        return -1.0f;
+    }
+
+    float gap = next.left_x - last.right_x;
+    if (gap < -MERGE_MAX_OVERLAP * taller || gap > options.max_gap * taller) {
+        return -1.0f;
+    }
+
+    // Extend the last fragment's baseline to where the next one starts
+    float run = last.baseline_right.x - last.baseline_left.x;
+    float slope = run > 0.0f ? (last.baseline_right.y - last.baseline_left.y) / run : 0.0f;
+    float expected_y = last.baseline_right.y + (next.baseline_left.x - last.baseline_right.x) * slope;
+    if (std::abs(next.baseline_left.y - expected_y) > options.max_baseline_offset * taller) {
+        return -1.0f;
+    }
+    return std::max(gap, 0.0f);
+}
+
+// Smallest quad along the fragments' mean direction that holds all of them
+static TextBox enclosingBox(const std::vector<TextBox>& boxes, const std::vector<Fragment>& fragments,
+                            const std::vector<size_t>& members) {
+    double angle_sum = 0.0, weight_sum = 0.0, score_sum = 0.0;
+    for (size_t i : members) {
+        angle_sum += fragments[i].angle * fragments[i].width;
+        score_sum += boxes[i].score * fragments[i].width;
+        weight_sum += fragments[i].width;
+    }
+    double angle = weight_sum > 0.0 ? angle_sum / weight_sum * CV_PI / 180.0 : 0.0;
+    cv::Point2f along(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    cv::Point2f across(-along.y, along.x);
+
+    float min_u = FLT_MAX, max_u = -FLT_MAX, min_v = FLT_MAX, max_v = -FLT_MAX;
+    for (size_t i : members) {
+        for (const cv::Point2f& pt : boxes[i].points) {
+            float u = pt.dot(along);
+            float v = pt.dot(across);
+            min_u = std::min(min_u, u);
+            max_u = std::max(max_u, u);
+            min_v = std::min(min_v, v);
+            max_v = std::max(max_v, v);
+        }
+    }
+
+    TextBox box;
+    box.points[0] = along * min_u + across * min_v;
+    box.points[1] = along * max_u + across * min_v;
+    box.points[2] = along * max_u + across * max_v;
+    box.points[3] = along * min_u + across * max_v;
+    box.score = weight_sum > 0.0 ? static_cast<float>(score_sum / weight_sum) : boxes[members[0]].score;
+    return box;
+}
+
+std::vector<MergedBox> mergeCollinearBoxes(const std::vector<TextBox>& boxes, const BoxMergeOptions& options) {
+    std::vector<Fragment> fragments(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        fragments[i] = measureFragment(boxes[i]);
+    }
+
+    // Left to right, each fragment continues the line whose last fragment it
+    // fits best (smallest gap), or starts a new one
+    std::vector<size_t> by_left(boxes.size());
+    std::iota(by_left.begin(), by_left.end(), 0);
+    std::stable_sort(by_left.begin(), by_left.end(), [&](size_t a, size_t b) {
+        return fragments[a].left_x < fragments[b].left_x;
+    });
+
+    std::vector<std::vector<size_t>> lines;
+    for (size_t i : by_left) {
+        int best = -1;
+        float best_gap = FLT_MAX;
+        if (fragments[i].mergeable) {
+            for (size_t l = 0; l < lines.size(); l++) {
+                const Fragment& last = fragments[lines[l].back()];
+                if (!last.mergeable) {
+                    continue;
+                }
+                float gap = continuationGap(last, fragments[i], options);
+                if (gap >= 0.0f && gap < best_gap) {
+                    best_gap = gap;
+                    best = static_cast<int>(l);
+                }
+            }
+        }
+        if (best >= 0) {
+            lines[best].push_back(i);
+        } else {
+            lines.push_back({i});
+        }
+    }
+
+    // Back to detection order (by each line's first-detected fragment)
+    std::vector<size_t> first(lines.size());
+    for (size_t l = 0; l < lines.size(); l++) {
+        first[l] = *std::min_element(lines[l].begin(), lines[l].end());
+    }
+    std::vector<size_t> line_order(lines.size());
+    std::iota(line_order.begin(), line_order.end(), 0);
+    std::sort(line_order.begin(), line_order.end(), [&](size_t a, size_t b) { return first[a] < first[b]; });
+
+    std::vector<MergedBox> merged;
+    merged.reserve(lines.size());
+    for (size_t l : line_order) {
+        MergedBox line;
+        line.fragments = std::move(lines[l]);
+        line.box = line.fragments.size() == 1 ? boxes[line.fragments[0]]
+                                              : enclosingBox(boxes, fragments, line.fragments);
+        merged.push_back(std::move(line));
+    }
+
+    LOGD("Fragment merge: %zu boxes -> %zu lines", boxes.size(), merged.size());
+    return merged;
+}
@@ -0,0 +1,205 @@
+#include "include/classic_detector.h"
+#include "include/ocr_engine.h"
+#include "include/ocr_log.h"
+#include <algorithm>
+
+static const int STATS_MAX_SIDE = 256;         // Sample size for the auto-selector
+static const int CLASSIC_MAX_SIDE = 2000;      // Larger inputs are downscaled first
+static const int BACKGROUND_BAND = 6;          // Gray levels around the mode counted as background
+static const float CLEAN_BACKGROUND_RATIO = 0.5f;
+static const float CLEAN_BIMODALITY = 0.8f;
+static const double ADAPTIVE_C = 15.0;         // Flat backgrounds allow a strict offset
+
+DetectorBackend detectorBackendFromName(const std::string& name) {
+    if (name == "classic") {
+        return DetectorBackend::kClassic;
+    }
+    if (name == "auto") {
+        return DetectorBackend::kAuto;
+    }
+    return DetectorBackend::kNeural;
+}
+
+const char* detectorBackendName(DetectorBackend backend) {
+    switch (backend) {
+        case DetectorBackend::kClassic: return "classic";
+        case DetectorBackend::kAuto: return "auto";
+        default: return "neural";
+    }
+}
+
+static cv::Mat toGray(const cv::Mat& image) {
+    cv::Mat gray;
+    if (image.channels() == 3) {
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    } else if (image.channels() == 4) {
+        cv::cvtColor(image, gray, cv::COLOR_BGRA2GRAY);
+    } else {
+        gray = image;
+    }
+    return gray;
+}
+
+static void grayHistogram(const cv::Mat& gray, double hist[256]) {
+    std::fill(hist, hist + 256, 0.0);
+    for (int y = 0; y < gray.rows; y++) {
+        const uint8_t* row = gray.ptr<uint8_t>(y);
+        for (int x = 0; x < gray.cols; x++) {
+            hist[row[x]] += 1.0;
+        }
+    }
+}
+
+static int histogramMode(const double hist[256]) {
+    return static_cast<int>(std::max_element(hist, hist + 256) - hist);
+}
+
+ImageCleanliness measureCleanliness(const cv::Mat& image) {
+    ImageCleanliness stats{0.0f, 0.0f, false};
+    if (image.empty()) {
+        return stats;
+    }
+
+    // Nearest-neighbour sampling keeps the tonal distribution (no blended edges)
+    cv::Mat gray = toGray(image);
+    int max_side = std::max(gray.cols, gray.rows);
+    if (max_side > STATS_MAX_SIDE) {
+        double ratio = static_cast<double>(STATS_MAX_SIDE) / max_side;
+        cv::resize(gray, gray, cv::Size(), ratio, ratio, cv::INTER_NEAREST);
+    }
+
+    double hist[256];
+    grayHistogram(gray, hist);
+    double total = static_cast<double>(gray.total());
+
+    int mode = histogramMode(hist);
+    double background = 0.0;
+    for (int v = std::max(0, mode - BACKGROUND_BAND); v <= std::min(255, mode + BACKGROUND_BAND); v++) {
+        background += hist[v];
+    }
+    stats.background_ratio = static_cast<float>(background / total);
+
+    // Otsu: best between-class variance relative to total variance
+    double sum = 0.0, sum_sq = 0.0;
+    for (int v = 0; v < 256; v++) {
+        sum += v * hist[v];
+        sum_sq += static_cast<double>(v) * v * hist[v];
+    }
+    double mean = sum / total;
+    double variance = sum_sq / total - mean * mean;
+
+    if (variance < 1.0) {
+        // Blank page: nothing for either detector to find, take the cheap one
+        stats.bimodality = 1.0f;
+    } else {
+        double w0 = 0.0, sum0 = 0.0, best = 0.0;
+        for (int t = 0; t < 255; t++) {
+            w0 += hist[t];
+            sum0 += t * hist[t];
+            double w1 = total - w0;
+            if (w0 == 0.0 || w1 == 0.0) {
+                continue;
+            }
+            double m0 = sum0 / w0;
+            double m1 = (sum - sum0) / w1;
+            best = std::max(best, w0 * w1 * (m0 - m1) * (m0 - m1) / (total * total));
+        }
+        stats.bimodality = static_cast<float>(best / variance);
+    }
+
+    stats.clean = stats.background_ratio >= CLEAN_BACKGROUND_RATIO && stats.bimodality >= CLEAN_BIMODALITY;
+    return stats;
+}
+
+std::vector<TextBox> detectTextClassic(const cv::Mat& image) {
+    std::vector<TextBox> boxes;
+    if (image.empty()) {
+        return boxes;
+    }
+
+    cv::Mat gray = toGray(image);
+    float scale = 1.0f;
+    int max_side = std::max(gray.cols, gray.rows);
+    if (max_side > CLASSIC_MAX_SIDE) {
+        scale = static_cast<float>(CLASSIC_MAX_SIDE) / max_side;
+        cv::resize(gray, gray, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+
+    // Ink must come out as foreground: flip light-on-dark (dark mode) content
+    double hist[256];
+    grayHistogram(gray, hist);
+    if (histogramMode(hist) < 128) {
+        cv::bitwise_not(gray, gray);
+    }
+
+    // Adaptive binarization: ink is anything clearly darker than its neighbourhood
+    int short_side = std::min(gray.cols, gray.rows);
+    int block = 2 * std::max(7, short_side / 80) + 1;
+    cv::Mat ink;
+    cv::adaptiveThreshold(gray, ink, 255, cv::ADAPTIVE_THRESH_MEAN_C, cv::THRESH_BINARY_INV, block, ADAPTIVE_C);
+
+    // Typical glyph height sets how far characters are joined into lines
+    cv::Mat labels, stats, centroids;
+    int count = cv::connectedComponentsWithStats(ink, labels, stats, centroids, 8, CV_32S);
+    std::vector<int> heights;
+    for (int i = 1; i < count; i++) {
+        int h = stats.at<int>(i, cv::CC_STAT_HEIGHT);
+        if (h >= 3 && h <= short_side / 4) {
+            heights.push_back(h);
+        }
+    }
+    if (heights.empty()) {
+        return boxes;
+    }
+    std::nth_element(heights.begin(), heights.begin() + heights.size() / 2, heights.end());
+    int glyph_h = heights[heights.size() / 2];
+
+    // Morphological line grouping: close horizontal gaps up to about one glyph height
+    // (letters and word spaces), never vertically, so lines stay apart
+    cv::Mat lines;
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(std::max(3, glyph_h), 1));
+    cv::morphologyEx(ink, lines, cv::MORPH_CLOSE, kernel);
+
+    count = cv::connectedComponentsWithStats(lines, labels, stats, centroids, 8, CV_32S);
+
+    float inv_scale = 1.0f / scale;
+    int min_h = std::max(4, glyph_h / 3);
+    int max_h = glyph_h * 5;  // Taller blobs are pictures or rules, not text lines
+
+    for (int i = 1; i < count; i++) {
+        int x = stats.at<int>(i, cv::CC_STAT_LEFT);
+        int y = stats.at<int>(i, cv::CC_STAT_TOP);
+        int w = stats.at<int>(i, cv::CC_STAT_WIDTH);
+        int h = stats.at<int>(i, cv::CC_STAT_HEIGHT);
+        int area = stats.at<int>(i, cv::CC_STAT_AREA);
+
+        if (h < min_h || h > max_h || w < min_h || area < 12) {
+            continue;
+        }
+
+        // Pad like DB box expansion, so recognition sees some margin
+        float pad = 0.25f * h;
+        float x1 = std::max(0.0f, (x - pad) * inv_scale);
+        float y1 = std::max(0.0f, (y - pad) * inv_scale);
+        float x2 = std::min(static_cast<float>(image.cols), (x + w + pad) * inv_scale);
+        float y2 = std::min(static_cast<float>(image.rows), (y + h + pad) * inv_scale);
+
+        TextBox box;
+        box.points = {cv::Point2f(x1, y1), cv::Point2f(x2, y1), cv::Point2f(x2, y2), cv::Point2f(x1, y2)};
+        box.score = 1.0f;  // No model confidence for classical boxes
+        boxes.push_back(box);
+    }
+
+    // Same order as DBPostProcess: top to bottom, then left to right
+    std::sort(boxes.begin(), boxes.end(), [](const TextBox& a, const TextBox& b) {
+        float a_y = (a.points[0].y + a.points[1].y) / 2;
+        float b_y = (b.points[0].y + b.points[1].y) / 2;
+        if (std::abs(a_y - b_y) > 10) {
+            return a_y < b_y;
+        }
+        return a.points[0].x < b.points[0].x;
+    });
+
+    LOGD("Classic detector: %zu boxes (glyph height %d, scale %.2f)", boxes.size(), glyph_h, scale);
+    return boxes;
+}
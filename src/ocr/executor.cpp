@@ -0,0 +1,58 @@
+#include "include/executor.h"
+#include "include/ocr_log.h"
+#include <algorithm>
+
+ThreadPoolExecutor::ThreadPoolExecutor(int threads) {
+    int count = std::max(1, threads);
+    workers_.reserve(count);
+    for (int i = 0; i < count; i++) {
+        workers_.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    available_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPoolExecutor::Execute(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    available_.notify_one();
+}
+
+size_t ThreadPoolExecutor::QueueDepth() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void ThreadPoolExecutor::WorkerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;  // Stopping and drained
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        // A throwing task must not take the worker (and the process) down
+        try {
+            task();
+        } catch (const std::exception& e) {
+            LOGE("Executor task threw: %s", e.what());
+        } catch (...) {
+            LOGE("Executor task threw an unknown exception");
+        }
+    }
+}
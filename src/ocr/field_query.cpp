@@ -0,0 +1,329 @@
+#include "include/field_query.h"
+#include "include/fuzzy_match.h"
+#include "include/text_utils.h"
+#include "include/ocr_log.h"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <numeric>
+
+static const size_t FIELD_ROUND_SIZE = 6;        // Boxes recognized per round (one rec batch)
+static const int FIELD_FUZZY_MIN_LENGTH = 4;     // Shorter anchors must match exactly
+static const float FIELD_BELOW_MAX_LINES = 3.0f; // How far under its anchor a value may sit
+
+FieldRelation fieldRelationFromName(const std::string& name) {
+    if (name == "below") {
+        return FieldRelation::kBelow;
+    }
+    if (name == "any") {
+        return FieldRelation::kAny;
+    }
+    return FieldRelation::kRight;
+}
+
+bool fieldRegionFromName(const std::string& name, cv::Rect2f& region) {
+    const float third = 1.0f / 3.0f;
+    if (name == "top_third") {
+        region = cv::Rect2f(0.0f, 0.0f, 1.0f, third);
+    } else if (name == "middle_third") {
+        region = cv::Rect2f(0.0f, third, 1.0f, third);
+    } else if (name == "bottom_third") {
+        region = cv::Rect2f(0.0f, 2.0f * third, 1.0f, third);
+    } else if (name == "top_half") {
+        region = cv::Rect2f(0.0f, 0.0f, 1.0f, 0.5f);
+    } else if (name == "bottom_half") {
+        region = cv::Rect2f(0.0f, 0.5f, 1.0f, 0.5f);
+    } else if (name == "left_half") {
+        region = cv::Rect2f(0.0f, 0.0f, 0.5f, 1.0f);
+    } else if (name == "right_half") {
+        region = cv::Rect2f(0.5f, 0.0f, 0.5f, 1.0f);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static cv::Rect2f boxBounds(const TextBox& box) {
+    float min_x = box.points[0].x, max_x = box.points[0].x;
+    float min_y = box.points[0].y, max_y = box.points[0].y;
+    for (const auto& pt : box.points) {
+        min_x = std::min(min_x, pt.x);
+        max_x = std::max(max_x, pt.x);
+        min_y = std::min(min_y, pt.y);
+        max_y = std::max(max_y, pt.y);
+    }
+    return cv::Rect2f(min_x, min_y, max_x - min_x, max_y - min_y);
+}
+
+// Is `box` where `relation` puts a value relative to `anchor`?
+static bool inRelation(const cv::Rect2f& anchor, const cv::Rect2f& box, FieldRelation relation) {
+    float slack = 0.25f * anchor.height;
+    if (relation != FieldRelation::kBelow) {
+        float overlap = std::min(anchor.br().y, box.br().y) - std::max(anchor.y, box.y);
+        if (overlap >= 0.5f * std::min(anchor.height, box.height) && box.x >= anchor.br().x - slack) {
+            return true;
+        }
+    }
+    if (relation != FieldRelation::kRight) {
+        float overlap = std::min(anchor.br().x, box.br().x) - std::max(anchor.x, box.x);
+        float drop = box.y - anchor.br().y;
+        if (overlap > 0.0f && drop >= -slack && drop <= FIELD_BELOW_MAX_LINES * anchor.height) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Distance from anchor to box, in anchor line heights
+static float relationDistance(const cv::Rect2f& anchor, const cv::Rect2f& box) {
+    float dx = std::max(0.0f, box.x - anchor.br().x);
+    float dy = std::max(0.0f, box.y - anchor.br().y);
+    return (dx + dy) / std::max(anchor.height, 1.0f);
+}
+
+// Strip spaces and label separators (":", "：") from both ends
+static std::string_view trimValue(std::string_view text) {
+    static const std::string_view kFullWidthColon = "\xEF\xBC\x9A";
+    for (bool trimmed = true; trimmed && !text.empty();) {
+        trimmed = false;
+        if (text.front() == ' ' || text.front() == ':' || text.front() == '\t') {
+            text.remove_prefix(1);
+            trimmed = true;
+        } else if (text.substr(0, kFullWidthColon.size()) == kFullWidthColon) {
+            text.remove_prefix(kFullWidthColon.size());
+            trimmed = true;
+        }
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == ':' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// The value in `text`: the pattern's first match, or the trimmed text
+static bool matchValue(const FieldSpec& spec, std::string_view text, std::string& value) {
+    text = trimValue(text);
+    if (text.empty()) {
+        return false;
+    }
+    if (!spec.has_pattern) {
+        value.assign(text);
+        return true;
+    }
+    std::string haystack(text);
+    std::smatch match;
+    if (!std::regex_search(haystack, match, spec.pattern) || match.length(0) == 0) {
+        return false;
+    }
+    value = match.str(0);
+    return true;
+}
+
+namespace {
+
+struct FieldState {
+    std::vector<FuzzyPattern> anchors;
+    int anchor_cost = INT_MAX;  // Best anchor match so far; INT_MAX = not seen
+    size_t anchor_box = 0;
+    std::string after_anchor;   // Text following the anchor on its own line
+    float min_score = 0.0f;
+    FieldValue value;
+
+    bool AnchorFound() const { return anchor_cost != INT_MAX; }
+};
+
+struct RecognizedBox {
+    std::string text;
+    float score = 0.0f;
+};
+
+}  // namespace
+
+FieldQueryResult queryFields(OcrEngine& engine, const cv::Mat& image, const FieldQuery& query,
+                             const OcrOptions& options) {
+    FieldQueryResult result;
+    result.values.resize(query.fields.size());
+    if (image.empty() || query.fields.empty()) {
+        result.complete = query.fields.empty();
+        return result;
+    }
+
+    std::vector<TextBox> boxes = engine.DetectText(image, options);
+    result.detected = boxes.size();
+
+    std::vector<cv::Rect2f> bounds(boxes.size());
+    std::vector<cv::Point2f> centers(boxes.size());  // As fractions of the page
+    for (size_t i = 0; i < boxes.size(); i++) {
+        bounds[i] = boxBounds(boxes[i]);
+        centers[i] = cv::Point2f((bounds[i].x + bounds[i].width / 2.0f) / image.cols,
+                                 (bounds[i].y + bounds[i].height / 2.0f) / image.rows);
+    }
+
+    std::vector<FieldState> states(query.fields.size());
+    for (size_t f = 0; f < query.fields.size(); f++) {
+        for (const std::string& anchor : query.fields[f].anchors) {
+            states[f].anchors.emplace_back(anchor);
+        }
+        states[f].min_score = query.fields[f].min_score > 0.0f ? query.fields[f].min_score : query.min_score;
+    }
+
+    std::vector<bool> done(boxes.size(), false);  // Sent to recognition
+    std::vector<RecognizedBox> recognized(boxes.size());
+    std::vector<size_t> seen;                     // Recognized boxes with text, in order
+
+    // How promising an unrecognized box is for one unresolved field
+    auto priority = [&](size_t f, size_t i) -> float {
+        const FieldSpec& spec = query.fields[f];
+        const FieldState& state = states[f];
+        if (state.AnchorFound()) {
+            const cv::Rect2f& anchor = bounds[state.anchor_box];
+            return inRelation(anchor, bounds[i], spec.relation)
+                       ? 10.0f + 1.0f / (1.0f + relationDistance(anchor, bounds[i]))
+                       : 0.01f;
+        }
+        if (spec.has_region) {
+            return spec.region.contains(centers[i]) ? 1.0f : 0.1f;
+        }
+        return 0.5f;
+    };
+
+    // Resolve field f from what has been recognized, if it can be already
+    auto resolve = [&](size_t f, const std::vector<size_t>& fresh) {
+        const FieldSpec& spec = query.fields[f];
+        FieldState& state = states[f];
+        FieldValue& value = state.value;
+
+        if (state.anchors.empty()) {
+            for (size_t i : fresh) {
+                const RecognizedBox& box = recognized[i];
+                std::string text;
+                if (box.score < state.min_score || (spec.has_region && !spec.region.contains(centers[i])) ||
+                    !matchValue(spec, box.text, text)) {
+                    continue;
+                }
+                value = {true, text, box.text, box.score, bounds[i].x, bounds[i].y,
+                         bounds[i].br().x, bounds[i].br().y};
+                return;
+            }
+            return;
+        }
+
+        // Look for (a better match of) the anchor in the new text
+        for (size_t i : fresh) {
+            const std::string& text = recognized[i].text;
+            for (const FuzzyPattern& anchor : state.anchors) {
+                FuzzyMatch match;
+                int allowed = anchor.length() >= FIELD_FUZZY_MIN_LENGTH ? query.max_errors : 0;
+                if (anchor.Find(text, allowed, match) && match.cost < state.anchor_cost) {
+                    state.anchor_cost = match.cost;
+                    state.anchor_box = i;
+                    std::vector<uint32_t> offsets = utf8CodePointOffsets(text);
+                    state.after_anchor = text.substr(offsets[match.end]);
+                }
+            }
+        }
+        if (!state.AnchorFound()) {
+            return;
+        }
+
+        // Value after the keyword on its own line ("總計: 1,234")
+        const RecognizedBox& anchor_box = recognized[state.anchor_box];
+        std::string text;
+        if (spec.relation != FieldRelation::kBelow && anchor_box.score >= state.min_score &&
+            matchValue(spec, state.after_anchor, text)) {
+            const cv::Rect2f& b = bounds[state.anchor_box];
+            value = {true, text, anchor_box.text, anchor_box.score, b.x, b.y, b.br().x, b.br().y};
+            return;
+        }
+
+        // Else the nearest recognized box in relation, unless an unrecognized one is nearer
+        const cv::Rect2f& anchor = bounds[state.anchor_box];
+        float best_distance = FLT_MAX;
+        size_t best = 0;
+        std::string best_text;
+        for (size_t i : seen) {
+            if (i == state.anchor_box || recognized[i].score < state.min_score ||
+                !inRelation(anchor, bounds[i], spec.relation)) {
+                continue;
+            }
+            float distance = relationDistance(anchor, bounds[i]);
+            if (distance < best_distance && matchValue(spec, recognized[i].text, text)) {
+                best_distance = distance;
+                best = i;
+                best_text = text;
+            }
+        }
+        if (best_distance == FLT_MAX) {
+            return;
+        }
+        for (size_t i = 0; i < boxes.size(); i++) {
+            if (!done[i] && inRelation(anchor, bounds[i], spec.relation) &&
+                relationDistance(anchor, bounds[i]) < best_distance) {
+                return;
+            }
+        }
+        value = {true, best_text, recognized[best].text, recognized[best].score, bounds[best].x, bounds[best].y,
+                 bounds[best].br().x, bounds[best].br().y};
+    };
+
+    auto all_resolved = [&]() {
+        return std::all_of(states.begin(), states.end(), [](const FieldState& s) { return s.value.found; });
+    };
+
+    std::vector<float> scores(boxes.size());
+    std::vector<size_t> order(boxes.size());
+    while (!all_resolved()) {
+        // Rank what is left by its best score over the unresolved fields
+        std::iota(order.begin(), order.end(), 0);
+        for (size_t i = 0; i < boxes.size(); i++) {
+            scores[i] = 0.0f;
+            for (size_t f = 0; f < states.size() && !done[i]; f++) {
+                if (!states[f].value.found) {
+                    scores[i] = std::max(scores[i], priority(f, i));
+                }
+            }
+        }
+        auto remaining = std::stable_partition(order.begin(), order.end(), [&](size_t i) { return !done[i]; });
+        size_t left = static_cast<size_t>(remaining - order.begin());
+        if (left == 0) {
+            break;
+        }
+        size_t take = std::min(FIELD_ROUND_SIZE, left);
+        std::partial_sort(order.begin(), order.begin() + take, remaining, [&](size_t a, size_t b) {
+            return scores[a] != scores[b] ? scores[a] > scores[b] : a < b;
+        });
+
+        std::vector<TextBox> round(take);
+        for (size_t k = 0; k < take; k++) {
+            round[k] = boxes[order[k]];
+            done[order[k]] = true;
+        }
+        std::vector<size_t> line_boxes;
+        TextLines lines = engine.RecognizeBoxes(image, round, 0.0f, &line_boxes);
+        result.recognized += take;
+        result.rounds++;
+
+        std::vector<size_t> fresh;
+        for (size_t l = 0; l < lines.size(); l++) {
+            size_t i = order[line_boxes[l]];
+            recognized[i].text.assign(lines[l].text);
+            recognized[i].score = lines[l].score;
+            fresh.push_back(i);
+            seen.push_back(i);
+        }
+        for (size_t f = 0; f < states.size(); f++) {
+            if (!states[f].value.found) {
+                resolve(f, fresh);
+            }
+        }
+    }
+
+    for (size_t f = 0; f < states.size(); f++) {
+        result.values[f] = states[f].value;
+    }
+    result.complete = all_resolved();
+    LOGD("Field query: %zu fields %s after %zu of %zu boxes (%zu rounds)", states.size(),
+         result.complete ? "resolved" : "incomplete", result.recognized, result.detected, result.rounds);
+    return result;
+}
@@ -0,0 +1,181 @@
+#include "include/fuzzy_match.h"
+#include "include/text_utils.h"
+#include <algorithm>
+
+// Build match-vector tables (bit i set where pattern[i] == cp)
+static void buildPeq(const std::u32string& pattern, uint64_t* ascii,
+                     std::vector<std::pair<char32_t, uint64_t>>& table) {
+    std::fill(ascii, ascii + 128, 0);
+    table.clear();
+    for (size_t i = 0; i < pattern.size(); i++) {
+        char32_t cp = pattern[i];
+        uint64_t bit = 1ULL << i;
+        if (cp < 128) {
+            ascii[cp] |= bit;
+            continue;
+        }
+        auto it = std::find_if(table.begin(), table.end(), [cp](const auto& e) { return e.first == cp; });
+        if (it == table.end()) {
+            table.push_back({cp, bit});
+        } else {
+            it->second |= bit;
+        }
+    }
+    std::sort(table.begin(), table.end());
+}
+
+FuzzyPattern::FuzzyPattern(std::string_view pattern, bool case_sensitive)
+    : case_sensitive_(case_sensitive) {
+    std::u32string cps = decodeUtf8(pattern);
+    if (cps.size() > static_cast<size_t>(FUZZY_MAX_PATTERN_LENGTH)) {
+        cps.resize(FUZZY_MAX_PATTERN_LENGTH);
+    }
+    if (!case_sensitive_) {
+        for (auto& cp : cps) {
+            cp = foldCase(cp);
+        }
+    }
+    length_ = static_cast<int>(cps.size());
+
+    std::vector<std::pair<char32_t, uint64_t>> table;
+    buildPeq(cps, ascii_peq_, table);
+    for (const auto& e : table) {
+        peq_.push_back({e.first, e.second});
+    }
+
+    std::u32string reversed(cps.rbegin(), cps.rend());
+    buildPeq(reversed, reverse_ascii_peq_, table);
+    for (const auto& e : table) {
+        reverse_peq_.push_back({e.first, e.second});
+    }
+}
+
+uint64_t FuzzyPattern::Peq(char32_t cp, const uint64_t* ascii, const std::vector<PeqEntry>& table) const {
+    if (!case_sensitive_) {
+        cp = foldCase(cp);
+    }
+    if (cp < 128) {
+        return ascii[cp];
+    }
+    auto it = std::lower_bound(table.begin(), table.end(), cp,
+                               [](const PeqEntry& e, char32_t c) { return e.cp < c; });
+    return (it != table.end() && it->cp == cp) ? it->mask : 0;
+}
+
+// Myers (1999) / Hyyrö formulation. Unanchored, the score tracks the edit distance
+// of the whole pattern against the best substring ending at the current position;
+// anchored, against the whole text consumed so far, and the scan stops at the first
+// position within max_errors.
+template <typename NextFn>
+bool FuzzyPattern::Scan(NextFn next, const uint64_t* ascii, const std::vector<PeqEntry>& table,
+                        int max_errors, bool anchored, int& best_end, int& best_cost) const {
+    const uint64_t high = 1ULL << (length_ - 1);
+    uint64_t pv = ~0ULL;
+    uint64_t mv = 0;
+    int score = length_;
+
+    best_cost = max_errors + 1;
+    best_end = -1;
+
+    char32_t cp;
+    for (int j = 0; next(cp); j++) {
+        uint64_t eq = Peq(cp, ascii, table);
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if (ph & high) {
+            score++;
+        } else if (mh & high) {
+            score--;
+        }
+
+        ph = (ph << 1) | (anchored ? 1 : 0);
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        if (score < best_cost) {
+            best_cost = score;
+            best_end = j + 1;
+            if (score == 0 || anchored) {
+                break;
+            }
+        }
+    }
+
+    return best_end >= 0;
+}
+
+bool FuzzyPattern::Find(std::string_view text, int max_errors, FuzzyMatch& match) const {
+    if (length_ == 0 || max_errors < 0) {
+        return false;
+    }
+
+    // Forward pass straight over the UTF-8 bytes: best cost and where it ends
+    size_t pos = 0;
+    auto next = [&](char32_t& cp) {
+        if (pos >= text.size()) return false;
+        cp = nextUtf8CodePoint(text, pos);
+        return true;
+    };
+
+    int end, cost;
+    if (!Scan(next, ascii_peq_, peq_, max_errors, false, end, cost)) {
+        return false;
+    }
+
+    // Anchored pass of the reversed pattern backwards from that end: the first
+    // position reaching the same cost is the start of the shortest such match
+    std::u32string prefix = decodeUtf8(text);
+    prefix.resize(end);
+    int back = end;
+    auto prev = [&](char32_t& cp) {
+        if (back <= 0) return false;
+        cp = prefix[--back];
+        return true;
+    };
+
+    int length = 0, reverse_cost;
+    if (cost < length_) {
+        Scan(prev, reverse_ascii_peq_, reverse_peq_, cost, true, length, reverse_cost);
+    }
+
+    match.start = std::max(0, end - std::max(length, 0));
+    match.end = end;
+    match.cost = cost;
+    return true;
+}
+
+std::vector<FuzzyMatch> fuzzyMatchTexts(const std::string& pattern,
+                                        const std::vector<std::string>& texts,
+                                        int max_errors,
+                                        bool case_sensitive) {
+    std::vector<FuzzyMatch> matches;
+    FuzzyPattern matcher(pattern, case_sensitive);
+    if (matcher.empty()) {
+        return matches;
+    }
+
+    for (size_t i = 0; i < texts.size(); i++) {
+        FuzzyMatch match;
+        if (matcher.Find(texts[i], max_errors, match)) {
+            match.line_index = i;
+            matches.push_back(match);
+        }
+    }
+
+    std::stable_sort(matches.begin(), matches.end(), [](const FuzzyMatch& a, const FuzzyMatch& b) {
+        return a.cost < b.cost;
+    });
+    return matches;
+}
+
+std::string utf8Substring(std::string_view text, int start, int end) {
+    std::vector<uint32_t> offsets = utf8CodePointOffsets(text);
+    int count = static_cast<int>(offsets.size()) - 1;
+    start = std::max(0, std::min(start, count));
+    end = std::max(start, std::min(end, count));
+    return std::string(text.substr(offsets[start], offsets[end] - offsets[start]));
+}
@@ -0,0 +1,456 @@
+#include "include/golden_corpus.h"
+#include "include/pipeline_kernels.h"
+#include "include/text_utils.h"
+#include "include/ocr_log.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+// Threshold used by the binarize / masked-mean checks
+static const float KERNEL_CHECK_THRESHOLD = 0.3f;
+// Longest side images are scaled to for the kernel checks
+static const int KERNEL_CHECK_MAX_SIDE = 640;
+
+static std::string resolveImagePath(const GoldenCorpus& corpus, const std::string& image) {
+    if (image.empty() || image[0] == '/' || corpus.base_dir.empty()) {
+        return image;
+    }
+    return corpus.base_dir + "/" + image;
+}
+
+bool loadGoldenCorpus(const std::string& manifest_path, GoldenCorpus& corpus) {
+    std::ifstream file(manifest_path);
+    if (!file.is_open()) {
+        LOGW("Golden corpus not found: %s", manifest_path.c_str());
+        return false;
+    }
+    nlohmann::json parsed = nlohmann::json::parse(file, nullptr, false);
+    auto items = parsed.is_object() ? parsed.find("items") : parsed.end();
+    if (parsed.is_discarded() || !parsed.is_object() || items == parsed.end() || !items->is_array()) {
+        LOGW("Golden corpus malformed: %s", manifest_path.c_str());
+        return false;
+    }
+
+    // value() throws on a wrongly typed field: a manifest like that is malformed
+    try {
+        size_t slash = manifest_path.find_last_of('/');
+        corpus.base_dir = slash == std::string::npos ? std::string() : manifest_path.substr(0, slash);
+        corpus.version = parsed.value("version", 1);
+        corpus.det_threshold = parsed.value("det_threshold", 0.3f);
+        corpus.rec_threshold = parsed.value("rec_threshold", 0.5f);
+        corpus.items.clear();
+
+        for (const auto& entry : *items) {
+            if (!entry.is_object()) {
+                LOGW("Golden corpus: skipping an item that is not an object");
+                continue;
+            }
+            GoldenItem item;
+            item.image = entry.value("image", std::string());
+            auto lines = entry.find("lines");
+            if (lines != entry.end() && lines->is_array()) {
+                for (const auto& line : *lines) {
+                    auto box = line.is_object() ? line.find("box") : line.end();
+                    if (box == line.end() || !box->is_array() || box->size() != 4 ||
+                        !std::all_of(box->begin(), box->end(), [](const nlohmann::json& v) { return v.is_number(); })) {
+                        LOGW("Golden corpus: skipping a line without a [x1,y1,x2,y2] box in %s", item.image.c_str());
+                        continue;
+                    }
+                    item.lines.push_back({(*box)[0].get<float>(), (*box)[1].get<float>(), (*box)[2].get<float>(),
+                                          (*box)[3].get<float>(), line.value("text", std::string())});
+                }
+            }
+            corpus.items.push_back(std::move(item));
+        }
+    } catch (const nlohmann::json::exception& e) {
+        LOGW("Golden corpus malformed: %s: %s", manifest_path.c_str(), e.what());
+        return false;
+    }
+    return true;
+}
+
+bool saveGoldenCorpus(const std::string& manifest_path, const GoldenCorpus& corpus) {
+    nlohmann::json items = nlohmann::json::array();
+    for (const GoldenItem& item : corpus.items) {
+        nlohmann::json lines = nlohmann::json::array();
+        for (const GoldenLine& line : item.lines) {
+            lines.push_back({{"box", {line.x1, line.y1, line.x2, line.y2}}, {"text", line.text}});
+        }
+        items.push_back({{"image", item.image}, {"lines", lines}});
+    }
+    nlohmann::json manifest = {
+        {"version", corpus.version},
+        {"det_threshold", corpus.det_threshold},
+        {"rec_threshold", corpus.rec_threshold},
+        {"items", items},
+    };
+
+    std::ofstream file(manifest_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << manifest.dump(1) << "\n";
+    return static_cast<bool>(file);
+}
+
+void recordGoldenCorpus(OcrEngine& engine, GoldenCorpus& corpus) {
+    for (GoldenItem& item : corpus.items) {
+        cv::Mat image = cv::imread(resolveImagePath(corpus, item.image));
+        item.lines.clear();
+        if (image.empty()) {
+            LOGW("Golden image not found: %s", item.image.c_str());
+            continue;
+        }
+        TextLines lines = engine.RecognizeText(image, corpus.det_threshold, corpus.rec_threshold);
+        for (const TextLineResult& line : lines) {
+            item.lines.push_back({line.x1, line.y1, line.x2, line.y2, std::string(line.text)});
+        }
+    }
+}
+
+// ========================
+// Accuracy
+// ========================
+
+static float boxIou(const GoldenLine& a, const TextLineResult& b) {
+    float ix = std::max(0.0f, std::min(a.x2, b.x2) - std::max(a.x1, b.x1));
+    float iy = std::max(0.0f, std::min(a.y2, b.y2) - std::max(a.y1, b.y1));
+    float inter = ix * iy;
+    float uni = (a.x2 - a.x1) * (a.y2 - a.y1) + (b.x2 - b.x1) * (b.y2 - b.y1) - inter;
+    return uni > 0.0f ? inter / uni : 0.0f;
+}
+
+// Levenshtein distance in code points
+static size_t editDistance(const std::u32string& a, const std::u32string& b) {
+    std::vector<size_t> prev(b.size() + 1), cur(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++) {
+        prev[j] = j;
+    }
+    for (size_t i = 1; i <= a.size(); i++) {
+        cur[0] = i;
+        for (size_t j = 1; j <= b.size(); j++) {
+            size_t substitute = prev[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+            cur[j] = std::min({prev[j] + 1, cur[j - 1] + 1, substitute});
+        }
+        std::swap(prev, cur);
+    }
+    return prev[b.size()];
+}
+
+// Pair golden and found lines, highest IoU first, each used once
+static void scoreItem(const GoldenItem& item, const TextLines& found, float match_iou,
+                      GoldenItemReport& report) {
+    struct Pair {
+        float iou;
+        size_t golden;
+        size_t found;
+    };
+    std::vector<Pair> pairs;
+    for (size_t g = 0; g < item.lines.size(); g++) {
+        for (size_t f = 0; f < found.size(); f++) {
+            float iou = boxIou(item.lines[g], found[f]);
+            if (iou >= match_iou) {
+                pairs.push_back({iou, g, f});
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) { return a.iou > b.iou; });
+
+    std::vector<bool> golden_used(item.lines.size(), false);
+    std::vector<bool> found_used(found.size(), false);
+    double iou_sum = 0.0;
+    for (const Pair& pair : pairs) {
+        if (golden_used[pair.golden] || found_used[pair.found]) {
+            continue;
+        }
+        golden_used[pair.golden] = true;
+        found_used[pair.found] = true;
+        iou_sum += pair.iou;
+        report.matched++;
+        report.char_errors += editDistance(decodeUtf8(item.lines[pair.golden].text),
+                                           decodeUtf8(found[pair.found].text));
+    }
+
+    for (size_t g = 0; g < item.lines.size(); g++) {
+        size_t length = decodeUtf8(item.lines[g].text).size();
+        report.chars += length;
+        if (!golden_used[g]) {
+            report.char_errors += length;
+        }
+    }
+    report.expected = item.lines.size();
+    report.found = found.size();
+    report.mean_iou = report.matched > 0 ? iou_sum / report.matched : 0.0;
+}
+
+// ========================
+// Kernel drift
+// ========================
+
+static void recordError(KernelDrift& drift, double error, double max_error) {
+    drift.samples++;
+    drift.max_error = std::max(drift.max_error, error);
+    if (error > max_error) {
+        drift.mismatches++;
+    }
+}
+
+// Straight from the formula: (x / 255 - mean[c]) / std[c], channels in pipeline order
+template <typename Pipeline>
+static double referencePackValue(const cv::Vec3b& pixel, int c) {
+    int source = Pipeline::kSwapRB ? 2 - c : c;
+    return (pixel[source] / 255.0 - Pipeline::kMean[c]) / Pipeline::kStd[c];
+}
+
+template <typename Pipeline>
+static void checkPack(const cv::Mat& src, int width, KernelDrift& drift, double max_error) {
+    std::vector<float> packed(static_cast<size_t>(3) * src.rows * width);
+    if (width == src.cols) {
+        PackToPlanar<Pipeline>(src, packed.data());
+    } else {
+        PackToPlanarPadded<Pipeline>(src, packed.data(), width);
+    }
+    for (int c = 0; c < 3; c++) {
+        for (int y = 0; y < src.rows; y++) {
+            const float* row = packed.data() + (static_cast<size_t>(c) * src.rows + y) * width;
+            for (int x = 0; x < width; x++) {
+                double expected = x < src.cols ? referencePackValue<Pipeline>(src.at<cv::Vec3b>(y, x), c) : 0.0;
+                recordError(drift, std::abs(row[x] - expected), max_error);
+            }
+        }
+    }
+}
+
+enum KernelCheck { kPackDet, kPackRec, kBinarize, kBinarizePooled, kMaskedMean, kCtcArgmax, KERNEL_CHECK_COUNT };
+
+static std::vector<KernelDrift> newKernelDrifts() {
+    std::vector<KernelDrift> drifts(KERNEL_CHECK_COUNT);
+    drifts[kPackDet].kernel = "pack_det";
+    drifts[kPackRec].kernel = "pack_rec_padded";
+    drifts[kBinarize].kernel = "binarize";
+    drifts[kBinarizePooled].kernel = "binarize_maxpool2x";
+    drifts[kMaskedMean].kernel = "masked_mean";
+    drifts[kCtcArgmax].kernel = "ctc_argmax";
+    return drifts;
+}
+
+static void finishKernelDrifts(std::vector<KernelDrift>& drifts) {
+    for (KernelDrift& drift : drifts) {
+        drift.passed = drift.mismatches == 0;
+    }
+}
+
+// Run every kernel check on one image, adding to `drifts`
+static void checkKernelsOn(const cv::Mat& original, std::vector<KernelDrift>& drifts, double max_error) {
+    KernelDrift& pack_det = drifts[kPackDet];
+    KernelDrift& pack_rec = drifts[kPackRec];
+    KernelDrift& binarize = drifts[kBinarize];
+    KernelDrift& binarize_pooled = drifts[kBinarizePooled];
+    KernelDrift& masked_mean = drifts[kMaskedMean];
+    KernelDrift& ctc_argmax = drifts[kCtcArgmax];
+
+    cv::Mat image = original;
+    int long_side = std::max(original.cols, original.rows);
+    if (long_side > KERNEL_CHECK_MAX_SIDE) {
+        double scale = static_cast<double>(KERNEL_CHECK_MAX_SIDE) / long_side;
+        cv::resize(original, image, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+
+    checkPack<DetInputPipeline>(image, image.cols, pack_det, max_error);
+
+    // A recognition-height strip, padded the way batched rec pads it
+    cv::Mat strip;
+    int strip_width = std::max(1, std::min(320, image.cols * 48 / std::max(1, image.rows)));
+    cv::resize(image, strip, cv::Size(strip_width, 48));
+    checkPack<RecInputPipeline>(strip, strip_width + 7, pack_rec, max_error);
+
+    // Logit maps derived from the image stand in for model output
+    cv::Mat gray, logits;
+    cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    gray.convertTo(logits, CV_32F, 16.0 / 255.0, -8.0);
+    const float* data = logits.ptr<float>();
+    size_t n = logits.total();
+
+    std::vector<uint8_t> bits(n);
+    BinarizeAbove(data, bits.data(), n,
+                  RawThreshold<OutputActivation::kSigmoid>(KERNEL_CHECK_THRESHOLD));
+    for (size_t i = 0; i < n; i++) {
+        double probability = 1.0 / (1.0 + std::exp(-static_cast<double>(data[i])));
+        bool expected = probability > KERNEL_CHECK_THRESHOLD;
+        // Values on the threshold itself may round either way
+        bool differs = (bits[i] != 0) != expected &&
+                       std::abs(probability - KERNEL_CHECK_THRESHOLD) > 1e-6;
+        binarize.samples++;
+        if (differs) {
+            binarize.mismatches++;
+            binarize.max_error = 1.0;
+        }
+    }
+
+    // Half-resolution cells must be the OR of the column pair in the even
+    // row of the full-resolution bits just checked
+    int pooled_rows = (logits.rows + 1) / 2;
+    int pooled_cols = (logits.cols + 1) / 2;
+    std::vector<uint8_t> pooled(static_cast<size_t>(pooled_rows) * pooled_cols);
+    BinarizeAboveHalfRes(data, logits.rows, logits.cols,
+                         RawThreshold<OutputActivation::kSigmoid>(KERNEL_CHECK_THRESHOLD),
+                         pooled.data(), pooled_cols);
+    for (int y = 0; y < pooled_rows; y++) {
+        for (int x = 0; x < pooled_cols; x++) {
+            bool expected = false;
+            for (int dx = 0; dx < 2 && 2 * x + dx < logits.cols; dx++) {
+                expected = expected || bits[static_cast<size_t>(2 * y) * logits.cols + 2 * x + dx] != 0;
+            }
+            binarize_pooled.samples++;
+            if ((pooled[static_cast<size_t>(y) * pooled_cols + x] != 0) != expected) {
+                binarize_pooled.mismatches++;
+                binarize_pooled.max_error = 1.0;
+            }
+        }
+    }
+
+    cv::Mat mask = gray > 127;
+    double sum = 0.0;
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (mask.data[i]) {
+            sum += 1.0 / (1.0 + std::exp(-static_cast<double>(data[i])));
+            count++;
+        }
+    }
+    float mean = MaskedMeanActivation<OutputActivation::kSigmoid>(data, logits.cols, mask);
+    recordError(masked_mean, std::abs(mean - (count > 0 ? sum / count : 0.0)), max_error);
+
+    // Each image row as one CTC timestep over a vocab the width of the image
+    for (int y = 0; y < logits.rows; y++) {
+        const float* row = logits.ptr<float>(y);
+        auto [index, probability] = ArgmaxProbability<OutputActivation::kSoftmax>(row, logits.cols);
+        int expected_index = static_cast<int>(std::max_element(row, row + logits.cols) - row);
+        double denominator = 0.0;
+        for (int v = 0; v < logits.cols; v++) {
+            denominator += std::exp(static_cast<double>(row[v]) - row[expected_index]);
+        }
+        if (index != expected_index) {
+            ctc_argmax.samples++;
+            ctc_argmax.mismatches++;
+            ctc_argmax.max_error = 1.0;
+            continue;
+        }
+        recordError(ctc_argmax, std::abs(probability - 1.0 / denominator), max_error);
+    }
+}
+
+std::vector<KernelDrift> checkKernelDrift(const std::vector<cv::Mat>& images, double max_error) {
+    std::vector<KernelDrift> drifts = newKernelDrifts();
+    for (const cv::Mat& image : images) {
+        checkKernelsOn(image, drifts, max_error);
+    }
+    finishKernelDrifts(drifts);
+    return drifts;
+}
+
+// ========================
+// Run
+// ========================
+
+GoldenReport runGoldenCorpus(OcrEngine& engine, const GoldenCorpus& corpus,
+                             const GoldenTolerance& tolerance, int iterations, bool det_half_res) {
+    GoldenReport report;
+    report.corpus_version = corpus.version;
+    report.passed = true;
+    report.kernels = newKernelDrifts();
+
+    for (const GoldenItem& item : corpus.items) {
+        GoldenItemReport item_report;
+        item_report.image = item.image;
+        cv::Mat image = cv::imread(resolveImagePath(corpus, item.image));
+        if (image.empty()) {
+            report.items.push_back(item_report);
+            report.passed = false;
+            continue;
+        }
+        item_report.loaded = true;
+
+        TextLines found;
+        item_report.det_ms = item_report.rec_ms = std::numeric_limits<double>::max();
+        for (int i = 0; i < std::max(1, iterations); i++) {
+            auto t0 = std::chrono::steady_clock::now();
+            std::vector<TextBox> boxes = engine.DetectText(image, corpus.det_threshold, det_half_res);
+            auto t1 = std::chrono::steady_clock::now();
+            found = engine.RecognizeBoxes(image, boxes, corpus.rec_threshold);
+            auto t2 = std::chrono::steady_clock::now();
+            item_report.det_ms = std::min(item_report.det_ms,
+                                          std::chrono::duration<double, std::milli>(t1 - t0).count());
+            item_report.rec_ms = std::min(item_report.rec_ms,
+                                          std::chrono::duration<double, std::milli>(t2 - t1).count());
+        }
+
+        scoreItem(item, found, tolerance.match_iou, item_report);
+        item_report.passed = item_report.Cer() <= tolerance.max_cer &&
+                             item_report.Recall() >= tolerance.min_recall;
+        report.passed = report.passed && item_report.passed;
+        report.items.push_back(item_report);
+        checkKernelsOn(image, report.kernels, tolerance.kernel_max_error);
+    }
+
+    finishKernelDrifts(report.kernels);
+    for (const KernelDrift& drift : report.kernels) {
+        report.passed = report.passed && drift.passed;
+    }
+    return report;
+}
+
+std::string goldenReportToJson(const GoldenReport& report) {
+    nlohmann::json items = nlohmann::json::array();
+    size_t chars = 0, char_errors = 0, expected = 0, matched = 0;
+    double det_ms = 0.0, rec_ms = 0.0;
+    for (const GoldenItemReport& item : report.items) {
+        items.push_back({
+            {"image", item.image},
+            {"loaded", item.loaded},
+            {"expected", item.expected},
+            {"found", item.found},
+            {"matched", item.matched},
+            {"cer", item.Cer()},
+            {"recall", item.Recall()},
+            {"mean_iou", item.mean_iou},
+            {"det_ms", item.loaded ? item.det_ms : 0.0},
+            {"rec_ms", item.loaded ? item.rec_ms : 0.0},
+            {"passed", item.passed},
+        });
+        if (item.loaded) {
+            chars += item.chars;
+            char_errors += item.char_errors;
+            expected += item.expected;
+            matched += item.matched;
+            det_ms += item.det_ms;
+            rec_ms += item.rec_ms;
+        }
+    }
+
+    nlohmann::json kernels = nlohmann::json::array();
+    for (const KernelDrift& drift : report.kernels) {
+        kernels.push_back({
+            {"kernel", drift.kernel},
+            {"samples", drift.samples},
+            {"mismatches", drift.mismatches},
+            {"max_error", drift.max_error},
+            {"passed", drift.passed},
+        });
+    }
+
+    nlohmann::json json = {
+        {"corpus_version", report.corpus_version},
+        {"passed", report.passed},
+        {"cer", chars > 0 ? static_cast<double>(char_errors) / chars : 0.0},
+        {"recall", expected > 0 ? static_cast<double>(matched) / expected : 1.0},
+        {"det_ms", det_ms},
+        {"rec_ms", rec_ms},
+        {"items", items},
+        {"kernels", kernels},
+    };
+    return json.dump();
+}
@@ -0,0 +1,29 @@
+#ifndef BOX_MERGE_H
+#define BOX_MERGE_H
+
+#include "ocr_engine.h"
+#include <vector>
+
+// Joins detected fragments of one printed line (DB splits lines at wide
+// table gaps and font changes) so the line is recognized in one crop.
+// Fragments join when their heights, baselines and angles agree and the
+// horizontal gap between them is small relative to the line height.
+struct BoxMergeOptions {
+    float max_gap = 1.0f;              // Horizontal gap, in line heights
+    float max_height_ratio = 1.3f;     // Taller / shorter fragment
+    float max_baseline_offset = 0.25f; // Bottom edge mismatch, in line heights
+    float max_angle = 2.0f;            // Degrees between fragment angles
+};
+
+// A line to recognize and the detected boxes it was built from
+struct MergedBox {
+    TextBox box;
+    std::vector<size_t> fragments;  // Indices into the input boxes, left to right
+};
+
+// Merged lines in the order of their first fragment in `boxes`. Boxes that
+// are steep (over 10 degrees) or taller than wide are passed through alone.
+std::vector<MergedBox> mergeCollinearBoxes(const std::vector<TextBox>& boxes,
+                                           const BoxMergeOptions& options = BoxMergeOptions());
+
+#endif // BOX_MERGE_H
@@ -0,0 +1,35 @@
+#ifndef CLASSIC_DETECTOR_H
+#define CLASSIC_DETECTOR_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+struct TextBox;
+
+// Which text detector runs for a request
+enum class DetectorBackend {
+    kNeural,   // PP-OCR DB model
+    kClassic,  // Adaptive threshold + morphology + connected components
+    kAuto,     // Classic for clean, high-contrast images, neural otherwise
+};
+
+// "neural" / "classic" / "auto"; unknown names map to kNeural
+DetectorBackend detectorBackendFromName(const std::string& name);
+const char* detectorBackendName(DetectorBackend backend);
+
+// Image statistics the auto-selector decides on
+struct ImageCleanliness {
+    float background_ratio;  // Share of pixels within a few levels of the dominant gray level
+    float bimodality;        // Otsu between-class variance / total variance
+    bool clean;              // Screenshot / rendered-document like
+};
+
+// Cheap (downscaled) check for flat-background, two-tone content
+ImageCleanliness measureCleanliness(const cv::Mat& image);
+
+// Line boxes for clean digital text, as axis-aligned quads in image coordinates
+// (top-left, top-right, bottom-right, bottom-left), ordered top-to-bottom
+std::vector<TextBox> detectTextClassic(const cv::Mat& image);
+
+#endif // CLASSIC_DETECTOR_H
@@ -0,0 +1,44 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Where OcrClient runs requests. Implement this to hand work to a host's own
+// pool or event loop; Execute must not run the task inline on the caller if
+// the caller is an event loop thread that cannot block.
+class Executor {
+public:
+    virtual ~Executor() = default;
+    virtual void Execute(std::function<void()> task) = 0;
+};
+
+// Fixed set of worker threads draining one FIFO queue. The request scheduler
+// runs each model session one inference at a time, so a couple of workers
+// (one in det/rec, one preparing the next image) keep the engine busy.
+class ThreadPoolExecutor : public Executor {
+public:
+    explicit ThreadPoolExecutor(int threads = 2);
+    ~ThreadPoolExecutor() override;  // Runs queued tasks to completion, then joins
+    ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+    void Execute(std::function<void()> task) override;
+
+    size_t QueueDepth();
+
+private:
+    void WorkerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::deque<std::function<void()>> queue_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+};
+
+#endif // EXECUTOR_H
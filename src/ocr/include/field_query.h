@@ -0,0 +1,69 @@
+#ifndef FIELD_QUERY_H
+#define FIELD_QUERY_H
+
+#include "ocr_engine.h"
+#include <regex>
+#include <string>
+#include <vector>
+
+// Query-driven OCR: detect the page once, then recognize boxes a batch at a
+// time in the order the field hints rank them, matching each batch as it
+// comes back, and stop as soon as every field is resolved. An invoice that
+// only needs its number, date and total costs a few rec calls instead of
+// the whole page.
+
+// Where a field's value sits relative to its anchor keyword
+enum class FieldRelation {
+    kRight,  // Same row, to the right (or after the keyword on its own line)
+    kBelow,  // Under the keyword, overlapping it horizontally
+    kAny,    // Either
+};
+
+// "right" / "below" / "any"; unknown names map to kRight
+FieldRelation fieldRelationFromName(const std::string& name);
+
+struct FieldSpec {
+    std::string name;
+    // Value pattern (ECMAScript, searched in the UTF-8 text). Without one,
+    // an anchored field takes the whole text next to its anchor.
+    bool has_pattern = false;
+    std::regex pattern;
+    // Keywords the value is next to (e.g. "總計", "Total"), matched fuzzily
+    std::vector<std::string> anchors;
+    FieldRelation relation = FieldRelation::kRight;
+    // Part of the page the value lies in, as fractions of width and height
+    bool has_region = false;
+    cv::Rect2f region;
+    float min_score = 0.0f;  // 0 = the query's min_score
+};
+
+struct FieldQuery {
+    std::vector<FieldSpec> fields;
+    float min_score = 0.8f;  // Recognition score a value needs to resolve its field
+    int max_errors = 1;      // Edits allowed in anchors of 4+ code points; shorter ones match exactly
+};
+
+struct FieldValue {
+    bool found = false;
+    std::string text;  // The matched value
+    std::string line;  // Whole recognized text of the box it came from
+    float score = 0.0f;
+    float x1 = 0.0f, y1 = 0.0f, x2 = 0.0f, y2 = 0.0f;
+};
+
+struct FieldQueryResult {
+    std::vector<FieldValue> values;  // One per FieldQuery::fields entry
+    size_t detected = 0;    // Boxes found by detection
+    size_t recognized = 0;  // Boxes sent to recognition
+    size_t rounds = 0;      // Rec batches run
+    bool complete = false;  // Every field resolved
+};
+
+// Named regions: "top_third", "middle_third", "bottom_third", "top_half",
+// "bottom_half", "left_half", "right_half". Returns false for unknown names.
+bool fieldRegionFromName(const std::string& name, cv::Rect2f& region);
+
+FieldQueryResult queryFields(OcrEngine& engine, const cv::Mat& image, const FieldQuery& query,
+                             const OcrOptions& options = OcrOptions());
+
+#endif // FIELD_QUERY_H
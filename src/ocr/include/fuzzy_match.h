@@ -0,0 +1,65 @@
+#ifndef FUZZY_MATCH_H
+#define FUZZY_MATCH_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Longest pattern (in code points) the single-word bit-vector matcher handles
+const int FUZZY_MAX_PATTERN_LENGTH = 64;
+
+// Best approximate occurrence of a pattern in one text
+struct FuzzyMatch {
+    size_t line_index;  // Which input text matched
+    int start;          // First matched code point
+    int end;            // One past the last matched code point
+    int cost;           // Edit distance (insertions, deletions, substitutions)
+};
+
+// Approximate substring matcher using Myers' bit-parallel edit distance.
+// Works on code points, so one CJK character counts as one edit.
+class FuzzyPattern {
+public:
+    // Patterns longer than FUZZY_MAX_PATTERN_LENGTH code points are truncated
+    explicit FuzzyPattern(std::string_view pattern, bool case_sensitive = false);
+
+    bool empty() const { return length_ == 0; }
+    int length() const { return length_; }
+
+    // Lowest-cost occurrence in UTF-8 text with at most max_errors edits.
+    // Returns false when there is none.
+    bool Find(std::string_view text, int max_errors, FuzzyMatch& match) const;
+
+private:
+    struct PeqEntry {
+        char32_t cp;
+        uint64_t mask;
+    };
+
+    uint64_t Peq(char32_t cp, const uint64_t* ascii, const std::vector<PeqEntry>& table) const;
+
+    // Feed code points from `next`; best_end is the count consumed at the best score
+    template <typename NextFn>
+    bool Scan(NextFn next, const uint64_t* ascii, const std::vector<PeqEntry>& table,
+              int max_errors, bool anchored, int& best_end, int& best_cost) const;
+
+    bool case_sensitive_;
+    int length_ = 0;
+    uint64_t ascii_peq_[128] = {};           // Fast path for ASCII text
+    std::vector<PeqEntry> peq_;              // Non-ASCII code points, sorted
+    uint64_t reverse_ascii_peq_[128] = {};   // Same tables for the reversed pattern,
+    std::vector<PeqEntry> reverse_peq_;      // used to recover the match start
+};
+
+// Find `pattern` in each of `texts` (at most max_errors edits), best matches first
+std::vector<FuzzyMatch> fuzzyMatchTexts(const std::string& pattern,
+                                        const std::vector<std::string>& texts,
+                                        int max_errors,
+                                        bool case_sensitive = false);
+
+// Substring of UTF-8 `text` between code point offsets [start, end)
+std::string utf8Substring(std::string_view text, int start, int end);
+
+#endif // FUZZY_MATCH_H
@@ -0,0 +1,96 @@
+#ifndef GOLDEN_CORPUS_H
+#define GOLDEN_CORPUS_H
+
+#include "ocr_engine.h"
+#include <string>
+#include <vector>
+
+// Golden-output regression corpus: images with the boxes and text a known
+// good build produced, replayed against the current build. Reports CER and
+// box IoU against the goldens and per-stage latency, and checks the
+// optimized kernels in pipeline_kernels.h against plain reference versions
+// on the corpus images.
+//
+// Manifest (JSON), image paths relative to the manifest:
+//   {"version":3,"det_threshold":0.3,"rec_threshold":0.5,
+//    "items":[{"image":"images/invoice_1.jpg",
+//              "lines":[{"box":[x1,y1,x2,y2],"text":"..."}]}]}
+// Bump "version" whenever the goldens are re-recorded on purpose.
+
+struct GoldenLine {
+    float x1, y1, x2, y2;
+    std::string text;
+};
+
+struct GoldenItem {
+    std::string image;  // As written in the manifest
+    std::vector<GoldenLine> lines;
+};
+
+struct GoldenCorpus {
+    int version = 1;
+    std::string base_dir;  // Directory of the manifest
+    float det_threshold = 0.3f;
+    float rec_threshold = 0.5f;
+    std::vector<GoldenItem> items;
+};
+
+struct GoldenTolerance {
+    float match_iou = 0.5f;         // A found line matches a golden line at this IoU
+    double max_cer = 0.01;          // Per image
+    double min_recall = 0.98;       // Golden lines matched, per image
+    double kernel_max_error = 1e-4; // Max abs difference vs the reference kernel
+};
+
+struct GoldenItemReport {
+    std::string image;
+    bool loaded = false;
+    size_t expected = 0;
+    size_t found = 0;
+    size_t matched = 0;
+    size_t char_errors = 0;  // Edits over matched lines + chars of unmatched golden lines
+    size_t chars = 0;        // Chars in golden lines
+    double mean_iou = 0.0;   // Over matched lines
+    double det_ms = 0.0;     // Best of the iterations
+    double rec_ms = 0.0;
+    bool passed = false;
+
+    double Cer() const { return chars > 0 ? static_cast<double>(char_errors) / chars : 0.0; }
+    double Recall() const { return expected > 0 ? static_cast<double>(matched) / expected : 1.0; }
+};
+
+struct KernelDrift {
+    std::string kernel;
+    size_t samples = 0;
+    size_t mismatches = 0;     // Outputs beyond tolerance (or a different argmax / bit)
+    double max_error = 0.0;
+    bool passed = false;
+};
+
+struct GoldenReport {
+    int corpus_version = 0;
+    std::vector<GoldenItemReport> items;
+    std::vector<KernelDrift> kernels;
+    bool passed = false;
+};
+
+// Read / write a manifest. Load returns false if it is missing or malformed.
+bool loadGoldenCorpus(const std::string& manifest_path, GoldenCorpus& corpus);
+bool saveGoldenCorpus(const std::string& manifest_path, const GoldenCorpus& corpus);
+
+// Replace every item's lines with what `engine` recognizes now
+void recordGoldenCorpus(OcrEngine& engine, GoldenCorpus& corpus);
+
+// Run the corpus `iterations` times per image (latency is the best run).
+// det_half_res runs detection with half-resolution post-processing, to
+// measure it against goldens recorded at full resolution.
+GoldenReport runGoldenCorpus(OcrEngine& engine, const GoldenCorpus& corpus,
+                             const GoldenTolerance& tolerance, int iterations = 1,
+                             bool det_half_res = false);
+
+// Optimized kernels vs reference implementations, fed from `images`
+std::vector<KernelDrift> checkKernelDrift(const std::vector<cv::Mat>& images, double max_error);
+
+std::string goldenReportToJson(const GoldenReport& report);
+
+#endif // GOLDEN_CORPUS_H
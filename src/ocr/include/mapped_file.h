@@ -0,0 +1,39 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file; an empty or missing file leaves the mapping empty and returns false
+    bool Open(const std::string& path);
+    void Close();
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool IsOpen() const { return data_ != nullptr; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Append bytes to a file and flush them to storage before returning.
+// The file is first truncated to `valid_size` so a torn tail from a crash is dropped.
+bool appendFileDurable(const std::string& path, uint64_t valid_size, const void* data, size_t size);
+
+// Write a whole file through a temporary and rename it into place
+bool replaceFileDurable(const std::string& path, const void* data, size_t size);
+
+// 64-bit FNV-1a, used for term hashes and record checksums
+uint64_t fnv1a64(const void* data, size_t size, uint64_t seed = 14695981039346656037ULL);
+
+#endif // MAPPED_FILE_H
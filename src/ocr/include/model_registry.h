@@ -0,0 +1,104 @@
+#ifndef MODEL_REGISTRY_H
+#define MODEL_REGISTRY_H
+
+#include "ocr_engine.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class LayoutModel;
+
+// Several OCR model sets and layout models in one process, keyed by id
+// (e.g. "ppocrv4_mobile_ch", "doclayout_l"). Models load on first Acquire
+// and share the ORT env and arena; when the resident total goes over the
+// memory budget, the least recently used idle models are unloaded.
+
+enum class ModelKind {
+    kOcr,     // det + rec + dictionary, served by an OcrEngine
+    kLayout,  // PP-DocLayout M or L, served by a LayoutModel
+};
+
+struct ModelSpec {
+    ModelKind kind = ModelKind::kOcr;
+    std::string det_model_path;
+    std::string rec_model_path;
+    std::string dict_path;
+    std::string layout_model_path;
+};
+
+struct ModelStatus {
+    std::string id;
+    ModelKind kind = ModelKind::kOcr;
+    bool loaded = false;
+    bool in_use = false;        // Held by a request, so not evictable
+    size_t resident_bytes = 0;  // Measured at the last load
+    uint64_t loads = 0;
+    uint64_t hits = 0;          // Acquires served without loading
+    uint64_t evictions = 0;
+};
+
+class ModelRegistry {
+public:
+    static ModelRegistry& GetInstance();
+
+    // Add or replace a model; replacing unloads the old one once idle
+    void Register(const std::string& id, const ModelSpec& spec);
+    bool Unregister(const std::string& id);
+
+    // Loaded model, or nullptr for unknown ids, kind mismatches and load
+    // failures. The model stays loaded while the pointer is held.
+    std::shared_ptr<OcrEngine> AcquireOcr(const std::string& id);
+    std::shared_ptr<LayoutModel> AcquireLayout(const std::string& id);
+
+    // 0 = unlimited. Lowering the budget evicts right away.
+    void SetMemoryBudget(size_t bytes);
+    size_t MemoryBudget();
+    size_t ResidentBytes();
+
+    std::vector<ModelStatus> Status();
+
+    // Drop every idle model (registrations are kept)
+    void UnloadAll();
+
+private:
+    ModelRegistry() = default;
+    ModelRegistry(const ModelRegistry&) = delete;
+    ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+    struct Entry {
+        ModelSpec spec;
+        std::shared_ptr<OcrEngine> ocr;
+        std::shared_ptr<LayoutModel> layout;
+        size_t resident_bytes = 0;
+        uint64_t last_used = 0;
+        uint64_t loads = 0;
+        uint64_t hits = 0;
+        uint64_t evictions = 0;
+
+        bool Loaded() const { return ocr || layout; }
+        bool InUse() const { return ocr.use_count() > 1 || layout.use_count() > 1; }
+    };
+
+    // Fill `ocr` or `layout`, loading the model if needed
+    bool Acquire(const std::string& id, ModelKind kind,
+                 std::shared_ptr<OcrEngine>* ocr, std::shared_ptr<LayoutModel>* layout);
+    // Hand out an already-loaded model and touch its LRU stamp; mutex_ held
+    bool TakeLoaded(Entry& entry, std::shared_ptr<OcrEngine>* ocr,
+                    std::shared_ptr<LayoutModel>* layout);
+    // Unload LRU idle models until `incoming` more bytes fit; mutex_ held
+    void EvictFor(size_t incoming, const std::string& keep);
+    size_t ResidentBytesLocked() const;
+
+    std::mutex mutex_;       // Guards entries_ and the counters
+    std::mutex load_mutex_;  // Serializes loads so RSS deltas are per model
+    std::unordered_map<std::string, Entry> entries_;
+    size_t budget_ = 0;
+    uint64_t clock_ = 0;
+};
+
+const char* modelKindName(ModelKind kind);
+
+#endif // MODEL_REGISTRY_H
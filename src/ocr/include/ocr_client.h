@@ -0,0 +1,105 @@
+#ifndef OCR_CLIENT_H
+#define OCR_CLIENT_H
+
+#include "ocr_engine.h"
+#include "executor.h"
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define OCR_KIT_HAS_COROUTINES 1
+#endif
+
+// C++ embedding API: typed requests and results, no JSON, no thread parked
+// per call. Requests run on a pluggable Executor; callers get a future, a
+// callback, or (C++20) co_await the result.
+
+enum class OcrError {
+    kNone,
+    kNotInitialized,   // Engine has no models loaded
+    kImageLoadFailed,  // image_path could not be decoded
+    kInvalidInput,     // Neither an image nor a path given
+    kModelNotFound,    // model_id unknown to the registry or failed to load
+    kInternal,         // The pipeline threw; see OcrResponse::message
+};
+
+const char* ocrErrorName(OcrError error);
+
+struct OcrRequest {
+    cv::Mat image;           // BGR; used when set
+    std::string image_path;  // Otherwise loaded on the executor thread
+    OcrOptions options;      // Thresholds, detector backend, priority
+    std::string model_id;    // ModelRegistry id; empty = the client's engine
+};
+
+struct OcrResponse {
+    OcrError error = OcrError::kNone;
+    TextLines lines;
+    DetectorBackend detector = DetectorBackend::kNeural;  // Backend that ran
+    int image_width = 0;
+    int image_height = 0;
+    double time_ms = 0.0;    // Queue wait + processing
+    std::string message;     // What the exception said (kInternal only)
+
+    bool ok() const { return error == OcrError::kNone; }
+};
+
+// Handle to an engine plus the executor its requests run on. All methods are
+// thread-safe; queued requests may outlive the client (not the engine).
+class OcrClient {
+public:
+    using Callback = std::function<void(OcrResponse)>;
+
+    // Defaults to the engine singleton and a two-thread pool
+    explicit OcrClient(std::shared_ptr<Executor> executor = nullptr,
+                       OcrEngine& engine = OcrEngine::GetInstance());
+
+    // Full OCR; the future becomes ready on an executor thread. An exception
+    // thrown by the pipeline is rethrown from get().
+    std::future<OcrResponse> Submit(OcrRequest request);
+
+    // Full OCR; `done` runs on the executor thread that finished the request.
+    // A pipeline exception arrives as OcrError::kInternal; one thrown by
+    // `done` itself is logged and dropped.
+    void Submit(OcrRequest request, Callback done);
+
+    // Run `request` synchronously on the calling thread
+    OcrResponse Run(const OcrRequest& request);
+
+    Executor& executor() { return *executor_; }
+
+#ifdef OCR_KIT_HAS_COROUTINES
+    // co_await client.Async(request). The coroutine resumes on the executor
+    // thread that finished the request.
+    class Awaitable {
+    public:
+        Awaitable(OcrClient& client, OcrRequest request)
+            : client_(client), request_(std::move(request)) {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            client_.Submit(std::move(request_), [this, handle](OcrResponse response) {
+                response_ = std::move(response);
+                handle.resume();
+            });
+        }
+        OcrResponse await_resume() { return std::move(response_); }
+
+    private:
+        OcrClient& client_;
+        OcrRequest request_;
+        OcrResponse response_;
+    };
+
+    Awaitable Async(OcrRequest request) { return Awaitable(*this, std::move(request)); }
+#endif
+
+private:
+    std::shared_ptr<Executor> executor_;
+    OcrEngine& engine_;
+};
+
+#endif // OCR_CLIENT_H
@@ -3,27 +3,123 @@
 
 #include "utils.h"
 #include "config_manager.h"
+#include "pipeline_kernels.h"
+#include "tensor_buffer.h"
+#include "thread_config.h"
+#include "classic_detector.h"
+#include "request_scheduler.h"
+#include "text_arena.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // OCR text line result structure
 struct TextLineResult {
-    float x1, y1, x2, y2;  // Bounding box coordinates (in original image space)
-    float score;           // Confidence score
-    std::string text;      // Recognized text content
+    float x1, y1, x2, y2;   // Bounding box coordinates (in original image space)
+    float score;            // Confidence score
+    std::string_view text;  // Recognized text content, owned by the TextLines holding this line
+};
+
+// Lines of one request, their text packed into the list's own arena.
+// Moves keep every view valid; copies re-store the text in the new arena.
+class TextLines {
+public:
+    TextLines() = default;
+    TextLines(TextLines&&) noexcept = default;
+    TextLines& operator=(TextLines&&) noexcept = default;
+    TextLines(const TextLines& other);
+    TextLines& operator=(const TextLines& other);
+
+    // Room for `lines` lines holding `text_bytes` of text in total
+    void Reserve(size_t lines, size_t text_bytes = 0);
+
+    // Append a line; `text` is copied into the arena
+    TextLineResult& Add(float x1, float y1, float x2, float y2, float score, std::string_view text);
+    TextLineResult& Add(const TextLineResult& line) {
+        return Add(line.x1, line.y1, line.x2, line.y2, line.score, line.text);
+    }
+
+    void Clear();
+
+    size_t size() const { return lines_.size(); }
+    bool empty() const { return lines_.empty(); }
+    // Coordinates may be edited in place; text is reassigned through Add only
+    TextLineResult& operator[](size_t i) { return lines_[i]; }
+    const TextLineResult& operator[](size_t i) const { return lines_[i]; }
+    std::vector<TextLineResult>::iterator begin() { return lines_.begin(); }
+    std::vector<TextLineResult>::iterator end() { return lines_.end(); }
+    std::vector<TextLineResult>::const_iterator begin() const { return lines_.begin(); }
+    std::vector<TextLineResult>::const_iterator end() const { return lines_.end(); }
+
+    size_t TextBytes() const { return arena_.BytesUsed(); }
+
+private:
+    std::vector<TextLineResult> lines_;
+    TextArena arena_;
 };
 
 // Text box from detection (4 corner points)
 struct TextBox {
-    std::vector<cv::Point2f> points;  // 4 corner points (clockwise from top-left)
+    std::array<cv::Point2f, 4> points;  // Clockwise from top-left
     float score;
 };
 
+// Raw det model output for one image. Boxes can be re-derived from it at any
+// threshold without running the model again (see PageCache). The values are
+// copied out of the output tensor, whose memory belongs to the ORT env's
+// arena, so a map outlives the engine and the env that produced it.
+struct DetMap {
+    std::vector<float> values;      // [height x width], before activation
+    int height = 0;                 // Map size, the model input resolution
+    int width = 0;
+    float scale_x = 1.0f;           // Image -> map
+    float scale_y = 1.0f;
+    int image_width = 0;
+    int image_height = 0;
+
+    bool empty() const { return values.empty(); }
+    size_t Bytes() const { return static_cast<size_t>(height) * width * sizeof(float); }
+};
+
+// Per-request OCR settings
+struct OcrOptions {
+    float det_threshold = 0.3f;
+    float rec_threshold = 0.5f;
+    DetectorBackend detector = DetectorBackend::kNeural;
+    RequestPriority priority = RequestPriority::kInteractive;  // Applied by the caller's RequestScope
+    bool det_half_res = false;  // Find det contours at half resolution (maps of 512x512 and up)
+    bool merge_fragments = false;  // Join collinear det boxes into lines before recognition (box_merge.h)
+};
+
+// Two-model recognition: every line goes through the engine's rec model and
+// only the unsure ones are re-run through a slower, more accurate one
+struct RecCascadeConfig {
+    float min_mean_score = 0.9f;  // Escalate lines whose mean char probability is below this
+    float min_char_score = 0.5f;  // ... or that have any one character below this
+};
+
+// Cumulative since the cascade was enabled or the last reset
+struct RecCascadeStats {
+    uint64_t lines = 0;          // Lines recognized by the fast model
+    uint64_t escalated = 0;      // Of those, re-run through the accurate model
+    uint64_t changed = 0;        // Escalated lines whose text the accurate model changed
+    uint64_t escalation_us = 0;  // Time spent in the accurate pass
+};
+
 // OCR Engine class - manages detection and recognition models
 class OcrEngine {
 public:
+    // Process default model set; ModelRegistry owns any further ones
     static OcrEngine& GetInstance();
 
+    OcrEngine() = default;
+    ~OcrEngine();
+    OcrEngine(const OcrEngine&) = delete;
+    OcrEngine& operator=(const OcrEngine&) = delete;
+
     // Initialize with model paths and dictionary path
     void Init(const std::string& det_model_path,
               const std::string& rec_model_path,
@@ -33,57 +129,150 @@ public:
     void Release();
 
     // Full OCR pipeline: detect + recognize
-    std::vector<TextLineResult> RecognizeText(const cv::Mat& image, float det_threshold = 0.3f, float rec_threshold = 0.5f);
+    TextLines RecognizeText(const cv::Mat& image, float det_threshold = 0.3f, float rec_threshold = 0.5f);
+
+    // Recognition only - for boxes already detected on this image.
+    // `line_boxes` receives the index in `boxes` of each returned line.
+    // `decoded` is false when the boxes could not be read at all (engine not
+    // initialized, model error), as opposed to reading as nothing.
+    TextLines RecognizeBoxes(const cv::Mat& image, const std::vector<TextBox>& boxes,
+                             float rec_threshold = 0.5f, std::vector<size_t>* line_boxes = nullptr,
+                             bool* decoded = nullptr);
+
+    // Full OCR pipeline with per-request options; `used` receives the detector that ran
+    TextLines RecognizeText(const cv::Mat& image, const OcrOptions& options,
+                            DetectorBackend* used = nullptr);
 
-    // Detection only - returns text boxes
-    std::vector<TextBox> DetectText(const cv::Mat& image, float threshold = 0.3f);
+    // Detection only - returns text boxes. half_res_post finds and scores
+    // contours on a half-resolution map and refines only the box edges on the
+    // full map.
+    std::vector<TextBox> DetectText(const cv::Mat& image, float threshold = 0.3f, bool half_res_post = false);
+
+    // Detection split in two: the model pass, then box extraction at a threshold
+    bool DetectMap(const cv::Mat& image, DetMap& map);
+    std::vector<TextBox> DetectFromMap(const DetMap& map, float threshold = 0.3f, bool half_res_post = false);
+
+    // Detection with a selectable backend (kAuto resolves from image statistics)
+    std::vector<TextBox> DetectText(const cv::Mat& image, const OcrOptions& options,
+                                    DetectorBackend* used = nullptr);
 
     // Recognition only - for a single cropped text region
     std::pair<std::string, float> RecognizeRegion(const cv::Mat& region);
 
     bool IsInitialized() const { return initialized_; }
 
-private:
-    OcrEngine() = default;
-    ~OcrEngine();
-    OcrEngine(const OcrEngine&) = delete;
-    OcrEngine& operator=(const OcrEngine&) = delete;
+    // Load the accurate rec model for the cascade (after Init; it must share
+    // the dictionary). Replaces any earlier one. Call between requests, as Init.
+    bool EnableRecCascade(const std::string& rec_model_path, const RecCascadeConfig& config = RecCascadeConfig());
+    void DisableRecCascade();
+    bool RecCascadeEnabled() const { return cascade_session_ != nullptr; }
+    RecCascadeStats CascadeStats() const;
+    void ResetCascadeStats();
+
+    // Thread counts and CPU pinning for the det and rec sessions.
+    // Takes effect at the next Init.
+    void SetThreadConfig(const ThreadPoolConfig& det, const ThreadPoolConfig& rec);
+    const ThreadPoolConfig& DetThreadConfig() const { return det_threads_; }
+    const ThreadPoolConfig& RecThreadConfig() const { return rec_threads_; }
 
-    // Session management
+private:
+    // Session management (env is the shared one from ort_env.h)
     Ort::Env* env_ = nullptr;
     Ort::SessionOptions* det_session_options_ = nullptr;
     Ort::SessionOptions* rec_session_options_ = nullptr;
     Ort::Session* det_session_ = nullptr;
     Ort::Session* rec_session_ = nullptr;
+    Ort::Session* cascade_session_ = nullptr;  // Accurate rec model, see EnableRecCascade
 
     // Character dictionary for CTC decoding
     std::vector<std::string> dictionary_;
 
     bool initialized_ = false;
 
-    // Preprocessing
-    cv::Mat PreprocessForDetection(const cv::Mat& image, float& scale_x, float& scale_y);
-    cv::Mat PreprocessForRecognition(const cv::Mat& region);
+    // Output activations, probed once at Init (or EnableRecCascade) to select
+    // kernel instantiations; never kUnresolved afterwards and read-only
+    OutputActivation det_activation_ = OutputActivation::kUnresolved;
+    OutputActivation rec_activation_ = OutputActivation::kUnresolved;
+    OutputActivation cascade_activation_ = OutputActivation::kUnresolved;
+
+    RecCascadeConfig cascade_config_;
+    std::atomic<uint64_t> cascade_lines_{0};
+    std::atomic<uint64_t> cascade_escalated_{0};
+    std::atomic<uint64_t> cascade_changed_{0};
+    std::atomic<uint64_t> cascade_us_{0};
+
+    ThreadPoolConfig det_threads_;
+    ThreadPoolConfig rec_threads_;
+
+    // Aligned input buffers, reused across calls
+    TensorBufferPool det_inputs_;
+    TensorBufferPool rec_inputs_;
+
+    // Preprocessing: pack the model input into `input` and return a blob view of it
+    cv::Mat PreprocessForDetection(const cv::Mat& image, float& scale_x, float& scale_y, TensorBuffer& input);
+    cv::Mat PreprocessForRecognition(const cv::Mat& region, TensorBuffer& input);
+
+    // Batched recognition: crops resized to the model height and right-padded
+    // to the widest one, packed as [N, 3, 48, W]
+    struct RecBatch {
+        std::vector<size_t> box_indices;  // Boxes in batch order (empty crops left out)
+        int width = 0;
+        int empty_regions = 0;
+        std::string text;                 // Decoded text of every box, back to back
+        std::vector<uint32_t> text_ends;  // End offset in `text` per box
+        std::vector<float> scores;
+        std::vector<float> min_scores;    // Least probable character per box
+    };
+    // Where crops come from: axis-aligned slices of one page (the image, or
+    // the image rotated once by the dominant text angle), with boxes that
+    // disagree with that angle warped on their own
+    struct CropPlan {
+        cv::Mat page;
+        std::vector<cv::Rect> slices;  // Per box, in `page`; empty = warp the box
+    };
+    static CropPlan PlanCrops(const cv::Mat& image, const std::vector<TextBox>& boxes);
+
+    RecBatch PrepareRecBatch(const cv::Mat& image, const std::vector<TextBox>& boxes, const CropPlan& plan,
+                             const size_t* order, size_t count, TensorBuffer& input);
+    // `cascade` selects the accurate model instead of the engine's rec model
+    Ort::Value RunRecBatch(const RecBatch& batch, TensorBuffer& input, bool cascade = false);
+    void DecodeRecBatch(RecBatch& batch, const Ort::Value& output, bool cascade = false);
+    // Re-run the lines the cascade thresholds flag and point their text and
+    // scores at the accurate reads, held in `batches`
+    void EscalateRecLines(const cv::Mat& image, const std::vector<TextBox>& boxes, const CropPlan& plan,
+                          const std::vector<float>& min_scores, std::vector<RecBatch>& batches,
+                          std::vector<std::string_view>& texts, std::vector<float>& scores,
+                          TensorBuffer& input);
 
     // Post-processing
     std::vector<TextBox> DBPostProcess(const float* output_data, int height, int width,
                                         float scale_x, float scale_y,
                                         int orig_width, int orig_height,
-                                        float threshold = 0.3f, float box_threshold = 0.5f);
-    std::pair<std::string, float> CTCDecode(const float* output_data, int seq_len, int vocab_size);
+                                        float threshold = 0.3f, float box_threshold = 0.5f,
+                                        bool half_res = false);
+    // Append the decoded text to `text`; returns the mean character probability.
+    // `min_score` receives the least probable character's (0 for no text).
+    float CTCDecode(const float* output_data, int seq_len, int vocab_size, std::string& text,
+                    float* min_score = nullptr, const OutputActivation* activation = nullptr);
+    template <OutputActivation Act>
+    float CTCDecodeImpl(const float* output_data, int seq_len, int vocab_size, std::string& text,
+                        float* min_score);
 
     // Utility
     cv::Mat CropTextRegion(const cv::Mat& image, const TextBox& box);
     void LoadDictionary(const std::string& dict_path);
+    void ResolveOutputActivations();
+    // Run a rec model on a blank crop; returns its activation and vocab size
+    static OutputActivation ProbeRecOutput(Ort::Session& session, int& vocab_size);
 };
 
 // Legacy function for backward compatibility
-std::vector<TextLineResult> recognizeText(const cv::Mat& image, float conf_threshold = 0.5);
+TextLines recognizeText(const cv::Mat& image, float conf_threshold = 0.5);
 
 // Get full text from all text lines
-std::string getFullText(const std::vector<TextLineResult>& results);
+std::string getFullText(const TextLines& results);
 
 // Convert results to JSON
-std::string ocrResultsToJson(const std::vector<TextLineResult>& results);
+std::string ocrResultsToJson(const TextLines& results);
 
 #endif // OCR_ENGINE_H
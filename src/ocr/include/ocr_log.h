@@ -0,0 +1,97 @@
+#ifndef OCR_LOG_H
+#define OCR_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Leveled logging into an in-memory ring that is dumped on demand.
+//
+// A disabled level costs nothing: levels above OCR_KIT_LOG_MAX_LEVEL are
+// compiled out, and below it a relaxed load of the runtime level guards the
+// call, so format arguments are only evaluated for messages that are kept.
+// Kept messages are formatted into a fixed slot of a lock-free ring. Errors
+// and warnings are also echoed to logcat / os_log / stderr; info and debug
+// stay in the ring unless the echo level is raised.
+
+enum class LogLevel : int {
+    kError = 0,
+    kWarn = 1,
+    kInfo = 2,
+    kDebug = 3,
+};
+
+// Highest level compiled in: debug builds keep everything, NDEBUG builds drop debug
+#ifndef OCR_KIT_LOG_MAX_LEVEL
+#ifdef NDEBUG
+#define OCR_KIT_LOG_MAX_LEVEL 2
+#else
+#define OCR_KIT_LOG_MAX_LEVEL 3
+#endif
+#endif
+
+const size_t LOG_RING_CAPACITY = 512;  // Entries kept; older ones are overwritten
+const size_t LOG_MESSAGE_BYTES = 192;  // Longer messages are truncated
+
+struct LogEntry {
+    uint64_t seq = 0;      // Order of the Write call, process-wide
+    LogLevel level = LogLevel::kDebug;
+    int64_t time_us = 0;   // Wall clock, microseconds since the epoch
+    uint32_t thread = 0;   // Hash of the writing thread's id
+    std::string text;
+};
+
+class OcrLog {
+public:
+    // Runtime level; starts at kInfo. Levels above OCR_KIT_LOG_MAX_LEVEL stay off.
+    static void SetLevel(LogLevel level) { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    static LogLevel Level() { return static_cast<LogLevel>(level_.load(std::memory_order_relaxed)); }
+    static bool Enabled(LogLevel level) {
+        return static_cast<int>(level) <= level_.load(std::memory_order_relaxed);
+    }
+
+    // Also forward kept messages at `level` or more severe to the platform log
+    // (stderr on desktop); starts at kWarn
+    static void SetEchoLevel(LogLevel level) { echo_level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    static LogLevel EchoLevel() { return static_cast<LogLevel>(echo_level_.load(std::memory_order_relaxed)); }
+
+    // printf-style; use the LOG* macros so disabled levels skip the call
+    static void Write(LogLevel level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    // Up to `max_entries` of the most recent entries, oldest first. Entries
+    // overwritten while being read are left out.
+    static std::vector<LogEntry> Dump(size_t max_entries = LOG_RING_CAPACITY);
+    // Messages written so far, including overwritten ones
+    static uint64_t Written();
+    // Messages lost because their slot was still being written a ring earlier
+    static uint64_t Dropped();
+    // Hide everything written so far from Dump
+    static void Clear();
+
+private:
+    static inline std::atomic<int> level_{static_cast<int>(LogLevel::kInfo)};
+    static inline std::atomic<int> echo_level_{static_cast<int>(LogLevel::kWarn)};
+};
+
+const char* logLevelName(LogLevel level);
+// "error" / "warn" / "info" / "debug"; returns false for unknown names
+bool logLevelFromName(const std::string& name, LogLevel& level);
+
+#define OCR_LOG_ENABLED(level) \
+    (static_cast<int>(level) <= OCR_KIT_LOG_MAX_LEVEL && OcrLog::Enabled(level))
+
+#define OCR_LOG(level, ...)                      \
+    do {                                         \
+        if (OCR_LOG_ENABLED(level)) {            \
+            OcrLog::Write(level, __VA_ARGS__);   \
+        }                                        \
+    } while (0)
+
+#define LOGE(...) OCR_LOG(LogLevel::kError, __VA_ARGS__)
+#define LOGW(...) OCR_LOG(LogLevel::kWarn, __VA_ARGS__)
+#define LOGI(...) OCR_LOG(LogLevel::kInfo, __VA_ARGS__)
+#define LOGD(...) OCR_LOG(LogLevel::kDebug, __VA_ARGS__)
+
+#endif // OCR_LOG_H
@@ -0,0 +1,22 @@
+#ifndef ORT_ENV_H
+#define ORT_ENV_H
+
+#include <onnxruntime_cxx_api.h>
+
+// Process-wide ONNX Runtime environment shared by the OCR and layout sessions.
+// It owns one CPU arena registered with the env, so all sessions draw
+// intermediate tensors from a single pool instead of one arena each.
+
+// Create the environment on first use; every call must be paired with ReleaseOrtEnv()
+Ort::Env& AcquireOrtEnv();
+
+// Destroy the environment (and its arena) once the last user releases it
+void ReleaseOrtEnv();
+
+// Point a session at the shared arena. Call before creating the session.
+void UseSharedAllocator(Ort::SessionOptions& options);
+
+// CPU memory info for wrapping engine-owned input buffers
+const Ort::MemoryInfo& CpuMemoryInfo();
+
+#endif // ORT_ENV_H
@@ -0,0 +1,117 @@
+#ifndef PAGE_CACHE_H
+#define PAGE_CACHE_H
+
+#include "ocr_engine.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Pages kept open for repeated OCR at changing thresholds, e.g. a review UI
+// where operators tune det_threshold / rec_threshold and re-run. A page holds
+// its decoded image, the det probability map and the read of every box seen
+// so far, so a new det_threshold only re-runs DB post-processing plus rec for
+// boxes that weren't there before, and a new rec_threshold runs no model at
+// all. Reads no box has matched for a few requests are dropped, so a page
+// holds the reads of its recent thresholds only. When the pages' total goes
+// over the memory budget, the least recently used ones are dropped and their
+// handles stop resolving.
+
+struct PageInfo {
+    std::string model_id;  // Registry model the page was opened with; empty = default engine
+    DetectorBackend detector = DetectorBackend::kNeural;  // Resolved at Open
+    int width = 0;
+    int height = 0;
+    size_t bytes = 0;      // Image, det map and cached reads, as of the last request
+};
+
+// What one Recognize call cost
+struct PageOcrStats {
+    size_t boxes = 0;       // Boxes at this det threshold
+    size_t reused = 0;      // Served from earlier reads
+    size_t recognized = 0;  // Sent to the rec model
+    size_t failed = 0;      // Of those, not read (model error); retried next request
+};
+
+struct PageCacheStats {
+    size_t pages = 0;
+    size_t bytes = 0;
+    size_t budget = 0;
+    uint64_t opens = 0;
+    uint64_t evictions = 0;
+    uint64_t reused = 0;      // Box reads served from cache, cumulative
+    uint64_t recognized = 0;  // Box reads that ran the rec model, cumulative
+};
+
+class PageCache {
+public:
+    static PageCache& GetInstance();
+
+    // Run detection on `image` once and keep the page; returns its handle, or
+    // 0 when detection failed. `options.detector` is resolved here (kAuto) and
+    // fixed for the page: the classic backend has no map, its boxes are kept.
+    int Open(OcrEngine& engine, const cv::Mat& image, const OcrOptions& options,
+             const std::string& model_id = std::string());
+
+    // Lines at this request's thresholds (det_half_res and merge_fragments
+    // apply too). False when the handle was closed or evicted. `engine` must
+    // be the one the page was opened with (see PageInfo::model_id).
+    bool Recognize(int page, OcrEngine& engine, const OcrOptions& options, TextLines& lines,
+                   PageOcrStats* stats = nullptr);
+
+    bool Info(int page, PageInfo& info);
+    bool Close(int page);
+    void CloseAll();
+
+    // 0 = unlimited. Lowering the budget evicts right away.
+    void SetMemoryBudget(size_t bytes);
+    PageCacheStats Stats();
+
+private:
+    PageCache() = default;
+    PageCache(const PageCache&) = delete;
+    PageCache& operator=(const PageCache&) = delete;
+
+    // One box read at some earlier det threshold
+    struct Read {
+        TextBox box;
+        std::string text;  // Empty when the box read as nothing
+        float score = 0.0f;
+        uint64_t last_matched = 0;  // Page request that last used it
+    };
+
+    struct Page {
+        std::string model_id;
+        DetectorBackend detector = DetectorBackend::kNeural;
+        cv::Mat image;
+        DetMap map;                       // Neural backend
+        std::vector<TextBox> fixed_boxes;  // Classic backend, threshold-independent
+        std::vector<Read> reads;
+        uint64_t requests = 0;  // Recognize calls so far
+
+        std::mutex mutex;  // Serializes requests on this page; guards reads and requests
+        size_t bytes = 0;
+        uint64_t last_used = 0;
+
+        size_t Bytes() const;
+    };
+
+    std::shared_ptr<Page> Find(int page);
+    // Drop LRU pages other than `keep` until the total fits; mutex_ held
+    void EvictFor(int keep);
+
+    std::mutex mutex_;  // Guards pages_, the LRU stamps, byte totals and counters
+    std::unordered_map<int, std::shared_ptr<Page>> pages_;
+    size_t budget_ = 64 * 1024 * 1024;
+    size_t bytes_ = 0;
+    uint64_t clock_ = 0;
+    int next_handle_ = 1;
+    uint64_t opens_ = 0;
+    uint64_t evictions_ = 0;
+    uint64_t reused_ = 0;
+    uint64_t recognized_ = 0;
+};
+
+#endif // PAGE_CACHE_H
@@ -0,0 +1,63 @@
+#ifndef PDF_OCR_H
+#define PDF_OCR_H
+
+#include "ocr_engine.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// PDF input needs PDFium (prebuilt, linked when the build sets
+// OCR_KIT_WITH_PDFIUM). Without it every call reports kUnsupported.
+
+// PDF OCR options
+struct PdfOcrOptions {
+    int first_page = 0;            // 0-based
+    int page_count = -1;           // -1 = through the last page
+    bool use_text_layer = true;    // Take text straight from pages that have a usable text layer
+    int min_text_chars = 16;       // Fewer visible characters: treat the page as image-only
+    int render_long_side = 1920;   // Rasterized page size (long side, px) for image-only pages
+    OcrOptions ocr;                // Detection / recognition settings for rasterized pages
+};
+
+// Where a page's lines came from
+enum class PdfPageSource {
+    kTextLayer,  // Extracted from the PDF, no det/rec
+    kOcr,        // Rasterized and recognized
+};
+
+// Result of one page. Line boxes are in PDF points (1/72 in), origin top-left,
+// whichever source produced them.
+struct PdfPageResult {
+    int page = 0;
+    float width_pt = 0.0f;
+    float height_pt = 0.0f;
+    PdfPageSource source = PdfPageSource::kTextLayer;
+    float dpi = 0.0f;                   // Render resolution (kOcr only)
+    double time_ms = 0.0;
+    TextLines lines;                    // Score 1.0 for text-layer lines
+};
+
+enum class PdfStatus {
+    kOk,
+    kUnsupported,       // Built without PDFium
+    kLoadFailed,        // Missing file or not a PDF
+    kPasswordRequired,  // Encrypted and the password is missing or wrong
+};
+
+struct PdfOcrStats {
+    int document_pages = 0;
+    int pages_text_layer = 0;
+    int pages_ocr = 0;
+};
+
+const char* pdfPageSourceName(PdfPageSource source);
+
+// Process pages one at a time, handing each result to `on_page` before the
+// next page is loaded, so memory stays at one page however long the document.
+// Image-only pages are recognized with `engine`, which must outlive the call.
+PdfStatus recognizePdf(OcrEngine& engine, const std::string& pdf_path, const std::string& password,
+                       const PdfOcrOptions& options,
+                       const std::function<void(const PdfPageResult&)>& on_page,
+                       PdfOcrStats* stats = nullptr);
+
+#endif // PDF_OCR_H
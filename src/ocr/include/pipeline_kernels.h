@@ -0,0 +1,282 @@
+#ifndef PIPELINE_KERNELS_H
+#define PIPELINE_KERNELS_H
+
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+// Activation the model graph leaves for us to apply on its raw output.
+// Resolved once per model at Init, then used to pick a kernel instantiation.
+enum class OutputActivation {
+    kUnresolved,  // Not probed yet (only before Init)
+    kNone,        // Output is already probabilities
+    kSigmoid,     // DB detection head emits logits
+    kSoftmax,     // CTC recognition head emits logits
+};
+
+// ========================
+// Pipeline descriptors
+// ========================
+//
+// Each descriptor fixes channel order and normalization at compile time.
+// (x / 255 - mean[c]) / std[c] is folded into x * scale[c] + bias[c].
+
+// PP-OCRv4 det: BGR input -> RGB, ImageNet mean/std
+struct DetInputPipeline {
+    static constexpr bool kSwapRB = true;
+    static constexpr float kMean[3] = {0.485f, 0.456f, 0.406f};
+    static constexpr float kStd[3] = {0.229f, 0.224f, 0.225f};
+};
+
+// PP-OCRv4 rec: keeps BGR, (x / 255 - 0.5) / 0.5
+struct RecInputPipeline {
+    static constexpr bool kSwapRB = false;
+    static constexpr float kMean[3] = {0.5f, 0.5f, 0.5f};
+    static constexpr float kStd[3] = {0.5f, 0.5f, 0.5f};
+};
+
+// PP-DocLayout: input already converted to RGB, scale to [0, 1] only
+struct LayoutInputPipeline {
+    static constexpr bool kSwapRB = false;
+    static constexpr float kMean[3] = {0.0f, 0.0f, 0.0f};
+    static constexpr float kStd[3] = {1.0f, 1.0f, 1.0f};
+};
+
+template <typename Pipeline>
+struct PipelineCoefficients {
+    static constexpr float Scale(int c) { return 1.0f / (255.0f * Pipeline::kStd[c]); }
+    static constexpr float Bias(int c) { return -Pipeline::kMean[c] / Pipeline::kStd[c]; }
+    static constexpr int SourceChannel(int c) { return Pipeline::kSwapRB ? 2 - c : c; }
+};
+
+// ========================
+// Preprocessing kernels
+// ========================
+
+// Packed 8-bit 3-channel HWC -> normalized planar CHW float in one pass.
+// dst must hold 3 * src.rows * src.cols floats.
+template <typename Pipeline>
+inline void PackToPlanar(const cv::Mat& src, float* dst) {
+    using K = PipelineCoefficients<Pipeline>;
+    constexpr int c0 = K::SourceChannel(0);
+    constexpr int c1 = K::SourceChannel(1);
+    constexpr int c2 = K::SourceChannel(2);
+    constexpr float s0 = K::Scale(0), s1 = K::Scale(1), s2 = K::Scale(2);
+    constexpr float b0 = K::Bias(0), b1 = K::Bias(1), b2 = K::Bias(2);
+
+    const int rows = src.rows;
+    const int cols = src.cols;
+    const size_t plane = static_cast<size_t>(rows) * cols;
+
+    for (int y = 0; y < rows; y++) {
+        const uint8_t* p = src.ptr<uint8_t>(y);
+        float* o0 = dst + static_cast<size_t>(y) * cols;
+        float* o1 = o0 + plane;
+        float* o2 = o1 + plane;
+        for (int x = 0; x < cols; x++) {
+            o0[x] = p[3 * x + c0] * s0 + b0;
+            o1[x] = p[3 * x + c1] * s1 + b1;
+            o2[x] = p[3 * x + c2] * s2 + b2;
+        }
+    }
+}
+
+// Same, into planes `width` floats wide (width >= src.cols). Columns past
+// src.cols are 0, i.e. padding in normalized space, which is what batched
+// recognition pads narrower crops with.
+template <typename Pipeline>
+inline void PackToPlanarPadded(const cv::Mat& src, float* dst, int width) {
+    using K = PipelineCoefficients<Pipeline>;
+    constexpr int c0 = K::SourceChannel(0);
+    constexpr int c1 = K::SourceChannel(1);
+    constexpr int c2 = K::SourceChannel(2);
+    constexpr float s0 = K::Scale(0), s1 = K::Scale(1), s2 = K::Scale(2);
+    constexpr float b0 = K::Bias(0), b1 = K::Bias(1), b2 = K::Bias(2);
+
+    const int rows = src.rows;
+    const int cols = std::min(src.cols, width);
+    const size_t plane = static_cast<size_t>(rows) * width;
+
+    for (int y = 0; y < rows; y++) {
+        const uint8_t* p = src.ptr<uint8_t>(y);
+        float* o0 = dst + static_cast<size_t>(y) * width;
+        float* o1 = o0 + plane;
+        float* o2 = o1 + plane;
+        for (int x = 0; x < cols; x++) {
+            o0[x] = p[3 * x + c0] * s0 + b0;
+            o1[x] = p[3 * x + c1] * s1 + b1;
+            o2[x] = p[3 * x + c2] * s2 + b2;
+        }
+        std::fill(o0 + cols, o0 + width, 0.0f);
+        std::fill(o1 + cols, o1 + width, 0.0f);
+        std::fill(o2 + cols, o2 + width, 0.0f);
+    }
+}
+
+// Allocate a [1, 3, H, W] blob and fill it with PackToPlanar
+template <typename Pipeline>
+inline cv::Mat MakeInputBlob(const cv::Mat& src) {
+    const int dims[4] = {1, 3, src.rows, src.cols};
+    cv::Mat blob(4, dims, CV_32F);
+    PackToPlanar<Pipeline>(src, blob.ptr<float>());
+    return blob;
+}
+
+// Same, packed into caller-owned storage of at least 3 * H * W floats
+template <typename Pipeline>
+inline cv::Mat MakeInputBlob(const cv::Mat& src, float* dst) {
+    const int dims[4] = {1, 3, src.rows, src.cols};
+    PackToPlanar<Pipeline>(src, dst);
+    return cv::Mat(4, dims, CV_32F, dst);
+}
+
+// ========================
+// Post-processing kernels
+// ========================
+
+template <OutputActivation Act>
+inline float Activate(float v) {
+    if constexpr (Act == OutputActivation::kSigmoid) {
+        return 1.0f / (1.0f + std::exp(-v));
+    } else {
+        return v;
+    }
+}
+
+// Raw-output value equivalent to probability `threshold`, so a map can be
+// binarized without activating it: sigmoid(x) > t  <=>  x > log(t / (1 - t))
+template <OutputActivation Act>
+inline float RawThreshold(float threshold) {
+    if constexpr (Act == OutputActivation::kSigmoid) {
+        if (threshold <= 0.0f) {
+            return -std::numeric_limits<float>::infinity();
+        }
+        if (threshold >= 1.0f) {
+            return std::numeric_limits<float>::infinity();
+        }
+        return std::log(threshold / (1.0f - threshold));
+    } else {
+        return threshold;
+    }
+}
+
+// dst[i] = src[i] > cut ? 255 : 0 in one pass, vectorized with OpenCV universal intrinsics
+inline void BinarizeAbove(const float* src, uint8_t* dst, size_t n, float cut) {
+    size_t i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const int lanes32 = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 vcut = cv::vx_setall_f32(cut);
+    for (; i + lanes <= n; i += lanes) {
+        cv::v_uint32 m0 = cv::v_reinterpret_as_u32(cv::v_gt(cv::vx_load(src + i), vcut));
+        cv::v_uint32 m1 = cv::v_reinterpret_as_u32(cv::v_gt(cv::vx_load(src + i + lanes32), vcut));
+        cv::v_uint32 m2 = cv::v_reinterpret_as_u32(cv::v_gt(cv::vx_load(src + i + 2 * lanes32), vcut));
+        cv::v_uint32 m3 = cv::v_reinterpret_as_u32(cv::v_gt(cv::vx_load(src + i + 3 * lanes32), vcut));
+        cv::v_store(dst + i, cv::v_pack_b(m0, m1, m2, m3));
+    }
+    cv::vx_cleanup();
+#endif
+    for (; i < n; i++) {
+        dst[i] = src[i] > cut ? 255 : 0;
+    }
+}
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+// Max over the pairs src[2 * x], src[2 * x + 1], one lane per pair
+inline cv::v_float32 PairPeak(const float* src) {
+    cv::v_float32 a, b;
+    cv::v_load_deinterleave(src, a, b);
+    return cv::v_max(a, b);
+}
+#endif
+
+// Half-resolution binary map of a [rows x cols] map: dst (y, x) is 255 when
+// src (2y, 2x) or src (2y, 2x + 1) is above `cut`. Only even rows are read, so
+// half the map's cache lines are touched; a region two or more rows tall always
+// shows up. dst is ((rows + 1) / 2) x ((cols + 1) / 2) with row stride dst_stride.
+inline void BinarizeAboveHalfRes(const float* src, int rows, int cols, float cut,
+                                 uint8_t* dst, size_t dst_stride) {
+    const int out_rows = (rows + 1) / 2;
+    const int out_cols = (cols + 1) / 2;
+    const int full_cells = cols / 2;  // Output columns with both source columns present
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const int lanes32 = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 vcut = cv::vx_setall_f32(cut);
+#endif
+    for (int y = 0; y < out_rows; y++) {
+        const float* row = src + static_cast<size_t>(2 * y) * cols;
+        uint8_t* out = dst + static_cast<size_t>(y) * dst_stride;
+        int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+        for (; x + lanes <= full_cells; x += lanes) {
+            const float* s = row + 2 * x;
+            cv::v_uint32 m0 = cv::v_reinterpret_as_u32(cv::v_gt(PairPeak(s), vcut));
+            cv::v_uint32 m1 = cv::v_reinterpret_as_u32(cv::v_gt(PairPeak(s + 2 * lanes32), vcut));
+            cv::v_uint32 m2 = cv::v_reinterpret_as_u32(cv::v_gt(PairPeak(s + 4 * lanes32), vcut));
+            cv::v_uint32 m3 = cv::v_reinterpret_as_u32(cv::v_gt(PairPeak(s + 6 * lanes32), vcut));
+            cv::v_store(out + x, cv::v_pack_b(m0, m1, m2, m3));
+        }
+#endif
+        for (; x < out_cols; x++) {
+            int x0 = 2 * x;
+            int x1 = x < full_cells ? x0 + 1 : x0;
+            out[x] = std::max(row[x0], row[x1]) > cut ? 255 : 0;
+        }
+    }
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    cv::vx_cleanup();
+#endif
+}
+
+// Mean activated value over the pixels of `region` (a float map with row
+// stride `stride`) where `mask` is set; mask (y, x) covers region (y, x * step).
+// Only those pixels are activated.
+template <OutputActivation Act>
+inline float MaskedMeanActivation(const float* region, size_t stride, const cv::Mat& mask, int step = 1) {
+    double sum = 0.0;
+    size_t count = 0;
+    for (int y = 0; y < mask.rows; y++) {
+        const float* row = region + y * stride;
+        const uint8_t* m = mask.ptr<uint8_t>(y);
+        for (int x = 0; x < mask.cols; x++) {
+            if (m[x]) {
+                sum += Activate<Act>(row[x * step]);
+                count++;
+            }
+        }
+    }
+    return count > 0 ? static_cast<float>(sum / count) : 0.0f;
+}
+
+// Argmax of one CTC timestep and the probability of the winning class.
+// Softmax never changes the argmax, so only its denominator is computed.
+template <OutputActivation Act>
+inline std::pair<int, float> ArgmaxProbability(const float* row, int vocab_size) {
+    float max_val = row[0];
+    for (int v = 1; v < vocab_size; v++) {
+        max_val = std::max(max_val, row[v]);
+    }
+
+    int max_idx = 0;
+    while (max_idx < vocab_size - 1 && row[max_idx] != max_val) {
+        max_idx++;
+    }
+
+    if constexpr (Act == OutputActivation::kSoftmax) {
+        float sum_exp = 0.0f;
+        for (int v = 0; v < vocab_size; v++) {
+            sum_exp += std::exp(row[v] - max_val);
+        }
+        return {max_idx, 1.0f / sum_exp};
+    } else {
+        return {max_idx, max_val};
+    }
+}
+
+#endif // PIPELINE_KERNELS_H
@@ -0,0 +1,108 @@
+#ifndef REQUEST_SCHEDULER_H
+#define REQUEST_SCHEDULER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Priority class of an OCR request
+enum class RequestPriority {
+    kInteractive = 0,  // User is waiting on the result (default)
+    kBackground = 1,   // Library / batch work, yields to interactive requests
+};
+
+static const int REQUEST_PRIORITY_COUNT = 2;
+
+// "interactive" / "background"; unknown names map to kInteractive
+RequestPriority requestPriorityFromName(const std::string& name);
+const char* requestPriorityName(RequestPriority priority);
+
+// Counters for one priority class
+struct PriorityClassStats {
+    int in_flight = 0;            // Requests currently running (inside a RequestScope)
+    int waiting = 0;              // Stages queued for a session right now
+    int peak_waiting = 0;
+    uint64_t requests = 0;        // Requests started
+    uint64_t stages = 0;          // Stages granted a session
+    uint64_t total_wait_us = 0;   // Time stages spent queued
+    uint64_t max_wait_us = 0;
+};
+
+// Hands each model session to one inference at a time (a detection pass, one
+// recognition batch), interactive stages first. A background request releases
+// the session between its stages, so an interactive request waits for at most
+// one background inference instead of a whole batch. A stage covers the Run
+// call only; pre- and post-processing never hold a session.
+//
+// Sessions are gated independently: det and rec, or two registry models, run
+// side by side, and the priority rule applies per session. A session's run
+// already uses all its intra-op threads, so serializing runs of the same
+// session costs no throughput.
+//
+// Background work can starve while interactive requests keep arriving; that is
+// intended, batch OCR should only fill idle time.
+class RequestScheduler {
+public:
+    static RequestScheduler& GetInstance();
+
+    // Holds `session` (any stable key, normally the Ort::Session) for one
+    // stage, with the calling thread's priority. Re-entrant: a nested stage
+    // on a session the thread already holds is covered by the outer one.
+    class Stage {
+    public:
+        explicit Stage(const void* session);
+        ~Stage();
+        Stage(const Stage&) = delete;
+        Stage& operator=(const Stage&) = delete;
+
+    private:
+        const void* session_;
+        bool owner_ = false;
+    };
+
+    PriorityClassStats Stats(RequestPriority priority);
+    void ResetStats();
+
+private:
+    friend class RequestScope;
+
+    RequestScheduler() = default;
+    RequestScheduler(const RequestScheduler&) = delete;
+    RequestScheduler& operator=(const RequestScheduler&) = delete;
+
+    // Per-session gate
+    struct Slot {
+        bool busy = false;
+        int waiting[REQUEST_PRIORITY_COUNT] = {};
+    };
+
+    void Acquire(const void* session, RequestPriority priority);
+    void Release(const void* session);
+    void BeginRequest(RequestPriority priority);
+    void EndRequest(RequestPriority priority);
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::unordered_map<const void*, Slot> slots_;  // Sessions in use or waited on
+    PriorityClassStats stats_[REQUEST_PRIORITY_COUNT];
+};
+
+// Marks the calling thread as running one request of `priority` for the
+// scope's lifetime. Threads outside any scope run as interactive.
+class RequestScope {
+public:
+    explicit RequestScope(RequestPriority priority);
+    ~RequestScope();
+    RequestScope(const RequestScope&) = delete;
+    RequestScope& operator=(const RequestScope&) = delete;
+
+    static RequestPriority Current();
+
+private:
+    RequestPriority priority_;
+    RequestPriority previous_;
+};
+
+#endif // REQUEST_SCHEDULER_H
@@ -0,0 +1,127 @@
+#ifndef RESULT_STORE_H
+#define RESULT_STORE_H
+
+#include "ocr_engine.h"
+#include "segment_file.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// On-disk layout (native endianness). The file is a sequence of immutable
+// chunks, one per flush; appending writes a new chunk and never touches
+// existing bytes. Each chunk carries its own page index.
+//
+//   ResultChunkHeader
+//   ResultPageRecord[num_pages]
+//   ResultLineRecord[num_lines]   lines of all pages, in page order
+//   char text[text_bytes]         line texts and page sources
+//   padding to 8 bytes
+struct ResultChunkHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_pages;
+    uint32_t num_lines;
+    uint32_t text_bytes;
+    uint32_t reserved;
+    uint64_t segment_bytes;  // Total size including header and padding
+    uint64_t checksum;       // FNV-1a of everything after the header
+
+    static constexpr uint32_t kMagic = 0x53524B4F;  // "OKRS"
+    static constexpr uint32_t kVersion = 1;
+    uint64_t BodyBytes() const;
+};
+
+struct ResultPageRecord {
+    uint32_t first_line;   // Within the chunk
+    uint32_t num_lines;
+    uint32_t image_width;
+    uint32_t image_height;
+    uint32_t source_offset;
+    uint32_t source_length;
+};
+
+struct ResultLineRecord {
+    float x1, y1, x2, y2;
+    float score;
+    uint32_t text_offset;
+    uint32_t text_length;
+};
+
+// Zero-copy view of one stored page. Only valid inside the ForEachPage
+// callback: any append may flush and remap the file once the lock is released.
+struct ResultPageView {
+    const ResultPageRecord* record = nullptr;
+    const ResultLineRecord* lines = nullptr;
+    const char* text = nullptr;
+
+    size_t LineCount() const { return record->num_lines; }
+    std::string_view Source() const { return {text + record->source_offset, record->source_length}; }
+    std::string_view LineText(size_t i) const { return {text + lines[i].text_offset, lines[i].text_length}; }
+};
+
+// Append-only, crash-safe store of OCR results for batch jobs, read through mmap.
+// Pages are numbered in append order starting at 0.
+class ResultStore {
+public:
+    // Shared instance per store file, opened on first use. Callers hold the
+    // pointer for the length of their request (a whole batch, for
+    // resultStoreRecognizeFiles).
+    static std::shared_ptr<ResultStore> Get(const std::string& path);
+
+    // Forget the instance for this file; pending pages are flushed and the
+    // file unmapped once the last request holding it finishes
+    static void Close(const std::string& path);
+
+    ~ResultStore();  // Flushes pending pages
+
+    // Buffer one page; returns its page number. Flushes automatically once
+    // the buffered chunk grows past a few megabytes.
+    uint32_t AppendPage(std::string_view source, int image_width, int image_height,
+                        const TextLines& lines);
+
+    // Write buffered pages as a new chunk. Returns false on I/O failure.
+    bool Flush();
+
+    size_t PageCount();
+    size_t LineCount();
+    size_t ChunkCount();
+    size_t PendingCount();
+    uint64_t FileSize();
+
+    // Visit flushed pages [first, first + count) as (page number, view). The
+    // store stays locked for the whole visit, so copy out what must outlive it.
+    template <typename Fn>
+    void ForEachPage(size_t first, size_t count, Fn&& fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t last = std::min(page_count_, first + count);
+        for (size_t page = first; page < last; page++) {
+            fn(page, PageAt(page));
+        }
+    }
+
+private:
+    explicit ResultStore(const std::string& path);
+    ResultStore(const ResultStore&) = delete;
+    ResultStore& operator=(const ResultStore&) = delete;
+
+    void IndexChunks();  // Refresh page numbering after the file changed
+    bool FlushLocked();
+    ResultPageView PageAt(size_t page) const;
+
+    std::mutex mutex_;
+    SegmentFile<ResultChunkHeader> file_;   // One segment per chunk
+    std::vector<size_t> chunk_first_page_;  // Global number of each chunk's first page
+    size_t page_count_ = 0;
+    size_t line_count_ = 0;
+
+    // Pending chunk, built in place so appending costs no per-line allocation
+    std::vector<ResultPageRecord> pending_pages_;
+    std::vector<ResultLineRecord> pending_lines_;
+    std::string pending_text_;
+};
+
+#endif // RESULT_STORE_H
@@ -0,0 +1,138 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include "ocr_engine.h"
+#include "segment_file.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// One ranked search result
+struct SearchHit {
+    uint32_t doc_id;
+    uint32_t page;
+    uint32_t box_id;         // Index of the line within its page
+    float x1, y1, x2, y2;    // Line bounding box (original image space)
+    float score;             // OCR confidence of the line
+    float rank;              // Relevance: fraction of query terms matched, boosted for short lines
+    std::string text;
+};
+
+// On-disk layout (native endianness). The file is a sequence of immutable
+// segments; appending writes a new segment and never touches existing bytes.
+//
+//   IndexSegmentHeader
+//   IndexTermEntry[num_terms]     sorted by hash
+//   uint32_t postings[num_postings]  line indices, ascending per term
+//   IndexLineRecord[num_lines]
+//   char text[text_bytes]
+//   padding to 8 bytes
+struct IndexSegmentHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_terms;
+    uint32_t num_postings;
+    uint32_t num_lines;
+    uint32_t text_bytes;
+    uint64_t segment_bytes;  // Total size including header and padding
+    uint64_t checksum;       // FNV-1a of everything after the header
+
+    static constexpr uint32_t kMagic = 0x49534B4F;  // "OKSI"
+    static constexpr uint32_t kVersion = 1;
+    uint64_t BodyBytes() const;
+};
+
+struct IndexTermEntry {
+    uint64_t hash;
+    uint32_t offset;  // First posting
+    uint32_t count;
+};
+
+struct IndexLineRecord {
+    uint32_t doc_id;
+    uint32_t page;
+    uint32_t box_id;
+    float x1, y1, x2, y2;
+    float score;
+    uint32_t text_offset;
+    uint32_t text_length;
+};
+
+// Inverted index over OCR lines across documents, persisted as a memory-mapped file.
+// CJK text is indexed by character bigrams, Latin text by lowercased tokens.
+class SearchIndex {
+public:
+    // Shared instance per index file, opened on first use. Callers hold the
+    // pointer for the length of their request.
+    static std::shared_ptr<SearchIndex> Get(const std::string& path);
+
+    // Forget the instance for this file; it is unmapped (and pending lines
+    // dropped) once the last request holding it finishes
+    static void Close(const std::string& path);
+
+    // Buffer one page of OCR lines; box ids are the positions in `lines`
+    void AddPage(uint32_t doc_id, uint32_t page, const TextLines& lines);
+
+    // Append buffered lines as a new segment. Returns false on I/O failure.
+    // Past a few segments, adjacent ones are merged so queries stay bounded.
+    bool Commit();
+
+    // Rewrite all segments as one, so queries touch a single term table
+    bool Compact();
+
+    // Lines matching at least `min_coverage` of the query terms, best first.
+    // Only committed lines are searched.
+    std::vector<SearchHit> Search(const std::string& query, size_t max_hits = 50, float min_coverage = 1.0f);
+
+    size_t LineCount();
+    size_t SegmentCount();
+    size_t PendingCount();
+
+    // Visit every committed line (used by fuzzy search and compaction)
+    template <typename Fn>
+    void ForEachLine(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto* header : file_.segments()) {
+            const IndexLineRecord* lines = SegmentLines(header);
+            const char* text = SegmentText(header);
+            for (uint32_t i = 0; i < header->num_lines; i++) {
+                fn(lines[i], std::string_view(text + lines[i].text_offset, lines[i].text_length));
+            }
+        }
+    }
+
+private:
+    explicit SearchIndex(const std::string& path);
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+
+    struct PendingLine {
+        IndexLineRecord record;
+        std::string text;
+    };
+
+    void CountLines();  // Refresh line_count_ after the file changed
+    static std::vector<uint8_t> BuildSegment(const std::vector<PendingLine>& lines);
+    // Lines of segments [first, last); mutex_ held
+    std::vector<PendingLine> SegmentRange(size_t first, size_t last) const;
+    // Merge a run of adjacent segments into one; mutex_ held
+    void MergeSegmentsLocked();
+
+    static const IndexTermEntry* SegmentTerms(const IndexSegmentHeader* header);
+    static const uint32_t* SegmentPostings(const IndexSegmentHeader* header);
+    static const IndexLineRecord* SegmentLines(const IndexSegmentHeader* header);
+    static const char* SegmentText(const IndexSegmentHeader* header);
+
+    std::mutex mutex_;
+    SegmentFile<IndexSegmentHeader> file_;
+    size_t line_count_ = 0;
+    std::vector<PendingLine> pending_;
+};
+
+// Encode search hits as JSON
+std::string searchHitsToJson(const std::vector<SearchHit>& hits);
+
+#endif // SEARCH_INDEX_H
@@ -0,0 +1,158 @@
+#ifndef SEGMENT_FILE_H
+#define SEGMENT_FILE_H
+
+#include "mapped_file.h"
+#include "ocr_log.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Append-only file of immutable segments read through mmap (search index,
+// result store). Appending writes a new segment and never touches existing
+// bytes, so a crash can only tear the last one: it fails its checksum, is
+// ignored, and is cut off by the next append.
+//
+// Every segment starts with a Header providing
+//   static constexpr uint32_t kMagic, kVersion;
+//   uint32_t magic, version;
+//   uint64_t segment_bytes;     // Total size including header and padding
+//   uint64_t checksum;          // FNV-1a of everything after the header
+//   uint64_t BodyBytes() const; // Bytes after the header its counts imply
+template <typename Header>
+class SegmentFile {
+public:
+    // Map `path` and collect its intact segments; a missing file is empty
+    void Load(const std::string& path, const char* label) {
+        path_ = path;
+        label_ = label;
+        Reload();
+    }
+
+    // Append one sealed segment, dropping any torn tail first
+    bool Append(const std::vector<uint8_t>& segment) {
+        // Unmap before writing: the append truncates away bytes past valid_size_
+        file_.Close();
+        bool ok = appendFileDurable(path_, valid_size_, segment.data(), segment.size());
+        Reload();
+        return ok;
+    }
+
+    // Swap in a whole new file of sealed segments; readers never see it half-written
+    bool Replace(const std::vector<uint8_t>& contents) {
+        file_.Close();
+        bool ok = replaceFileDurable(path_, contents.data(), contents.size());
+        Reload();
+        return ok;
+    }
+
+    const std::vector<const Header*>& segments() const { return segments_; }
+    const uint8_t* data() const { return file_.data(); }
+    uint64_t size() const { return valid_size_; }  // Bytes of intact segments
+
+    // Zeroed buffer for a segment of `unpadded` bytes, padded to 8
+    static std::vector<uint8_t> NewSegment(size_t unpadded) {
+        return std::vector<uint8_t>((unpadded + 7) & ~static_cast<size_t>(7), 0);
+    }
+
+    // Stamp magic, version, size and checksum once the body is written
+    static void Seal(std::vector<uint8_t>& segment) {
+        auto* header = reinterpret_cast<Header*>(segment.data());
+        header->magic = Header::kMagic;
+        header->version = Header::kVersion;
+        header->segment_bytes = segment.size();
+        header->checksum = fnv1a64(header + 1, segment.size() - sizeof(Header));
+    }
+
+private:
+    void Reload() {
+        segments_.clear();
+        valid_size_ = 0;
+
+        if (!file_.Open(path_)) {
+            return;
+        }
+
+        // One header per segment, so opening touches a handful of pages
+        // however much the file holds
+        const uint8_t* base = file_.data();
+        uint64_t offset = 0;
+        while (offset + sizeof(Header) <= file_.size()) {
+            const auto* header = reinterpret_cast<const Header*>(base + offset);
+            if (header->magic != Header::kMagic || header->version != Header::kVersion) {
+                break;
+            }
+            if (header->segment_bytes < sizeof(Header) + header->BodyBytes() ||
+                offset + header->segment_bytes > file_.size()) {
+                break;
+            }
+
+            // Earlier segments were already verified when the next one was
+            // appended; only the tail can be torn, so only it pays for a checksum
+            bool is_tail = offset + header->segment_bytes + sizeof(Header) > file_.size();
+            if (is_tail && fnv1a64(header + 1, header->segment_bytes - sizeof(Header)) != header->checksum) {
+                LOGW("%s: dropping torn segment at offset %llu", label_, (unsigned long long)offset);
+                break;
+            }
+
+            segments_.push_back(header);
+            offset += header->segment_bytes;
+        }
+        valid_size_ = offset;
+    }
+
+    std::string path_;
+    const char* label_ = "";
+    MappedFile file_;
+    std::vector<const Header*> segments_;
+    uint64_t valid_size_ = 0;
+};
+
+// Shared instances of a file-backed store, one per path. Requests hold the
+// shared_ptr for their whole length, and Close only drops the registry's
+// reference. A closed instance still held by a request is handed back when
+// the path is reopened meanwhile, so a file never has two writers.
+template <typename T>
+class SharedFileInstances {
+public:
+    // `create(path)` returns a new T* when no live instance exists
+    template <typename Create>
+    std::shared_ptr<T> Get(const std::string& path, Create&& create) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = open_.find(path);
+        if (it == open_.end()) {
+            std::shared_ptr<T> instance;
+            auto closed = closed_.find(path);
+            if (closed != closed_.end()) {
+                instance = closed->second.lock();
+                closed_.erase(closed);
+            }
+            if (!instance) {
+                instance.reset(create(path));
+            }
+            it = open_.emplace(path, std::move(instance)).first;
+        }
+        return it->second;
+    }
+
+    void Close(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = open_.find(path);
+        if (it == open_.end()) {
+            return;
+        }
+        if (it->second.use_count() > 1) {
+            closed_[path] = it->second;
+        }
+        open_.erase(it);
+    }
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<T>> open_;
+    std::map<std::string, std::weak_ptr<T>> closed_;
+};
+
+#endif // SEGMENT_FILE_H
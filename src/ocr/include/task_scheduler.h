@@ -0,0 +1,136 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include "executor.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool for the CPU stages around inference: contour scoring,
+// crop + resize + pack, CTC decoding. Each worker pushes and pops its own
+// deque at the back; idle workers steal from the front of the others, and
+// threads outside the pool submit through a shared injection queue.
+//
+// ORT keeps its own intra-op pools. To stop the two from fighting over the
+// same cores, give each a disjoint CPU set (ThreadPoolConfig::cpus for the
+// sessions, TaskSchedulerConfig::cpus here), e.g. ORT on performance cores
+// and these workers on efficiency cores.
+//
+// OpenCV is set to one thread (cv::setNumThreads(1), process-wide) when the
+// workers start. The parallelism is already here, across boxes and batches;
+// OpenCV's own pool inside each task would put threads x workers runnable
+// threads on the same cores. Host code that wants OpenCV's pool back for its
+// own calls can call cv::setNumThreads again after the first OCR request.
+
+struct TaskSchedulerConfig {
+    int threads = 0;        // 0 = hardware threads - 1, at most 4
+    std::vector<int> cpus;  // Logical CPU ids to pin workers to; empty = no pinning
+};
+
+struct TaskSchedulerStats {
+    int threads = 0;
+    bool running = false;
+    uint64_t executed = 0;  // Tasks run by workers
+    uint64_t stolen = 0;    // Of those, taken from another worker's deque
+    uint64_t helped = 0;    // Tasks run by threads waiting on a TaskGroup
+};
+
+class TaskScheduler : public Executor {
+public:
+    static TaskScheduler& GetInstance();
+
+    // Workers start on the first task. Returns false (and changes nothing)
+    // once they are running.
+    bool Configure(const TaskSchedulerConfig& config);
+    TaskSchedulerConfig Config();
+
+    // Queue a task: on the calling worker's own deque, else the injection queue.
+    // A task that throws is logged and dropped; it does not take the worker down.
+    void Execute(std::function<void()> task) override;
+
+    int WorkerCount();
+    TaskSchedulerStats Stats();
+
+private:
+    friend class TaskGroup;  // Counts the tasks its Wait() runs as helped
+
+    TaskScheduler() = default;
+    ~TaskScheduler() override;
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    void EnsureStarted();
+    void WorkerLoop(int index);
+    // Own deque (back), injection queue, then steal (front); `self` = -1 outside the pool
+    bool TakeTask(int self, std::function<void()>& task, bool& stolen);
+    static void RunTask(std::function<void()>& task);  // Logs what it throws
+
+    std::mutex config_mutex_;
+    TaskSchedulerConfig config_;
+    std::atomic<bool> started_{false};
+    std::vector<std::unique_ptr<Worker>> workers_;  // Fixed once started_
+
+    std::mutex inject_mutex_;
+    std::deque<std::function<void()>> injected_;
+
+    // Idle workers sleep here until pending_ > 0
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<long> pending_{0};
+    bool stopping_ = false;
+
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+    std::atomic<uint64_t> helped_{0};
+};
+
+// Fork-join over the scheduler. Tasks wait in the group's own queue; the
+// scheduler only gets a ticket that runs the next one. Wait() runs the group's
+// queued tasks on the calling thread until the group is done, so groups can
+// nest inside tasks without starving the pool, and a waiting request never
+// picks up another request's work. The first exception thrown by a task is
+// rethrown by Wait().
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::GetInstance());
+    ~TaskGroup();  // Waits; exceptions are dropped
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void Run(std::function<void()> task);
+    void Wait();
+
+private:
+    struct State {
+        std::atomic<int> pending{0};  // Queued or running
+        std::mutex mutex;
+        std::condition_variable changed;  // Task queued or group done
+        std::deque<std::function<void()>> queue;
+        std::exception_ptr error;
+    };
+
+    // Run the group's oldest queued task; false if the queue was empty
+    static bool RunQueued(State& state);
+
+    TaskScheduler& scheduler_;
+    std::shared_ptr<State> state_;
+};
+
+// fn(begin, end) over [0, count) in chunks of at least `grain` items; the
+// calling thread takes the first chunk. Small ranges run inline.
+void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+#endif // TASK_SCHEDULER_H
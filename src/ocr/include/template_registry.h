@@ -0,0 +1,117 @@
+#ifndef TEMPLATE_REGISTRY_H
+#define TEMPLATE_REGISTRY_H
+
+#include "ocr_engine.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Known document templates (e-invoices, in-house forms) keyed by id. A page
+// is matched by a compact signature, aligned to the template's reference
+// image with a homography from ORB anchors, and only the stored field
+// regions are recognized, in one RecognizeBoxes call: no detection, no
+// layout. Pages that match nothing go through the normal pipeline.
+
+const int TEMPLATE_EDGE_GRID = 32;    // Edge fingerprint is 32x32 bits
+const int TEMPLATE_REGION_GRID = 8;   // Ink histogram is 8x8 cells
+const size_t TEMPLATE_EDGE_WORDS = TEMPLATE_EDGE_GRID * TEMPLATE_EDGE_GRID / 64;
+const size_t TEMPLATE_REGION_CELLS = TEMPLATE_REGION_GRID * TEMPLATE_REGION_GRID;
+
+// Whole-page fingerprint, a few hundred bytes, cheap to compute and compare
+struct TemplateSignature {
+    float aspect = 0.0f;  // Width / height
+    // Downsampled gradient magnitude above its median, one bit per cell
+    std::array<uint64_t, TEMPLATE_EDGE_WORDS> edges{};
+    // Share of the page's ink in each cell (sums to 1)
+    std::array<float, TEMPLATE_REGION_CELLS> regions{};
+};
+
+TemplateSignature computeTemplateSignature(const cv::Mat& image);
+// Fraction of edge bits that differ, 0..1
+float templateEdgeDistance(const TemplateSignature& a, const TemplateSignature& b);
+// Half the L1 distance between the ink histograms, 0..1
+float templateRegionDistance(const TemplateSignature& a, const TemplateSignature& b);
+
+struct TemplateField {
+    std::string name;
+    cv::Rect2f roi;  // In reference image pixels
+};
+
+struct TemplateMatchOptions {
+    float max_aspect_ratio = 1.15f;    // Page vs reference aspect, either way
+    float max_edge_distance = 0.3f;
+    float max_region_distance = 0.25f;
+    int min_inliers = 15;              // RANSAC inliers the homography needs
+};
+
+struct TemplateFieldValue {
+    std::string name;
+    bool found = false;  // False when the region read as empty or below rec_threshold
+    std::string text;
+    float score = 0.0f;
+    std::array<cv::Point2f, 4> points;  // Field region on the page
+};
+
+struct TemplateOcrResult {
+    bool matched = false;
+    std::string template_id;
+    float edge_distance = 1.0f;    // Of the best candidate, matched or not
+    float region_distance = 1.0f;
+    int inliers = 0;
+    std::vector<TemplateFieldValue> fields;  // Matched pages
+    TextLines lines;                         // Pages that fell through
+    DetectorBackend detector = DetectorBackend::kNeural;  // Fall-through detector that ran
+};
+
+struct TemplateInfo {
+    std::string id;
+    int width = 0;
+    int height = 0;
+    size_t anchors = 0;
+    size_t fields = 0;
+    uint64_t matches = 0;
+};
+
+class TemplateRegistry {
+public:
+    static TemplateRegistry& GetInstance();
+
+    // Add or replace a template from its reference image. Fails when the
+    // image has too few anchor features to align pages against.
+    bool Register(const std::string& id, const cv::Mat& reference, const std::vector<TemplateField>& fields);
+    bool Unregister(const std::string& id);
+    std::vector<TemplateInfo> List();
+
+    // Template fields when the page matches one, else the full pipeline
+    TemplateOcrResult Recognize(OcrEngine& engine, const cv::Mat& image,
+                                const OcrOptions& options = OcrOptions(),
+                                const TemplateMatchOptions& match = TemplateMatchOptions());
+
+private:
+    TemplateRegistry() = default;
+    TemplateRegistry(const TemplateRegistry&) = delete;
+    TemplateRegistry& operator=(const TemplateRegistry&) = delete;
+
+    struct Template {
+        std::string id;
+        cv::Size size;
+        TemplateSignature signature;
+        std::vector<cv::Point2f> anchors;  // ORB keypoints, reference pixels
+        cv::Mat descriptors;
+        std::vector<TemplateField> fields;
+    };
+
+    // Signature candidates within the match limits, nearest first
+    std::vector<std::pair<float, std::shared_ptr<const Template>>> Candidates(
+        const TemplateSignature& signature, const TemplateMatchOptions& match, TemplateOcrResult& result);
+
+    std::mutex mutex_;  // Guards templates_ and matches_; templates themselves are immutable
+    std::unordered_map<std::string, std::shared_ptr<const Template>> templates_;
+    std::unordered_map<std::string, uint64_t> matches_;
+};
+
+#endif // TEMPLATE_REGISTRY_H
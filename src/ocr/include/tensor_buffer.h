@@ -0,0 +1,80 @@
+#ifndef TENSOR_BUFFER_H
+#define TENSOR_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Alignment of engine-owned input tensors: one cache line, and enough for
+// the widest vector loads ONNX Runtime kernels issue
+const size_t TENSOR_ALIGNMENT = 64;
+
+// Grow-only float buffer for model inputs, 64-byte aligned. Buffers above
+// 2 MB can be backed by transparent huge pages where the OS supports them.
+class TensorBuffer {
+public:
+    TensorBuffer() = default;
+    ~TensorBuffer();
+    TensorBuffer(const TensorBuffer&) = delete;
+    TensorBuffer& operator=(const TensorBuffer&) = delete;
+
+    // At least `count` floats; previous contents are not preserved on growth
+    float* Reserve(size_t count);
+
+    float* data() const { return data_; }
+    size_t capacity() const { return capacity_; }
+
+    // Applies to buffers allocated after the call
+    static void SetHugePages(bool enable);
+    static bool HugePagesEnabled();
+
+    // Bytes currently held by all tensor buffers
+    static size_t TotalBytes();
+
+private:
+    float* data_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+// Reusable buffers handed out one per in-flight inference, so concurrent
+// calls never share an input and steady-state calls never allocate
+class TensorBufferPool {
+public:
+    class Lease {
+    public:
+        Lease(TensorBufferPool& pool, std::unique_ptr<TensorBuffer> buffer)
+            : pool_(pool), buffer_(std::move(buffer)) {}
+        ~Lease() { pool_.Return(std::move(buffer_)); }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        TensorBuffer& operator*() { return *buffer_; }
+        TensorBuffer* operator->() { return buffer_.get(); }
+
+    private:
+        TensorBufferPool& pool_;
+        std::unique_ptr<TensorBuffer> buffer_;
+    };
+
+    Lease Acquire();
+
+    // Free idle buffers (buffers out on lease are returned normally)
+    void Clear();
+
+private:
+    void Return(std::unique_ptr<TensorBuffer> buffer);
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<TensorBuffer>> idle_;
+};
+
+// Resident memory of this process, for before/after comparisons
+struct ProcessMemory {
+    size_t rss_kb = 0;
+    size_t peak_rss_kb = 0;
+};
+
+ProcessMemory readProcessMemory();
+
+#endif // TENSOR_BUFFER_H
@@ -0,0 +1,49 @@
+#ifndef TEXT_ARENA_H
+#define TEXT_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Bump allocator for result text. Strings are copied into blocks (4 KB by
+// default, larger strings get a block of their own) and handed out as views
+// that stay valid until Clear() or destruction. Moving the arena keeps them
+// valid; the moved-from arena is left empty.
+class TextArena {
+public:
+    explicit TextArena(size_t block_size = 4096) : block_size_(block_size) {}
+    TextArena(TextArena&& other) noexcept;
+    TextArena& operator=(TextArena&& other) noexcept;
+    TextArena(const TextArena&) = delete;
+    TextArena& operator=(const TextArena&) = delete;
+
+    // Copy `text` into the arena
+    std::string_view Store(std::string_view text);
+
+    // Make room for `bytes` more without a further block (one block when the
+    // caller knows the total up front)
+    void Reserve(size_t bytes);
+
+    // Forget all text; the largest block is kept for reuse
+    void Clear();
+
+    size_t BytesUsed() const { return used_; }
+    size_t BlockCount() const { return blocks_.size(); }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void AddBlock(size_t min_size);
+
+    std::vector<Block> blocks_;
+    size_t block_size_;
+    char* cursor_ = nullptr;
+    size_t remaining_ = 0;
+    size_t used_ = 0;
+};
+
+#endif // TEXT_ARENA_H
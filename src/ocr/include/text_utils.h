@@ -0,0 +1,41 @@
+#ifndef TEXT_UTILS_H
+#define TEXT_UTILS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Decode the code point starting at byte i and advance i past it.
+// Invalid or truncated sequences decode as U+FFFD.
+char32_t nextUtf8CodePoint(std::string_view text, size_t& i);
+
+// Decode UTF-8 into code points. Invalid bytes decode as U+FFFD.
+std::u32string decodeUtf8(std::string_view text);
+
+// Encode code points back to UTF-8
+std::string encodeUtf8(const std::u32string& text);
+void appendUtf8(std::string& out, char32_t cp);
+
+// Byte offset of every code point in `text` (plus text.size() at the end)
+std::vector<uint32_t> utf8CodePointOffsets(std::string_view text);
+
+// Han, kana and Hangul: scripts written without spaces between words
+bool isCjkCodePoint(char32_t cp);
+
+// Letters and digits of Latin-based scripts (ASCII + Latin-1/Extended letters)
+bool isLatinWordCodePoint(char32_t cp);
+
+// ASCII and Latin-1 lowercase, other code points unchanged
+char32_t foldCase(char32_t cp);
+
+// Index terms of a text: lowercased Latin/digit tokens, and for every CJK run
+// its character bigrams plus single characters (so one-character queries hit).
+// Each term is prefixed with a tag byte so a token never collides with a gram.
+std::vector<std::string> indexTerms(const std::string& text);
+
+// Terms a query must match: like indexTerms, but CJK runs of two or more
+// characters contribute bigrams only
+std::vector<std::string> queryTerms(const std::string& query);
+
+#endif // TEXT_UTILS_H
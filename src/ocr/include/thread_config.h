@@ -0,0 +1,48 @@
+#ifndef THREAD_CONFIG_H
+#define THREAD_CONFIG_H
+
+#include <onnxruntime_cxx_api.h>
+#include <string>
+#include <vector>
+
+// Threading of one inference session
+struct ThreadPoolConfig {
+    int intra_op_threads = 4;
+    int inter_op_threads = 2;
+    std::vector<int> cpus;  // Logical CPU ids (0-based) to pin to; empty = let the OS schedule
+};
+
+// Logical CPUs grouped by core class
+struct CpuTopology {
+    std::vector<int> performance;  // Big/prime cores (all cores on symmetric systems)
+    std::vector<int> efficiency;   // Little cores
+    std::vector<int> capacity;     // Relative capacity per CPU id, 0 if unknown
+};
+
+// Read core classes from /sys/devices/system/cpu/cpu*/cpu_capacity, falling
+// back to cpufreq/cpuinfo_max_freq. Cores above the midpoint between the
+// weakest and strongest core count as performance cores.
+CpuTopology detectCpuTopology();
+
+// Resolve a CPU set name: "performance", "efficiency", "all" or "" (no pinning)
+std::vector<int> cpuSetByName(const CpuTopology& topology, const std::string& name);
+
+// Set thread counts and, on Linux/Android, pin intra-op workers round-robin
+// to the configured CPUs via session.intra_op_thread_affinities
+void applyThreadConfig(Ort::SessionOptions& options, const ThreadPoolConfig& config);
+
+// Pin the calling thread (which also runs intra-op work) for the scope's lifetime.
+// No-op without a CPU set or off Linux/Android.
+class ScopedThreadAffinity {
+public:
+    explicit ScopedThreadAffinity(const std::vector<int>& cpus);
+    ~ScopedThreadAffinity();
+    ScopedThreadAffinity(const ScopedThreadAffinity&) = delete;
+    ScopedThreadAffinity& operator=(const ScopedThreadAffinity&) = delete;
+
+private:
+    bool pinned_ = false;
+    std::vector<unsigned char> saved_mask_;
+};
+
+#endif // THREAD_CONFIG_H
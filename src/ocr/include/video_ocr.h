@@ -0,0 +1,42 @@
+#ifndef VIDEO_OCR_H
+#define VIDEO_OCR_H
+
+#include "ocr_engine.h"
+#include <string>
+#include <vector>
+
+// Video OCR options
+struct VideoOcrOptions {
+    double sample_interval_ms = 500.0;  // Time between sampled frames
+    float change_threshold = 0.02f;     // Mean abs diff (0-1) of downscaled frames that counts as a change
+    cv::Rect roi;                       // Optional region to watch and OCR (e.g. subtitle band), empty = full frame
+    float det_threshold = 0.3f;
+    float rec_threshold = 0.5f;
+};
+
+// A run of sampled frames showing the same text
+struct VideoTextSegment {
+    double start_ms;                     // Timestamp of the keyframe that introduced the text
+    double end_ms;                       // Timestamp of the last sampled frame still showing it
+    std::string text;                    // Joined text of all lines
+    TextLines lines;                     // Lines in frame coordinates
+};
+
+// Counters describing how much work a video run needed
+struct VideoOcrStats {
+    int frames_total = 0;    // Frames decoded (sampled or not)
+    int frames_sampled = 0;  // Frames compared against the last keyframe
+    int keyframes = 0;       // Sampled frames that changed enough to run detection
+    int ocr_runs = 0;        // Keyframes where text was found and recognized
+    int video_width = 0;
+    int video_height = 0;
+    double duration_ms = 0;
+};
+
+// Run OCR over a video file, only on frames whose content changed.
+// Returns deduplicated, timestamped text segments. Empty on open failure.
+std::vector<VideoTextSegment> recognizeVideo(const std::string& video_path,
+                                             const VideoOcrOptions& options,
+                                             VideoOcrStats* stats = nullptr);
+
+#endif // VIDEO_OCR_H
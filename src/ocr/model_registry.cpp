@@ -0,0 +1,215 @@
+#include "include/model_registry.h"
+#include "include/tensor_buffer.h"
+#include "../detect/include/doc_detector.h"
+#include "include/ocr_log.h"
+#include <sys/stat.h>
+#include <algorithm>
+
+const char* modelKindName(ModelKind kind) {
+    return kind == ModelKind::kLayout ? "layout" : "ocr";
+}
+
+static size_t fileBytes(const std::string& path) {
+    struct stat st;
+    if (path.empty() || stat(path.c_str(), &st) != 0) return 0;
+    return static_cast<size_t>(st.st_size);
+}
+
+// Lower bound on what a model costs once loaded: its weights
+static size_t specFileBytes(const ModelSpec& spec) {
+    if (spec.kind == ModelKind::kLayout) return fileBytes(spec.layout_model_path);
+    return fileBytes(spec.det_model_path) + fileBytes(spec.rec_model_path) + fileBytes(spec.dict_path);
+}
+
+ModelRegistry& ModelRegistry::GetInstance() {
+    static ModelRegistry instance;
+    return instance;
+}
+
+void ModelRegistry::Register(const std::string& id, const ModelSpec& spec) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Holders of the old model keep it alive until they release it
+    Entry entry;
+    entry.spec = spec;
+    entries_[id] = std::move(entry);
+    LOGI("Model registered: %s (%s)", id.c_str(), modelKindName(spec.kind));
+}
+
+bool ModelRegistry::Unregister(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.erase(id) > 0;
+}
+
+std::shared_ptr<OcrEngine> ModelRegistry::AcquireOcr(const std::string& id) {
+    std::shared_ptr<OcrEngine> engine;
+    Acquire(id, ModelKind::kOcr, &engine, nullptr);
+    return engine;
+}
+
+std::shared_ptr<LayoutModel> ModelRegistry::AcquireLayout(const std::string& id) {
+    std::shared_ptr<LayoutModel> model;
+    Acquire(id, ModelKind::kLayout, nullptr, &model);
+    return model;
+}
+
+bool ModelRegistry::TakeLoaded(Entry& entry, std::shared_ptr<OcrEngine>* ocr,
+                               std::shared_ptr<LayoutModel>* layout) {
+    if (!entry.Loaded()) return false;
+    entry.hits++;
+    entry.last_used = ++clock_;
+    if (ocr) *ocr = entry.ocr;
+    if (layout) *layout = entry.layout;
+    return true;
+}
+
+bool ModelRegistry::Acquire(const std::string& id, ModelKind kind,
+                            std::shared_ptr<OcrEngine>* ocr,
+                            std::shared_ptr<LayoutModel>* layout) {
+    ModelSpec spec;
+    size_t expected = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(id);
+        if (it == entries_.end() || it->second.spec.kind != kind) {
+            LOGW("Model not registered as %s: %s", modelKindName(kind), id.c_str());
+            return false;
+        }
+        if (TakeLoaded(it->second, ocr, layout)) return true;
+        spec = it->second.spec;
+        expected = std::max(it->second.resident_bytes, specFileBytes(spec));
+    }
+
+    std::lock_guard<std::mutex> load_lock(load_mutex_);
+    {
+        // Another caller may have loaded it while we waited
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(id);
+        if (it == entries_.end()) return false;
+        if (TakeLoaded(it->second, ocr, layout)) return true;
+        EvictFor(expected, id);
+    }
+
+    ProcessMemory before = readProcessMemory();
+    std::shared_ptr<OcrEngine> loaded_ocr;
+    std::shared_ptr<LayoutModel> loaded_layout;
+    if (kind == ModelKind::kOcr) {
+        loaded_ocr = std::make_shared<OcrEngine>();
+        // Same thread layout as the default engine
+        OcrEngine& defaults = OcrEngine::GetInstance();
+        loaded_ocr->SetThreadConfig(defaults.DetThreadConfig(), defaults.RecThreadConfig());
+        loaded_ocr->Init(spec.det_model_path, spec.rec_model_path, spec.dict_path);
+        if (!loaded_ocr->IsInitialized()) {
+            LOGE("Model load failed: %s", id.c_str());
+            return false;
+        }
+    } else {
+        try {
+            loaded_layout = std::make_shared<LayoutModel>(spec.layout_model_path);
+        } catch (const Ort::Exception& e) {
+            LOGE("Model load failed: %s: %s", id.c_str(), e.what());
+            return false;
+        }
+    }
+    ProcessMemory after = readProcessMemory();
+    // RSS can miss memory-mapped weights that are not touched yet, so never
+    // count less than the files themselves
+    size_t rss_delta = after.rss_kb > before.rss_kb ? (after.rss_kb - before.rss_kb) * 1024 : 0;
+    size_t resident = std::max(rss_delta, specFileBytes(spec));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ocr) *ocr = loaded_ocr;
+    if (layout) *layout = loaded_layout;
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        // Unregistered during the load: serve this request, keep nothing
+        return true;
+    }
+    Entry& entry = it->second;
+    entry.ocr = std::move(loaded_ocr);
+    entry.layout = std::move(loaded_layout);
+    entry.resident_bytes = resident;
+    entry.loads++;
+    entry.last_used = ++clock_;
+    LOGI("Model loaded: %s, %zu KB resident", id.c_str(), resident / 1024);
+    EvictFor(0, id);
+    return true;
+}
+
+void ModelRegistry::EvictFor(size_t incoming, const std::string& keep) {
+    if (budget_ == 0) return;
+    size_t resident = ResidentBytesLocked();
+    while (resident + incoming > budget_) {
+        auto victim = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            const Entry& entry = it->second;
+            if (it->first == keep || !entry.Loaded() || entry.InUse()) continue;
+            if (victim == entries_.end() || entry.last_used < victim->second.last_used) {
+                victim = it;
+            }
+        }
+        if (victim == entries_.end()) {
+            LOGW("Model budget exceeded, nothing idle to evict (%zu KB resident)", resident / 1024);
+            return;
+        }
+        LOGI("Evicting model: %s", victim->first.c_str());
+        Entry& evicted = victim->second;
+        resident -= std::min(resident, evicted.resident_bytes);
+        evicted.ocr.reset();
+        evicted.layout.reset();
+        evicted.evictions++;
+    }
+}
+
+size_t ModelRegistry::ResidentBytesLocked() const {
+    size_t total = 0;
+    for (const auto& [id, entry] : entries_) {
+        if (entry.Loaded()) total += entry.resident_bytes;
+    }
+    return total;
+}
+
+void ModelRegistry::SetMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = bytes;
+    EvictFor(0, std::string());
+}
+
+size_t ModelRegistry::MemoryBudget() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+size_t ModelRegistry::ResidentBytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ResidentBytesLocked();
+}
+
+std::vector<ModelStatus> ModelRegistry::Status() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ModelStatus> status;
+    status.reserve(entries_.size());
+    for (const auto& [id, entry] : entries_) {
+        ModelStatus s;
+        s.id = id;
+        s.kind = entry.spec.kind;
+        s.loaded = entry.Loaded();
+        s.in_use = entry.InUse();
+        s.resident_bytes = entry.resident_bytes;
+        s.loads = entry.loads;
+        s.hits = entry.hits;
+        s.evictions = entry.evictions;
+        status.push_back(std::move(s));
+    }
+    std::sort(status.begin(), status.end(),
+              [](const ModelStatus& a, const ModelStatus& b) { return a.id < b.id; });
+    return status;
+}
+
+void ModelRegistry::UnloadAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [id, entry] : entries_) {
+        if (entry.InUse()) continue;
+        entry.ocr.reset();
+        entry.layout.reset();
+    }
+}
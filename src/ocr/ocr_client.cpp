@@ -0,0 +1,120 @@
+#include "include/ocr_client.h"
+#include "include/model_registry.h"
+#include "include/ocr_log.h"
+#include <chrono>
+
+const char* ocrErrorName(OcrError error) {
+    switch (error) {
+        case OcrError::kNone: return "NONE";
+        case OcrError::kNotInitialized: return "ENGINE_NOT_INITIALIZED";
+        case OcrError::kImageLoadFailed: return "IMAGE_LOAD_FAILED";
+        case OcrError::kInvalidInput: return "INVALID_INPUT";
+        case OcrError::kModelNotFound: return "MODEL_NOT_FOUND";
+        case OcrError::kInternal: return "INTERNAL_ERROR";
+    }
+    return "UNKNOWN";
+}
+
+OcrClient::OcrClient(std::shared_ptr<Executor> executor, OcrEngine& engine)
+    : executor_(executor ? std::move(executor) : std::make_shared<ThreadPoolExecutor>(2)),
+      engine_(engine) {}
+
+// Free function so queued tasks hold the engine, not the client
+static OcrResponse runRequest(OcrEngine& default_engine, const OcrRequest& request) {
+    OcrResponse response;
+    // Held for the whole request so the registry cannot evict the model mid-run
+    std::shared_ptr<OcrEngine> model;
+    if (!request.model_id.empty()) {
+        model = ModelRegistry::GetInstance().AcquireOcr(request.model_id);
+        if (!model) {
+            response.error = OcrError::kModelNotFound;
+            return response;
+        }
+    }
+    OcrEngine& engine = model ? *model : default_engine;
+    if (!engine.IsInitialized()) {
+        response.error = OcrError::kNotInitialized;
+        return response;
+    }
+
+    cv::Mat image = request.image;
+    if (image.empty()) {
+        if (request.image_path.empty()) {
+            response.error = OcrError::kInvalidInput;
+            return response;
+        }
+        image = cv::imread(request.image_path);
+        if (image.empty()) {
+            response.error = OcrError::kImageLoadFailed;
+            return response;
+        }
+    }
+
+    RequestScope scope(request.options.priority);
+    response.image_width = image.cols;
+    response.image_height = image.rows;
+    response.lines = engine.RecognizeText(image, request.options, &response.detector);
+    return response;
+}
+
+// runRequest for a queued request, timed from when it was queued
+static OcrResponse runQueued(OcrEngine& engine, const OcrRequest& request,
+                             std::chrono::steady_clock::time_point queued) {
+    OcrResponse response = runRequest(engine, request);
+    response.time_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - queued).count();
+    return response;
+}
+
+OcrResponse OcrClient::Run(const OcrRequest& request) {
+    return runRequest(engine_, request);
+}
+
+// Nothing may escape a queued task: on an executor thread it would terminate
+// the process, so failures go to the response, the promise or the log.
+void OcrClient::Submit(OcrRequest request, Callback done) {
+    auto queued = std::chrono::steady_clock::now();
+    // std::function needs a copyable task: the request rides in a shared_ptr
+    auto shared = std::make_shared<OcrRequest>(std::move(request));
+    OcrEngine* engine = &engine_;
+    executor_->Execute([engine, shared, done = std::move(done), queued]() {
+        OcrResponse response;
+        try {
+            response = runQueued(*engine, *shared, queued);
+        } catch (const std::exception& e) {
+            LOGE("OCR request failed: %s", e.what());
+            response = OcrResponse();
+            response.error = OcrError::kInternal;
+            response.message = e.what();
+        } catch (...) {
+            LOGE("OCR request failed: unknown exception");
+            response = OcrResponse();
+            response.error = OcrError::kInternal;
+            response.message = "unknown exception";
+        }
+
+        try {
+            done(std::move(response));
+        } catch (const std::exception& e) {
+            LOGE("OCR callback threw: %s", e.what());
+        } catch (...) {
+            LOGE("OCR callback threw an unknown exception");
+        }
+    });
+}
+
+std::future<OcrResponse> OcrClient::Submit(OcrRequest request) {
+    auto queued = std::chrono::steady_clock::now();
+    auto shared = std::make_shared<OcrRequest>(std::move(request));
+    auto promise = std::make_shared<std::promise<OcrResponse>>();
+    std::future<OcrResponse> future = promise->get_future();
+    OcrEngine* engine = &engine_;
+    executor_->Execute([engine, shared, promise, queued]() {
+        try {
+            promise->set_value(runQueued(*engine, *shared, queued));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
@@ -1,22 +1,21 @@
 #include "include/ocr_engine.h"
+#include "include/box_merge.h"
+#include "include/ort_env.h"
+#include "include/task_scheduler.h"
+#include "include/ocr_log.h"
 #include <sstream>
 #include <iomanip>
 #include <fstream>
 #include <chrono>
 #include <algorithm>
+#include <climits>
 #include <cmath>
 #include <numeric>
 
 #ifdef __ANDROID__
-#include <android/log.h>
 #include "nnapi_provider_factory.h"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, "OcrKit", __VA_ARGS__)
 #elif defined(__APPLE__)
-#include <os/log.h>
 #include "coreml_provider_factory.h"
-#define LOGD(...) os_log(OS_LOG_DEFAULT, __VA_ARGS__)
-#else
-#define LOGD(...) do {} while(0)
 #endif
 
 // Constants for PP-OCRv4
@@ -24,10 +23,69 @@ static const int DET_MAX_SIDE = 960;       // Max side length for detection
 static const int DET_LIMIT_SIDE = 32;      // Must be divisible by 32
 static const int REC_IMG_HEIGHT = 48;      // Fixed height for recognition
 static const int REC_IMG_MAX_WIDTH = 2048; // Max width for recognition (to prevent memory issues)
-static const float DET_MEAN[3] = {0.485f, 0.456f, 0.406f};
-static const float DET_STD[3] = {0.229f, 0.224f, 0.225f};
-static const float REC_MEAN[3] = {0.5f, 0.5f, 0.5f};
-static const float REC_STD[3] = {0.5f, 0.5f, 0.5f};
+static const size_t REC_BATCH_SIZE = 6;    // Crops per recognition inference (one scheduler stage)
+static const size_t DET_CONTOUR_GRAIN = 16; // Contours scored per task
+static const size_t DET_HALF_RES_MIN_PIXELS = 512 * 512; // Smaller maps always post-process at full resolution
+static const float DESKEW_MAX_ANGLE = 10.0f;  // Degrees; steeper pages keep per-line warps
+static const float DESKEW_MIN_ANGLE = 0.1f;   // Below this the page is sliced as is
+static const float DESKEW_MAX_SLANT = 2.0f;   // Pixels a box may be off axis-aligned and still be sliced
+static const size_t DESKEW_MIN_BOXES = 8;     // With fewer boxes, per-line warps beat one page rotation
+// Channel order and mean/std live in DetInputPipeline / RecInputPipeline (pipeline_kernels.h)
+
+// DB det output looks like logits when it leaves the [0, 1] range
+static OutputActivation ClassifyDetOutput(const float* data, size_t n) {
+    if (n == 0) {
+        return OutputActivation::kUnresolved;
+    }
+    auto [min_it, max_it] = std::minmax_element(data, data + n);
+    return (*min_it < -0.1f || *max_it > 1.1f) ? OutputActivation::kSigmoid : OutputActivation::kNone;
+}
+
+// CTC rec output looks like logits when a timestep is negative or does not sum to ~1
+static OutputActivation ClassifyRecOutput(const float* timestep, int vocab_size) {
+    if (vocab_size <= 0) {
+        return OutputActivation::kUnresolved;
+    }
+    float min_val = timestep[0];
+    float sum = 0.0f;
+    for (int v = 0; v < vocab_size; v++) {
+        min_val = std::min(min_val, timestep[v]);
+        sum += timestep[v];
+    }
+    bool logits = (min_val < -0.001f || std::abs(sum - 1.0f) > 0.1f);
+    return logits ? OutputActivation::kSoftmax : OutputActivation::kNone;
+}
+
+TextLines::TextLines(const TextLines& other) {
+    *this = other;
+}
+
+TextLines& TextLines::operator=(const TextLines& other) {
+    if (this == &other) {
+        return *this;
+    }
+    Clear();
+    Reserve(other.size(), other.TextBytes());
+    for (const TextLineResult& line : other) {
+        Add(line);
+    }
+    return *this;
+}
+
+void TextLines::Reserve(size_t lines, size_t text_bytes) {
+    lines_.reserve(lines);
+    arena_.Reserve(text_bytes);
+}
+
+TextLineResult& TextLines::Add(float x1, float y1, float x2, float y2, float score, std::string_view text) {
+    lines_.push_back({x1, y1, x2, y2, score, arena_.Store(text)});
+    return lines_.back();
+}
+
+void TextLines::Clear() {
+    lines_.clear();
+    arena_.Clear();
+}
 
 OcrEngine& OcrEngine::GetInstance() {
     static OcrEngine instance;
@@ -47,6 +105,7 @@ void OcrEngine::Release() {
         delete rec_session_;
         rec_session_ = nullptr;
     }
+    DisableRecCascade();
     if (det_session_options_) {
         delete det_session_options_;
         det_session_options_ = nullptr;
@@ -56,18 +115,22 @@ void OcrEngine::Release() {
         rec_session_options_ = nullptr;
     }
     if (env_) {
-        delete env_;
+        ReleaseOrtEnv();
         env_ = nullptr;
     }
+    det_inputs_.Clear();
+    rec_inputs_.Clear();
     dictionary_.clear();
+    det_activation_ = OutputActivation::kUnresolved;
+    rec_activation_ = OutputActivation::kUnresolved;
     initialized_ = false;
-    LOGD("OCR Engine released");
+    LOGI("OCR Engine released");
 }
 
 void OcrEngine::LoadDictionary(const std::string& dict_path) {
     std::ifstream file(dict_path);
     if (!file.is_open()) {
-        LOGD("Failed to open dictionary: %s", dict_path.c_str());
+        LOGE("Failed to open dictionary: %s", dict_path.c_str());
         return;
     }
 
@@ -99,11 +162,13 @@ void OcrEngine::LoadDictionary(const std::string& dict_path) {
     // Add end token to match model vocabulary size (6625)
     dictionary_.push_back("");  // End/padding token
 
-    LOGD("Loaded dictionary: %d lines from file, %zu total entries", line_count, dictionary_.size());
+    LOGI("Loaded dictionary: %d lines from file, %zu total entries", line_count, dictionary_.size());
 
     // Debug: print first 20 entries
-    for (size_t i = 0; i < std::min(dictionary_.size(), size_t(20)); i++) {
-        LOGD("Dict[%zu] = '%s'", i, dictionary_[i].c_str());
+    if (OCR_LOG_ENABLED(LogLevel::kDebug)) {
+        for (size_t i = 0; i < std::min(dictionary_.size(), size_t(20)); i++) {
+            LOGD("Dict[%zu] = '%s'", i, dictionary_[i].c_str());
+        }
     }
 }
 
@@ -120,20 +185,21 @@ void OcrEngine::Init(const std::string& det_model_path,
     // Load dictionary
     LoadDictionary(dict_path);
 
-    // Create environment
-    env_ = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "OcrEngine");
+    // Shared environment: both sessions (and the layout session) use one CPU arena
+    env_ = &AcquireOrtEnv();
 
     // Create session options for detection model
     det_session_options_ = new Ort::SessionOptions();
     det_session_options_->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-    det_session_options_->SetIntraOpNumThreads(4);
-    det_session_options_->SetInterOpNumThreads(2);
+    applyThreadConfig(*det_session_options_, det_threads_);
 
     // Create session options for recognition model
     rec_session_options_ = new Ort::SessionOptions();
     rec_session_options_->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-    rec_session_options_->SetIntraOpNumThreads(4);
-    rec_session_options_->SetInterOpNumThreads(2);
+    applyThreadConfig(*rec_session_options_, rec_threads_);
+
+    UseSharedAllocator(*det_session_options_);
+    UseSharedAllocator(*rec_session_options_);
 
     // Enable hardware acceleration
 #ifdef __ANDROID__
@@ -142,13 +208,13 @@ void OcrEngine::Init(const std::string& det_model_path,
 
     OrtStatus* det_status = OrtSessionOptionsAppendExecutionProvider_Nnapi(*det_session_options_, nnapi_flags);
     if (det_status != nullptr) {
-        LOGD("NNAPI failed for det: %s", Ort::GetApi().GetErrorMessage(det_status));
+        LOGW("NNAPI failed for det: %s", Ort::GetApi().GetErrorMessage(det_status));
         Ort::GetApi().ReleaseStatus(det_status);
     }
 
     OrtStatus* rec_status = OrtSessionOptionsAppendExecutionProvider_Nnapi(*rec_session_options_, nnapi_flags);
     if (rec_status != nullptr) {
-        LOGD("NNAPI failed for rec: %s", Ort::GetApi().GetErrorMessage(rec_status));
+        LOGW("NNAPI failed for rec: %s", Ort::GetApi().GetErrorMessage(rec_status));
         Ort::GetApi().ReleaseStatus(rec_status);
     }
 #elif defined(__APPLE__)
@@ -157,7 +223,7 @@ void OcrEngine::Init(const std::string& det_model_path,
 
     OrtStatus* det_status = OrtSessionOptionsAppendExecutionProvider_CoreML(*det_session_options_, coreml_flags);
     if (det_status != nullptr) {
-        LOGD("Core ML failed for det: %s", Ort::GetApi().GetErrorMessage(det_status));
+        LOGW("Core ML failed for det: %s", Ort::GetApi().GetErrorMessage(det_status));
         Ort::GetApi().ReleaseStatus(det_status);
     } else {
         LOGD("Core ML enabled for detection model");
@@ -165,7 +231,7 @@ void OcrEngine::Init(const std::string& det_model_path,
 
     OrtStatus* rec_status = OrtSessionOptionsAppendExecutionProvider_CoreML(*rec_session_options_, coreml_flags);
     if (rec_status != nullptr) {
-        LOGD("Core ML failed for rec: %s", Ort::GetApi().GetErrorMessage(rec_status));
+        LOGW("Core ML failed for rec: %s", Ort::GetApi().GetErrorMessage(rec_status));
         Ort::GetApi().ReleaseStatus(rec_status);
     } else {
         LOGD("Core ML enabled for recognition model");
@@ -173,18 +239,157 @@ void OcrEngine::Init(const std::string& det_model_path,
 #endif
 
     // Load detection model
-    LOGD("Loading detection model: %s", det_model_path.c_str());
+    LOGI("Loading detection model: %s", det_model_path.c_str());
     det_session_ = new Ort::Session(*env_, det_model_path.c_str(), *det_session_options_);
 
     // Load recognition model
-    LOGD("Loading recognition model: %s", rec_model_path.c_str());
+    LOGI("Loading recognition model: %s", rec_model_path.c_str());
     rec_session_ = new Ort::Session(*env_, rec_model_path.c_str(), *rec_session_options_);
 
+    // Pick the activation kernels once, before any request can see the engine
+    ResolveOutputActivations();
+
     initialized_ = true;
-    LOGD("OCR Engine initialized successfully");
+
+    LOGI("OCR Engine initialized successfully");
+}
+
+void OcrEngine::SetThreadConfig(const ThreadPoolConfig& det, const ThreadPoolConfig& rec) {
+    det_threads_ = det;
+    rec_threads_ = rec;
+    LOGD("Thread config: det %d threads on %zu cpus, rec %d threads on %zu cpus",
+         det.intra_op_threads, det.cpus.size(), rec.intra_op_threads, rec.cpus.size());
+}
+
+void OcrEngine::ResolveOutputActivations() {
+    // Probe both models with a blank input. A blank page gives strongly negative
+    // det logits and a near-certain CTC blank, so either output form is obvious.
+    try {
+        Ort::AllocatorWithDefaultOptions allocator;
+        const Ort::MemoryInfo& memory_info = CpuMemoryInfo();
+
+        {
+            cv::Mat blank(DET_LIMIT_SIDE, DET_LIMIT_SIDE, CV_8UC3, cv::Scalar(255, 255, 255));
+            cv::Mat blob = MakeInputBlob<DetInputPipeline>(blank);
+            std::vector<int64_t> shape = {1, 3, blank.rows, blank.cols};
+            Ort::Value input = Ort::Value::CreateTensor<float>(
+                memory_info, blob.ptr<float>(), blob.total(), shape.data(), shape.size());
+
+            auto input_name = det_session_->GetInputNameAllocated(0, allocator);
+            auto output_name = det_session_->GetOutputNameAllocated(0, allocator);
+            const char* input_names[] = {input_name.get()};
+            const char* output_names[] = {output_name.get()};
+            auto outputs = det_session_->Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+
+            size_t count = outputs[0].GetTensorTypeAndShapeInfo().GetElementCount();
+            det_activation_ = ClassifyDetOutput(outputs[0].GetTensorData<float>(), count);
+        }
+
+        int vocab_size = 0;
+        rec_activation_ = ProbeRecOutput(*rec_session_, vocab_size);
+    } catch (const Ort::Exception& e) {
+        LOGW("Activation probe failed: %s", e.what());
+    }
+
+    // Requests read these without synchronization, so they are final from
+    // here on. PP-OCRv4 exports apply sigmoid / softmax in the graph.
+    if (det_activation_ == OutputActivation::kUnresolved) {
+        LOGW("Det output activation unresolved, assuming probabilities");
+        det_activation_ = OutputActivation::kNone;
+    }
+    if (rec_activation_ == OutputActivation::kUnresolved) {
+        LOGW("Rec output activation unresolved, assuming probabilities");
+        rec_activation_ = OutputActivation::kNone;
+    }
+
+    LOGD("Output activations: det=%d, rec=%d",
+         static_cast<int>(det_activation_), static_cast<int>(rec_activation_));
 }
 
-cv::Mat OcrEngine::PreprocessForDetection(const cv::Mat& image, float& scale_x, float& scale_y) {
+OutputActivation OcrEngine::ProbeRecOutput(Ort::Session& session, int& vocab_size) {
+    cv::Mat blank(REC_IMG_HEIGHT, REC_IMG_HEIGHT, CV_8UC3, cv::Scalar(255, 255, 255));
+    cv::Mat blob = MakeInputBlob<RecInputPipeline>(blank);
+    std::vector<int64_t> shape = {1, 3, blank.rows, blank.cols};
+    Ort::Value input = Ort::Value::CreateTensor<float>(
+        CpuMemoryInfo(), blob.ptr<float>(), blob.total(), shape.data(), shape.size());
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto input_name = session.GetInputNameAllocated(0, allocator);
+    auto output_name = session.GetOutputNameAllocated(0, allocator);
+    const char* input_names[] = {input_name.get()};
+    const char* output_names[] = {output_name.get()};
+    auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+
+    auto shape_out = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+    vocab_size = static_cast<int>(shape_out[2]);
+    return ClassifyRecOutput(outputs[0].GetTensorData<float>(), vocab_size);
+}
+
+bool OcrEngine::EnableRecCascade(const std::string& rec_model_path, const RecCascadeConfig& config) {
+    if (!initialized_ || !rec_session_) {
+        LOGW("Rec cascade needs an initialized engine");
+        return false;
+    }
+
+    Ort::Session* session = nullptr;
+    try {
+        // Same threads, pinning and execution provider as the fast model
+        session = new Ort::Session(*env_, rec_model_path.c_str(), *rec_session_options_);
+
+        // Both models decode with one dictionary, so their vocabularies must agree
+        int fast_vocab = 0, accurate_vocab = 0;
+        ProbeRecOutput(*rec_session_, fast_vocab);
+        OutputActivation activation = ProbeRecOutput(*session, accurate_vocab);
+        if (activation == OutputActivation::kUnresolved) {
+            activation = OutputActivation::kNone;
+        }
+        if (accurate_vocab != fast_vocab) {
+            LOGW("Rec cascade model vocab %d does not match %d", accurate_vocab, fast_vocab);
+            delete session;
+            return false;
+        }
+
+        DisableRecCascade();
+        cascade_session_ = session;
+        cascade_activation_ = activation;
+    } catch (const Ort::Exception& e) {
+        LOGE("Rec cascade model failed to load: %s", e.what());
+        delete session;
+        return false;
+    }
+
+    cascade_config_ = config;
+    ResetCascadeStats();
+    LOGI("Rec cascade enabled: %s (mean < %.2f or char < %.2f escalates)",
+         rec_model_path.c_str(), config.min_mean_score, config.min_char_score);
+    return true;
+}
+
+void OcrEngine::DisableRecCascade() {
+    if (cascade_session_) {
+        delete cascade_session_;
+        cascade_session_ = nullptr;
+    }
+    cascade_activation_ = OutputActivation::kUnresolved;
+}
+
+RecCascadeStats OcrEngine::CascadeStats() const {
+    RecCascadeStats stats;
+    stats.lines = cascade_lines_.load(std::memory_order_relaxed);
+    stats.escalated = cascade_escalated_.load(std::memory_order_relaxed);
+    stats.changed = cascade_changed_.load(std::memory_order_relaxed);
+    stats.escalation_us = cascade_us_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void OcrEngine::ResetCascadeStats() {
+    cascade_lines_.store(0, std::memory_order_relaxed);
+    cascade_escalated_.store(0, std::memory_order_relaxed);
+    cascade_changed_.store(0, std::memory_order_relaxed);
+    cascade_us_.store(0, std::memory_order_relaxed);
+}
+
+cv::Mat OcrEngine::PreprocessForDetection(const cv::Mat& image, float& scale_x, float& scale_y, TensorBuffer& input) {
     int orig_h = image.rows;
     int orig_w = image.cols;
 
@@ -209,31 +414,12 @@ cv::Mat OcrEngine::PreprocessForDetection(const cv::Mat& image, float& scale_x,
     cv::Mat resized;
     cv::resize(image, resized, cv::Size(new_w, new_h), 0, 0, cv::INTER_LINEAR);
 
-    // Convert to RGB
-    cv::Mat rgb;
-    cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
-
-    // Normalize: (x / 255 - mean) / std
-    cv::Mat normalized;
-    rgb.convertTo(normalized, CV_32F, 1.0 / 255.0);
-
-    std::vector<cv::Mat> channels(3);
-    cv::split(normalized, channels);
-
-    for (int c = 0; c < 3; c++) {
-        channels[c] = (channels[c] - DET_MEAN[c]) / DET_STD[c];
-    }
-
-    cv::merge(channels, normalized);
-
-    // Convert to NCHW format
-    cv::Mat blob;
-    cv::dnn::blobFromImage(normalized, blob, 1.0, cv::Size(), cv::Scalar(), false, false, CV_32F);
-
-    return blob;
+    // BGR -> RGB, (x / 255 - mean) / std and HWC -> NCHW in a single pass
+    float* dst = input.Reserve(static_cast<size_t>(3) * new_h * new_w);
+    return MakeInputBlob<DetInputPipeline>(resized, dst);
 }
 
-cv::Mat OcrEngine::PreprocessForRecognition(const cv::Mat& region) {
+cv::Mat OcrEngine::PreprocessForRecognition(const cv::Mat& region, TensorBuffer& input) {
     int src_h = region.rows;
     int src_w = region.cols;
 
@@ -258,98 +444,50 @@ cv::Mat OcrEngine::PreprocessForRecognition(const cv::Mat& region) {
     cv::resize(region, resized, cv::Size(new_w, REC_IMG_HEIGHT), 0, 0, cv::INTER_LINEAR);
 
     // PP-OCR recognition expects BGR format (no RGB conversion needed)
-    // Normalize: (x / 255 - 0.5) / 0.5 = x / 127.5 - 1
-    cv::Mat normalized;
-    resized.convertTo(normalized, CV_32F, 1.0 / 127.5, -1.0);
-
-    // No padding needed - model accepts dynamic width
-    // Convert to NCHW format
-    cv::Mat blob;
-    cv::dnn::blobFromImage(normalized, blob, 1.0, cv::Size(), cv::Scalar(), false, false, CV_32F);
-
-    return blob;
+    // Normalize x / 127.5 - 1 and convert to NCHW; no padding, model accepts dynamic width
+    float* dst = input.Reserve(static_cast<size_t>(3) * REC_IMG_HEIGHT * new_w);
+    return MakeInputBlob<RecInputPipeline>(resized, dst);
 }
 
 std::vector<TextBox> OcrEngine::DBPostProcess(const float* output_data, int height, int width,
                                                float scale_x, float scale_y,
                                                int orig_width, int orig_height,
-                                               float threshold, float box_threshold) {
+                                               float threshold, float box_threshold,
+                                               bool half_res) {
     std::vector<TextBox> boxes;
 
-    // Create probability map
-    cv::Mat prob_map(height, width, CV_32F, const_cast<float*>(output_data));
-
-    // Debug: check value range
-    double min_val, max_val;
-    cv::minMaxLoc(prob_map, &min_val, &max_val);
-    LOGD("Detection output range: min=%.4f, max=%.4f", min_val, max_val);
-
-    // Apply sigmoid if output looks like logits (values outside 0-1 range)
-    if (min_val < -0.1 || max_val > 1.1) {
-        LOGD("Applying sigmoid activation (detected logits output)");
-        cv::exp(-prob_map, prob_map);
-        prob_map = 1.0 / (1.0 + prob_map);
-
-        cv::minMaxLoc(prob_map, &min_val, &max_val);
-        LOGD("After sigmoid: min=%.4f, max=%.4f", min_val, max_val);
-    }
-
-    // Threshold to binary
-    cv::Mat binary;
-    cv::threshold(prob_map, binary, threshold, 1.0, cv::THRESH_BINARY);
-    binary.convertTo(binary, CV_8UC1, 255);
+    size_t map_size = static_cast<size_t>(height) * width;
 
-    // Debug: count non-zero pixels
-    int non_zero = cv::countNonZero(binary);
-    LOGD("Binary map: %d non-zero pixels (threshold=%.3f)", non_zero, threshold);
+    // Binarize the raw output in one pass: the probability threshold is mapped
+    // into logit space, so no probability map is materialized
+    float cut = det_activation_ == OutputActivation::kSigmoid
+                    ? RawThreshold<OutputActivation::kSigmoid>(threshold)
+                    : RawThreshold<OutputActivation::kNone>(threshold);
 
-    // Find contours
-    std::vector<std::vector<cv::Point>> contours;
-    std::vector<cv::Vec4i> hierarchy;
-    cv::findContours(binary, contours, hierarchy, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
-
-    LOGD("Found %zu contours", contours.size());
-
-    int skipped_small = 0, skipped_score = 0, skipped_size = 0;
-
-    for (const auto& contour : contours) {
-        if (contour.size() < 4) {
-            skipped_small++;
-            continue;
-        }
-
-        // Get minimum area rectangle
-        cv::RotatedRect rect = cv::minAreaRect(contour);
-        cv::Point2f vertices[4];
-        rect.points(vertices);
-
-        // Calculate average score within the contour
-        cv::Mat mask = cv::Mat::zeros(height, width, CV_8UC1);
-        std::vector<std::vector<cv::Point>> temp_contours = {contour};
-        cv::drawContours(mask, temp_contours, 0, cv::Scalar(255), cv::FILLED);
-
-        float mean_score = cv::mean(prob_map, mask)[0];
+    enum Verdict : uint8_t { kKept, kSmallContour, kLowScore, kSmallSize };
 
+    // Filter a scored full-resolution rect and write its corners into `box`
+    auto finish_box = [&](const cv::RotatedRect& rect, float mean_score, TextBox& box) -> Verdict {
         if (mean_score < box_threshold) {
-            skipped_score++;
-            continue;
+            return kLowScore;
         }
 
         // Filter small boxes
         float box_width = rect.size.width;
         float box_height = rect.size.height;
         if (std::min(box_width, box_height) < 3) {
-            skipped_size++;
-            continue;
+            return kSmallSize;
         }
 
+        cv::Point2f vertices[4];
+        rect.points(vertices);
+
         // Expand the box slightly
         float expand_ratio = 1.5f;
         float expand_w = (expand_ratio - 1.0f) * box_width / 2.0f;
         float expand_h = (expand_ratio - 1.0f) * box_height / 2.0f;
 
         // Get the 4 corners and expand
-        TextBox box;
         box.score = mean_score;
 
         for (int i = 0; i < 4; i++) {
@@ -361,7 +499,7 @@ std::vector<TextBox> OcrEngine::DBPostProcess(const float* output_data, int heig
             x = std::max(0.0f, std::min(x, static_cast<float>(orig_width)));
             y = std::max(0.0f, std::min(y, static_cast<float>(orig_height)));
 
-            box.points.push_back(cv::Point2f(x, y));
+            box.points[i] = cv::Point2f(x, y);
         }
 
         // Sort points: top-left, top-right, bottom-right, bottom-left
@@ -378,7 +516,164 @@ std::vector<TextBox> OcrEngine::DBPostProcess(const float* output_data, int heig
             std::swap(box.points[2], box.points[3]);
         }
 
-        boxes.push_back(box);
+        return kKept;
+    };
+
+    // Scored contours and their verdicts; each contour keeps its slot so the
+    // result order does not depend on how the work was split
+    std::vector<TextBox> scored;
+    std::vector<uint8_t> verdicts;
+    std::vector<std::vector<cv::Point>> contours;
+
+    if (half_res && map_size >= DET_HALF_RES_MIN_PIXELS) {
+        // Trace contours on a half-resolution map (even rows, column pairs: a
+        // quarter of the pixels, half the rows read), score each on the same
+        // samples, and move only the four box edges onto the full-resolution
+        // map. Nothing else touches full resolution.
+        int half_h = (height + 1) / 2;
+        int half_w = (width + 1) / 2;
+        cv::Mat coarse(half_h, half_w, CV_8UC1);
+        BinarizeAboveHalfRes(output_data, height, width, cut, coarse.data, coarse.step);
+
+        cv::findContours(coarse, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+        LOGD("Found %zu half-res contours (threshold=%.3f, %dx%d)", contours.size(), threshold, half_w, half_h);
+
+        // Whether any full-resolution pixel on the segment center + t * normal
+        // + s * along, |s| <= half_len, is above the cut. Stops at the first hit.
+        auto line_hits = [&](const cv::Point2f& center, const cv::Point2f& normal, const cv::Point2f& along,
+                             float t, float half_len) {
+            int steps = static_cast<int>(half_len);
+            for (int s = -steps; s <= steps; s++) {
+                int x = cvRound(center.x + t * normal.x + s * along.x);
+                int y = cvRound(center.y + t * normal.y + s * along.y);
+                if (x >= 0 && x < width && y >= 0 && y < height &&
+                    output_data[static_cast<size_t>(y) * width + x] > cut) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        // Half-res extent along `normal` is within a couple of pixels of the
+        // real one: walk outward from just inside it while the line still hits.
+        // `center` is a pixel center, so axis-aligned lines land on pixel rows.
+        auto refine_edge = [&](const cv::Point2f& center, const cv::Point2f& normal, const cv::Point2f& along,
+                               float extent, float half_len) {
+            const float kSlack = 2.0f;
+            float t = std::floor(extent) - kSlack;
+            if (!line_hits(center, normal, along, t, half_len)) {
+                return extent;
+            }
+            while (t + 1.0f <= extent + kSlack && line_hits(center, normal, along, t + 1.0f, half_len)) {
+                t += 1.0f;
+            }
+            return t;
+        };
+
+        scored.resize(contours.size());
+        verdicts.resize(contours.size());
+        parallelFor(contours.size(), DET_CONTOUR_GRAIN, [&](size_t begin, size_t end) {
+            cv::Mat mask;
+            for (size_t c = begin; c < end; c++) {
+                const std::vector<cv::Point>& contour = contours[c];
+                if (contour.size() < 4) {
+                    // One half-res row: at most 3 full-resolution rows, which
+                    // the full path drops as too small
+                    verdicts[c] = kSmallContour;
+                    continue;
+                }
+
+                // Mean over the half-res samples inside the contour
+                cv::Rect bounds = cv::boundingRect(contour) & cv::Rect(0, 0, half_w, half_h);
+                mask.create(bounds.size(), CV_8UC1);
+                mask.setTo(0);
+                std::vector<std::vector<cv::Point>> temp_contours = {contour};
+                cv::drawContours(mask, temp_contours, 0, cv::Scalar(255), cv::FILLED, cv::LINE_8,
+                                 cv::noArray(), INT_MAX, -bounds.tl());
+                const float* region = output_data + static_cast<size_t>(2 * bounds.y) * width + 2 * bounds.x;
+                float mean_score = det_activation_ == OutputActivation::kSigmoid
+                                       ? MaskedMeanActivation<OutputActivation::kSigmoid>(region, 2 * width, mask, 2)
+                                       : MaskedMeanActivation<OutputActivation::kNone>(region, 2 * width, mask, 2);
+                if (mean_score < box_threshold) {
+                    verdicts[c] = kLowScore;
+                    continue;
+                }
+
+                // Half-res rect in full-resolution coordinates (cell (x, y)
+                // stands for columns 2x..2x+1 of row 2y), measured from the
+                // nearest pixel center
+                cv::RotatedRect rect = cv::minAreaRect(contour);
+                cv::Point2f scaled(2.0f * rect.center.x + 0.5f, 2.0f * rect.center.y);
+                cv::Point2f center(std::round(scaled.x), std::round(scaled.y));
+                float angle = rect.angle * static_cast<float>(CV_PI / 180.0);
+                cv::Point2f u(std::cos(angle), std::sin(angle));  // Along rect.size.width
+                cv::Point2f v(-u.y, u.x);                          // Along rect.size.height
+                float shift_u = (scaled - center).dot(u);
+                float shift_v = (scaled - center).dot(v);
+                // Full-resolution half extents: twice the half-res ones, halved
+                float extent_u = rect.size.width;
+                float extent_v = rect.size.height;
+
+                float right = refine_edge(center, u, v, extent_u + shift_u, extent_v);
+                float left = refine_edge(center, -u, v, extent_u - shift_u, extent_v);
+                float bottom = refine_edge(center, v, u, extent_v + shift_v, extent_u);
+                float top = refine_edge(center, -v, u, extent_v - shift_v, extent_u);
+
+                cv::Point2f refined_center = center + u * ((right - left) / 2.0f) + v * ((bottom - top) / 2.0f);
+                cv::RotatedRect refined(refined_center, cv::Size2f(right + left, bottom + top), rect.angle);
+                verdicts[c] = finish_box(refined, mean_score, scored[c]);
+            }
+        });
+    } else {
+        cv::Mat binary(height, width, CV_8UC1);
+        BinarizeAbove(output_data, binary.ptr<uint8_t>(), map_size, cut);
+
+        // Find contours
+        cv::findContours(binary, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+
+        LOGD("Found %zu contours (threshold=%.3f)", contours.size(), threshold);
+
+        // Score contours in parallel
+        scored.resize(contours.size());
+        verdicts.resize(contours.size());
+        parallelFor(contours.size(), DET_CONTOUR_GRAIN, [&](size_t begin, size_t end) {
+            cv::Mat mask;
+            for (size_t c = begin; c < end; c++) {
+                const std::vector<cv::Point>& contour = contours[c];
+                if (contour.size() < 4) {
+                    verdicts[c] = kSmallContour;
+                    continue;
+                }
+
+                // Get minimum area rectangle
+                cv::RotatedRect rect = cv::minAreaRect(contour);
+
+                // Average probability inside the contour: fill it into a mask the size of
+                // its bounding rect and activate only those pixels
+                cv::Rect bounds = cv::boundingRect(contour) & cv::Rect(0, 0, width, height);
+                mask.create(bounds.size(), CV_8UC1);
+                mask.setTo(0);
+                std::vector<std::vector<cv::Point>> temp_contours = {contour};
+                cv::drawContours(mask, temp_contours, 0, cv::Scalar(255), cv::FILLED, cv::LINE_8,
+                                 cv::noArray(), INT_MAX, -bounds.tl());
+
+                const float* region = output_data + static_cast<size_t>(bounds.y) * width + bounds.x;
+                float mean_score = det_activation_ == OutputActivation::kSigmoid
+                                       ? MaskedMeanActivation<OutputActivation::kSigmoid>(region, width, mask)
+                                       : MaskedMeanActivation<OutputActivation::kNone>(region, width, mask);
+                verdicts[c] = finish_box(rect, mean_score, scored[c]);
+            }
+        });
+    }
+
+    int skipped_small = 0, skipped_score = 0, skipped_size = 0;
+    for (size_t c = 0; c < verdicts.size(); c++) {
+        switch (verdicts[c]) {
+            case kKept: boxes.push_back(scored[c]); break;
+            case kSmallContour: skipped_small++; break;
+            case kLowScore: skipped_score++; break;
+            case kSmallSize: skipped_size++; break;
+        }
     }
 
     // Sort boxes by y coordinate (top to bottom, left to right)
@@ -397,107 +692,54 @@ std::vector<TextBox> OcrEngine::DBPostProcess(const float* output_data, int heig
     return boxes;
 }
 
-std::pair<std::string, float> OcrEngine::CTCDecode(const float* output_data, int seq_len, int vocab_size) {
-    std::string result;
+float OcrEngine::CTCDecode(const float* output_data, int seq_len, int vocab_size, std::string& text,
+                           float* min_score, const OutputActivation* activation) {
+    OutputActivation act = activation ? *activation : rec_activation_;
+    if (act == OutputActivation::kSoftmax) {
+        return CTCDecodeImpl<OutputActivation::kSoftmax>(output_data, seq_len, vocab_size, text, min_score);
+    }
+    return CTCDecodeImpl<OutputActivation::kNone>(output_data, seq_len, vocab_size, text, min_score);
+}
+
+template <OutputActivation Act>
+float OcrEngine::CTCDecodeImpl(const float* output_data, int seq_len, int vocab_size, std::string& text,
+                               float* min_score) {
     float total_score = 0.0f;
+    float min_val = 1.0f;
     int char_count = 0;
     int prev_idx = -1;
     int blank_count = 0;
-    std::string indices_str;  // For debug: track which indices were decoded
-
-    // Debug: check first few values to understand data format
-    float first_min = output_data[0], first_max = output_data[0];
-    float first_sum = 0.0f;
-    for (int i = 0; i < vocab_size; i++) {
-        first_min = std::min(first_min, output_data[i]);
-        first_max = std::max(first_max, output_data[i]);
-        first_sum += output_data[i];
-    }
-    LOGD("CTCDecode: seq_len=%d, vocab_size=%d, first timestep range=[%.4f, %.4f], sum=%.4f",
-         seq_len, vocab_size, first_min, first_max, first_sum);
-
-    // Check if we need to apply softmax (output looks like logits, not probabilities)
-    // If values are negative or sum is not ~1.0, it's likely logits
-    bool need_softmax = (first_min < -0.001f || std::abs(first_sum - 1.0f) > 0.1f);
-    if (need_softmax) {
-        LOGD("Applying softmax to recognition output (detected logits: min=%.4f, sum=%.4f)", first_min, first_sum);
-    } else {
-        LOGD("Output appears to be probabilities (sum=%.4f), skipping softmax", first_sum);
-    }
 
     for (int t = 0; t < seq_len; t++) {
-        const float* timestep_data = output_data + t * vocab_size;
-
-        // Apply softmax if needed
-        std::vector<float> probs(vocab_size);
-        if (need_softmax) {
-            // Find max for numerical stability
-            float max_logit = timestep_data[0];
-            for (int v = 1; v < vocab_size; v++) {
-                max_logit = std::max(max_logit, timestep_data[v]);
-            }
-
-            // Compute exp and sum
-            float sum_exp = 0.0f;
-            for (int v = 0; v < vocab_size; v++) {
-                probs[v] = std::exp(timestep_data[v] - max_logit);
-                sum_exp += probs[v];
-            }
-
-            // Normalize
-            for (int v = 0; v < vocab_size; v++) {
-                probs[v] /= sum_exp;
-            }
-        } else {
-            for (int v = 0; v < vocab_size; v++) {
-                probs[v] = timestep_data[v];
-            }
-        }
-
-        // Find argmax
-        int max_idx = 0;
-        float max_val = probs[0];
-        for (int v = 1; v < vocab_size; v++) {
-            if (probs[v] > max_val) {
-                max_val = probs[v];
-                max_idx = v;
-            }
-        }
+        auto [max_idx, max_val] = ArgmaxProbability<Act>(output_data + t * vocab_size, vocab_size);
 
         // Skip blank (index 0) and repeated characters
         if (max_idx == 0) {
             blank_count++;
         } else if (max_idx != prev_idx) {
             if (max_idx < static_cast<int>(dictionary_.size())) {
-                result += dictionary_[max_idx];
+                text += dictionary_[max_idx];
                 total_score += max_val;
+                min_val = std::min(min_val, max_val);
                 char_count++;
-                // Track decoded indices for first few characters
-                if (char_count <= 10) {
-                    indices_str += std::to_string(max_idx) + "(" + dictionary_[max_idx] + ") ";
-                }
             } else {
-                LOGD("WARNING: max_idx %d out of range (dict size=%zu)", max_idx, dictionary_.size());
+                LOGW("max_idx %d out of range (dict size=%zu)", max_idx, dictionary_.size());
             }
         }
         prev_idx = max_idx;
     }
 
     float avg_score = (char_count > 0) ? (total_score / char_count) : 0.0f;
+    if (min_score) {
+        *min_score = char_count > 0 ? min_val : 0.0f;
+    }
 
-    LOGD("CTCDecode result: '%s', %d chars, %d blanks, avg_score=%.4f",
-         result.c_str(), char_count, blank_count, avg_score);
-    LOGD("Decoded indices (first 10): %s", indices_str.c_str());
-    LOGD("Dictionary size: %zu", dictionary_.size());
+    LOGD("CTCDecode result: %d chars, %d blanks, avg_score=%.4f", char_count, blank_count, avg_score);
 
-    return {result, avg_score};
+    return avg_score;
 }
 
 cv::Mat OcrEngine::CropTextRegion(const cv::Mat& image, const TextBox& box) {
-    if (box.points.size() != 4) {
-        return cv::Mat();
-    }
-
     // Get bounding rectangle
     float min_x = box.points[0].x, max_x = box.points[0].x;
     float min_y = box.points[0].y, max_y = box.points[0].y;
@@ -556,17 +798,23 @@ cv::Mat OcrEngine::CropTextRegion(const cv::Mat& image, const TextBox& box) {
     return cropped;
 }
 
-std::vector<TextBox> OcrEngine::DetectText(const cv::Mat& image, float threshold) {
-    std::vector<TextBox> boxes;
+std::vector<TextBox> OcrEngine::DetectText(const cv::Mat& image, float threshold, bool half_res_post) {
+    DetMap map;
+    if (!DetectMap(image, map)) {
+        return {};
+    }
+    return DetectFromMap(map, threshold, half_res_post);
+}
 
+bool OcrEngine::DetectMap(const cv::Mat& image, DetMap& map) {
     if (!initialized_ || !det_session_) {
         LOGD("Detection model not initialized");
-        return boxes;
+        return false;
     }
 
     if (image.empty()) {
         LOGD("Empty image for detection");
-        return boxes;
+        return false;
     }
 
     try {
@@ -574,7 +822,8 @@ std::vector<TextBox> OcrEngine::DetectText(const cv::Mat& image, float threshold
 
         // Preprocess
         float scale_x, scale_y;
-        cv::Mat blob = PreprocessForDetection(image, scale_x, scale_y);
+        auto input_buffer = det_inputs_.Acquire();
+        cv::Mat blob = PreprocessForDetection(image, scale_x, scale_y, *input_buffer);
 
         int batch = blob.size[0];
         int channels = blob.size[1];
@@ -585,7 +834,7 @@ std::vector<TextBox> OcrEngine::DetectText(const cv::Mat& image, float threshold
 
         // Prepare input tensor
         std::vector<int64_t> input_shape = {batch, channels, height, width};
-        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const Ort::MemoryInfo& memory_info = CpuMemoryInfo();
 
         Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
             memory_info, blob.ptr<float>(), blob.total(),
@@ -599,36 +848,97 @@ std::vector<TextBox> OcrEngine::DetectText(const cv::Mat& image, float threshold
         const char* input_names[] = {input_name.get()};
         const char* output_names[] = {output_name.get()};
 
-        auto outputs = det_session_->Run(
-            Ort::RunOptions{nullptr},
-            input_names, &input_tensor, 1,
-            output_names, 1);
+        std::vector<Ort::Value> outputs;
+        {
+            // Holds the det session for the run only
+            RequestScheduler::Stage stage(det_session_);
+            // The calling thread joins the intra-op pool, so it is pinned with it
+            ScopedThreadAffinity pin(det_threads_.cpus);
+            outputs = det_session_->Run(
+                Ort::RunOptions{nullptr},
+                input_names, &input_tensor, 1,
+                output_names, 1);
+        }
 
         auto end = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        LOGD("Detection inference: %lld ms", duration);
+        LOGD("Detection inference: %lld ms", (long long)duration);
 
-        // Get output
+        // Copied out: the tensor lives in the env's arena, which may go before the map
         auto output_shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
-        int out_h = static_cast<int>(output_shape[2]);
-        int out_w = static_cast<int>(output_shape[3]);
+        map.height = static_cast<int>(output_shape[2]);
+        map.width = static_cast<int>(output_shape[3]);
+        const float* output_data = outputs[0].GetTensorData<float>();
+        map.values.assign(output_data, output_data + static_cast<size_t>(map.height) * map.width);
+        map.scale_x = scale_x;
+        map.scale_y = scale_y;
+        map.image_width = image.cols;
+        map.image_height = image.rows;
+        return true;
 
-        float* output_data = outputs[0].GetTensorMutableData<float>();
+    } catch (const Ort::Exception& e) {
+        LOGE("Detection ONNX error: %s", e.what());
+    } catch (const std::exception& e) {
+        LOGE("Detection error: %s", e.what());
+    }
+
+    return false;
+}
 
+std::vector<TextBox> OcrEngine::DetectFromMap(const DetMap& map, float threshold, bool half_res_post) {
+    std::vector<TextBox> boxes;
+    if (map.empty()) {
+        return boxes;
+    }
+
+    try {
         // Post-process (lower box_threshold to 0.3 for better detection)
-        boxes = DBPostProcess(output_data, out_h, out_w,
-                             scale_x, scale_y,
-                             image.cols, image.rows,
-                             threshold, 0.3f);
+        boxes = DBPostProcess(map.values.data(), map.height, map.width,
+                             map.scale_x, map.scale_y,
+                             map.image_width, map.image_height,
+                             threshold, 0.3f, half_res_post);
 
         LOGD("Detected %zu text boxes", boxes.size());
 
-    } catch (const Ort::Exception& e) {
-        LOGD("Detection ONNX error: %s", e.what());
     } catch (const std::exception& e) {
-        LOGD("Detection error: %s", e.what());
+        LOGE("Detection error: %s", e.what());
+    }
+
+    return boxes;
+}
+
+std::vector<TextBox> OcrEngine::DetectText(const cv::Mat& image, const OcrOptions& options,
+                                           DetectorBackend* used) {
+    DetectorBackend backend = options.detector;
+    if (backend == DetectorBackend::kAuto) {
+        ImageCleanliness stats = measureCleanliness(image);
+        backend = stats.clean ? DetectorBackend::kClassic : DetectorBackend::kNeural;
+        LOGD("Detector auto-select: %s (background %.2f, bimodality %.2f)",
+             detectorBackendName(backend), stats.background_ratio, stats.bimodality);
+    }
+    if (used) {
+        *used = backend;
+    }
+
+    std::vector<TextBox> boxes;
+    if (backend == DetectorBackend::kClassic) {
+        auto start = std::chrono::high_resolution_clock::now();
+        boxes = detectTextClassic(image);
+        auto end = std::chrono::high_resolution_clock::now();
+        LOGD("Classic detection: %lld ms",
+             (long long)std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+    } else {
+        boxes = DetectText(image, options.det_threshold, options.det_half_res);
     }
 
+    if (options.merge_fragments && boxes.size() > 1) {
+        std::vector<MergedBox> merged = mergeCollinearBoxes(boxes);
+        boxes.clear();
+        boxes.reserve(merged.size());
+        for (const MergedBox& line : merged) {
+            boxes.push_back(line.box);
+        }
+    }
     return boxes;
 }
 
@@ -644,7 +954,8 @@ std::pair<std::string, float> OcrEngine::RecognizeRegion(const cv::Mat& region)
 
     try {
         // Preprocess with dynamic width (no chunking needed)
-        cv::Mat blob = PreprocessForRecognition(region);
+        auto input_buffer = rec_inputs_.Acquire();
+        cv::Mat blob = PreprocessForRecognition(region, *input_buffer);
 
         int batch = blob.size[0];
         int channels = blob.size[1];
@@ -655,7 +966,7 @@ std::pair<std::string, float> OcrEngine::RecognizeRegion(const cv::Mat& region)
 
         // Prepare input tensor
         std::vector<int64_t> input_shape = {batch, channels, height, width};
-        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const Ort::MemoryInfo& memory_info = CpuMemoryInfo();
 
         Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
             memory_info, blob.ptr<float>(), blob.total(),
@@ -669,10 +980,15 @@ std::pair<std::string, float> OcrEngine::RecognizeRegion(const cv::Mat& region)
         const char* input_names[] = {input_name.get()};
         const char* output_names[] = {output_name.get()};
 
-        auto outputs = rec_session_->Run(
-            Ort::RunOptions{nullptr},
-            input_names, &input_tensor, 1,
-            output_names, 1);
+        std::vector<Ort::Value> outputs;
+        {
+            RequestScheduler::Stage stage(rec_session_);
+            ScopedThreadAffinity pin(rec_threads_.cpus);
+            outputs = rec_session_->Run(
+                Ort::RunOptions{nullptr},
+                input_names, &input_tensor, 1,
+                output_names, 1);
+        }
 
         // Get output
         auto output_shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
@@ -686,19 +1002,29 @@ std::pair<std::string, float> OcrEngine::RecognizeRegion(const cv::Mat& region)
         float* output_data = outputs[0].GetTensorMutableData<float>();
 
         // CTC decode
-        return CTCDecode(output_data, seq_len, vocab_size);
+        std::string text;
+        float score = CTCDecode(output_data, seq_len, vocab_size, text);
+        return {text, score};
 
     } catch (const Ort::Exception& e) {
-        LOGD("Recognition ONNX error: %s", e.what());
+        LOGE("Recognition ONNX error: %s", e.what());
     } catch (const std::exception& e) {
-        LOGD("Recognition error: %s", e.what());
+        LOGE("Recognition error: %s", e.what());
     }
 
     return {"", 0.0f};
 }
 
-std::vector<TextLineResult> OcrEngine::RecognizeText(const cv::Mat& image, float det_threshold, float rec_threshold) {
-    std::vector<TextLineResult> results;
+TextLines OcrEngine::RecognizeText(const cv::Mat& image, float det_threshold, float rec_threshold) {
+    OcrOptions options;
+    options.det_threshold = det_threshold;
+    options.rec_threshold = rec_threshold;
+    return RecognizeText(image, options);
+}
+
+TextLines OcrEngine::RecognizeText(const cv::Mat& image, const OcrOptions& options,
+                                   DetectorBackend* used) {
+    TextLines results;
 
     if (!initialized_) {
         LOGD("OCR Engine not initialized");
@@ -713,89 +1039,435 @@ std::vector<TextLineResult> OcrEngine::RecognizeText(const cv::Mat& image, float
     auto total_start = std::chrono::high_resolution_clock::now();
 
     // Step 1: Detect text boxes
-    std::vector<TextBox> boxes = DetectText(image, det_threshold);
+    std::vector<TextBox> boxes = DetectText(image, options, used);
 
     if (boxes.empty()) {
         LOGD("No text detected");
         return results;
     }
 
-    auto rec_start = std::chrono::high_resolution_clock::now();
-
     // Step 2: Recognize each text box
-    int box_idx = 0;
-    int skipped_empty_region = 0, skipped_low_score = 0, skipped_empty_text = 0;
-
-    for (const auto& box : boxes) {
-        // Crop text region
-        cv::Mat region = CropTextRegion(image, box);
-        if (region.empty()) {
-            skipped_empty_region++;
-            box_idx++;
+    results = RecognizeBoxes(image, boxes, options.rec_threshold);
+
+    auto total_end = std::chrono::high_resolution_clock::now();
+    auto total_duration = std::chrono::duration_cast<std::chrono::milliseconds>(total_end - total_start).count();
+    LOGD("Total OCR: %lld ms, Results: %zu", (long long)total_duration, results.size());
+
+    return results;
+}
+
+// Width / height of the crop a box will produce (vertical boxes are rotated upright)
+static float EstimatedRecAspect(const TextBox& box) {
+    float width = static_cast<float>(cv::norm(box.points[1] - box.points[0]));
+    float height = static_cast<float>(cv::norm(box.points[3] - box.points[0]));
+    if (width <= 0.0f || height <= 0.0f) {
+        return 0.0f;
+    }
+    return height > width * 1.5f ? height / width : width / height;
+}
+
+OcrEngine::CropPlan OcrEngine::PlanCrops(const cv::Mat& image, const std::vector<TextBox>& boxes) {
+    CropPlan plan;
+    plan.page = image;
+    plan.slices.assign(boxes.size(), cv::Rect());
+
+    // Dominant text angle: median of the boxes' top edges
+    std::vector<float> angles;
+    angles.reserve(boxes.size());
+    for (const TextBox& box : boxes) {
+        cv::Point2f edge = box.points[1] - box.points[0];
+        if (edge.x > 0.0f) {
+            angles.push_back(static_cast<float>(std::atan2(edge.y, edge.x) * 180.0 / CV_PI));
+        }
+    }
+    if (angles.empty()) {
+        return plan;
+    }
+    std::nth_element(angles.begin(), angles.begin() + angles.size() / 2, angles.end());
+    float angle = angles[angles.size() / 2];
+    if (std::abs(angle) > DESKEW_MAX_ANGLE) {
+        return plan;
+    }
+
+    // Rotate the page once, onto a canvas large enough to keep its corners
+    cv::Mat to_page;
+    if (std::abs(angle) >= DESKEW_MIN_ANGLE) {
+        if (boxes.size() < DESKEW_MIN_BOXES) {
+            return plan;
+        }
+        cv::Point2f center(image.cols / 2.0f, image.rows / 2.0f);
+        cv::Rect2f bounds = cv::RotatedRect(center, cv::Size2f(image.size()), angle).boundingRect2f();
+        to_page = cv::getRotationMatrix2D(center, angle, 1.0);
+        to_page.at<double>(0, 2) += bounds.width / 2.0 - center.x;
+        to_page.at<double>(1, 2) += bounds.height / 2.0 - center.y;
+        cv::warpAffine(image, plan.page, to_page, cv::Size(cvRound(bounds.width), cvRound(bounds.height)),
+                       cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+    }
+
+    // Boxes that come out axis-aligned in the page become slices
+    cv::Rect page_rect(0, 0, plan.page.cols, plan.page.rows);
+    size_t sliced = 0;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        std::vector<cv::Point2f> mapped(boxes[i].points.begin(), boxes[i].points.end());
+        if (!to_page.empty()) {
+            cv::transform(mapped, mapped, to_page);
+        }
+        float slant = std::max({std::abs(mapped[1].y - mapped[0].y), std::abs(mapped[2].y - mapped[3].y),
+                                std::abs(mapped[3].x - mapped[0].x), std::abs(mapped[2].x - mapped[1].x)});
+        if (slant > DESKEW_MAX_SLANT) {
             continue;
         }
+        plan.slices[i] = cv::boundingRect(mapped) & page_rect;
+        sliced += plan.slices[i].empty() ? 0 : 1;
+    }
+
+    LOGD("Crop plan: page angle %.2f deg (%s), %zu of %zu boxes sliced", angle,
+         to_page.empty() ? "as is" : "rotated once", sliced, boxes.size());
+    return plan;
+}
+
+OcrEngine::RecBatch OcrEngine::PrepareRecBatch(const cv::Mat& image, const std::vector<TextBox>& boxes,
+                                               const CropPlan& plan, const size_t* order, size_t count,
+                                               TensorBuffer& input) {
+    RecBatch batch;
+
+    // Crop and resize each box on the task scheduler
+    std::vector<cv::Mat> items(count);
+    parallelFor(count, 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            const cv::Rect& slice = plan.slices[order[k]];
+            cv::Mat region;
+            if (slice.empty()) {
+                region = CropTextRegion(image, boxes[order[k]]);
+            } else if (slice.height > slice.width * 1.5) {
+                // Vertical text, rotated upright as CropTextRegion does
+                cv::rotate(plan.page(slice), region, cv::ROTATE_90_CLOCKWISE);
+            } else {
+                region = plan.page(slice);
+            }
+            if (region.empty()) {
+                continue;
+            }
+
+            float ratio = static_cast<float>(REC_IMG_HEIGHT) / region.rows;
+            int new_w = std::clamp(static_cast<int>(region.cols * ratio), 1, REC_IMG_MAX_WIDTH);
+            cv::resize(region, items[k], cv::Size(new_w, REC_IMG_HEIGHT), 0, 0, cv::INTER_LINEAR);
+        }
+    });
+
+    std::vector<cv::Mat> resized;
+    resized.reserve(count);
+    for (size_t k = 0; k < count; k++) {
+        if (items[k].empty()) {
+            batch.empty_regions++;
+            continue;
+        }
+        resized.push_back(items[k]);
+        batch.box_indices.push_back(order[k]);
+        batch.width = std::max(batch.width, items[k].cols);
+    }
+
+    if (resized.empty()) {
+        return batch;
+    }
+
+    const size_t item_floats = static_cast<size_t>(3) * REC_IMG_HEIGHT * batch.width;
+    float* dst = input.Reserve(item_floats * resized.size());
+    parallelFor(resized.size(), 2, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            PackToPlanarPadded<RecInputPipeline>(resized[k], dst + k * item_floats, batch.width);
+        }
+    });
+    return batch;
+}
+
+Ort::Value OcrEngine::RunRecBatch(const RecBatch& batch, TensorBuffer& input, bool cascade) {
+    std::vector<int64_t> input_shape = {static_cast<int64_t>(batch.box_indices.size()), 3,
+                                        REC_IMG_HEIGHT, batch.width};
+    size_t total = static_cast<size_t>(input_shape[0]) * 3 * REC_IMG_HEIGHT * batch.width;
+
+    Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+        CpuMemoryInfo(), input.data(), total,
+        input_shape.data(), input_shape.size());
+
+    Ort::Session& session = cascade ? *cascade_session_ : *rec_session_;
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto input_name = session.GetInputNameAllocated(0, allocator);
+    auto output_name = session.GetOutputNameAllocated(0, allocator);
+
+    const char* input_names[] = {input_name.get()};
+    const char* output_names[] = {output_name.get()};
+
+    RequestScheduler::Stage stage(&session);
+    ScopedThreadAffinity pin(rec_threads_.cpus);
+    auto outputs = session.Run(
+        Ort::RunOptions{nullptr},
+        input_names, &input_tensor, 1,
+        output_names, 1);
+    return std::move(outputs[0]);
+}
+
+void OcrEngine::DecodeRecBatch(RecBatch& batch, const Ort::Value& output, bool cascade) {
+    // [batch, seq_len, vocab_size]; padding decodes to trailing blanks
+    auto shape = output.GetTensorTypeAndShapeInfo().GetShape();
+    int seq_len = static_cast<int>(shape[1]);
+    int vocab_size = static_cast<int>(shape[2]);
+    const float* data = output.GetTensorData<float>();
+
+    size_t count = batch.box_indices.size();
+    batch.text.clear();
+    batch.text_ends.resize(count);
+    batch.scores.resize(count);
+    batch.min_scores.resize(count);
+    const OutputActivation* activation = cascade ? &cascade_activation_ : &rec_activation_;
+    for (size_t k = 0; k < count; k++) {
+        batch.scores[k] = CTCDecode(data + k * seq_len * vocab_size, seq_len, vocab_size, batch.text,
+                                    &batch.min_scores[k], activation);
+        batch.text_ends[k] = static_cast<uint32_t>(batch.text.size());
+    }
+}
+
+void OcrEngine::EscalateRecLines(const cv::Mat& image, const std::vector<TextBox>& boxes, const CropPlan& plan,
+                                 const std::vector<float>& min_scores, std::vector<RecBatch>& batches,
+                                 std::vector<std::string_view>& texts, std::vector<float>& scores,
+                                 TensorBuffer& input) {
+    // Lines the fast model read with doubt. Empty reads of non-empty crops
+    // are mostly det noise and stay as they are.
+    std::vector<size_t> order;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (!texts[i].empty() && (scores[i] < cascade_config_.min_mean_score ||
+                                  min_scores[i] < cascade_config_.min_char_score)) {
+            order.push_back(i);
+        }
+    }
+    if (order.empty()) {
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<float> aspect(boxes.size());
+    for (size_t i : order) {
+        aspect[i] = EstimatedRecAspect(boxes[i]);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return aspect[a] < aspect[b]; });
+
+    // Few lines, so one buffer and no overlap. Every batch is complete
+    // before any view into its text is taken.
+    try {
+        batches.resize((order.size() + REC_BATCH_SIZE - 1) / REC_BATCH_SIZE);
+        for (size_t b = 0; b < batches.size(); b++) {
+            size_t first = b * REC_BATCH_SIZE;
+            size_t count = std::min(REC_BATCH_SIZE, order.size() - first);
+            batches[b] = PrepareRecBatch(image, boxes, plan, order.data() + first, count, input);
+            if (!batches[b].box_indices.empty()) {
+                Ort::Value output = RunRecBatch(batches[b], input, true);
+                DecodeRecBatch(batches[b], output, true);
+            }
+        }
+    } catch (const std::exception& e) {
+        // The fast model's reads stand
+        LOGE("Rec cascade error: %s", e.what());
+        batches.clear();
+        return;
+    }
+
+    uint64_t changed = 0;
+    for (const RecBatch& batch : batches) {
+        uint32_t begin = 0;
+        for (size_t k = 0; k < batch.box_indices.size(); k++) {
+            size_t i = batch.box_indices[k];
+            std::string_view text = std::string_view(batch.text).substr(begin, batch.text_ends[k] - begin);
+            if (text != texts[i]) {
+                changed++;
+            }
+            texts[i] = text;
+            scores[i] = batch.scores[k];
+            begin = batch.text_ends[k];
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    cascade_escalated_.fetch_add(order.size(), std::memory_order_relaxed);
+    cascade_changed_.fetch_add(changed, std::memory_order_relaxed);
+    cascade_us_.fetch_add(static_cast<uint64_t>(elapsed), std::memory_order_relaxed);
+    LOGD("Rec cascade: %zu lines escalated, %llu changed, %lld us",
+         order.size(), (unsigned long long)changed, (long long)elapsed);
+}
+
+TextLines OcrEngine::RecognizeBoxes(const cv::Mat& image, const std::vector<TextBox>& boxes,
+                                    float rec_threshold, std::vector<size_t>* line_boxes, bool* decoded) {
+    TextLines results;
+    if (decoded) {
+        *decoded = false;
+    }
+
+    if (!initialized_ || !rec_session_) {
+        LOGD("OCR Engine not initialized");
+        return results;
+    }
 
-        // Recognize
-        auto [text, score] = RecognizeRegion(region);
+    if (image.empty()) {
+        return results;
+    }
+    if (boxes.empty()) {
+        if (decoded) {
+            *decoded = true;
+        }
+        return results;
+    }
 
-        LOGD("Box %d: region %dx%d, text='%s', score=%.4f",
-             box_idx, region.cols, region.rows,
-             text.substr(0, 20).c_str(), score);
+    auto rec_start = std::chrono::high_resolution_clock::now();
+
+    // Similar aspect ratios share a batch, so little of each batch is padding
+    std::vector<size_t> order(boxes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<float> aspect(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        aspect[i] = EstimatedRecAspect(boxes[i]);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return aspect[a] < aspect[b]; });
+
+    const size_t batch_count = (boxes.size() + REC_BATCH_SIZE - 1) / REC_BATCH_SIZE;
+    std::vector<RecBatch> batches(batch_count);
+    CropPlan plan;
+
+    // Double buffering: while batch b runs, scheduler tasks crop and pack
+    // batch b + 1 into the other input buffer and decode batch b - 1
+    auto buffer_a = rec_inputs_.Acquire();
+    auto buffer_b = rec_inputs_.Acquire();
+    TensorBuffer* inputs[2] = {&*buffer_a, &*buffer_b};
+
+    auto prepare = [&](size_t b) {
+        size_t first = b * REC_BATCH_SIZE;
+        size_t count = std::min(REC_BATCH_SIZE, boxes.size() - first);
+        batches[b] = PrepareRecBatch(image, boxes, plan, order.data() + first, count, *inputs[b % 2]);
+    };
+
+    try {
+        // Deskew once, so most crops are slices rather than per-line warps
+        plan = PlanCrops(image, boxes);
+        prepare(0);
+        Ort::Value previous_output{nullptr};
+
+        for (size_t b = 0; b < batch_count; b++) {
+            TaskGroup overlap;
+            if (b + 1 < batch_count) {
+                overlap.Run([&, b]() { prepare(b + 1); });
+            }
+            if (b > 0 && !batches[b - 1].box_indices.empty()) {
+                overlap.Run([&, b]() { DecodeRecBatch(batches[b - 1], previous_output); });
+            }
+
+            Ort::Value output{nullptr};
+            if (!batches[b].box_indices.empty()) {
+                output = RunRecBatch(batches[b], *inputs[b % 2]);
+            }
+
+            overlap.Wait();
+            previous_output = std::move(output);
+        }
+
+        if (!batches[batch_count - 1].box_indices.empty()) {
+            DecodeRecBatch(batches[batch_count - 1], previous_output);
+        }
+    } catch (const Ort::Exception& e) {
+        LOGE("Recognition ONNX error: %s", e.what());
+        return results;
+    } catch (const std::exception& e) {
+        LOGE("Recognition error: %s", e.what());
+        return results;
+    }
+    if (decoded) {
+        *decoded = true;
+    }
+
+    // Where each box's text landed: batch text views, resolved now that no
+    // batch string grows any more
+    std::vector<std::string_view> texts(boxes.size());
+    std::vector<float> scores(boxes.size(), 0.0f);
+    std::vector<float> min_scores(boxes.size(), 0.0f);
+    int skipped_empty_region = 0;
+    size_t text_bytes = 0, read_boxes = 0;
+    for (const RecBatch& batch : batches) {
+        skipped_empty_region += batch.empty_regions;
+        text_bytes += batch.text.size();
+        read_boxes += batch.box_indices.size();
+        uint32_t begin = 0;
+        for (size_t k = 0; k < batch.box_indices.size(); k++) {
+            texts[batch.box_indices[k]] = std::string_view(batch.text).substr(begin, batch.text_ends[k] - begin);
+            scores[batch.box_indices[k]] = batch.scores[k];
+            min_scores[batch.box_indices[k]] = batch.min_scores[k];
+            begin = batch.text_ends[k];
+        }
+    }
+
+    // Unsure lines get a second read from the accurate model
+    std::vector<RecBatch> escalated;
+    if (cascade_session_) {
+        cascade_lines_.fetch_add(read_boxes, std::memory_order_relaxed);
+        EscalateRecLines(image, boxes, plan, min_scores, escalated, texts, scores, *inputs[0]);
+        for (const RecBatch& batch : escalated) {
+            text_bytes += batch.text.size();
+        }
+    }
+
+    // One line vector and one arena block for the whole result
+    results.Reserve(boxes.size(), text_bytes);
+    int skipped_low_score = 0, skipped_empty_text = 0;
+
+    for (size_t box_idx = 0; box_idx < boxes.size(); box_idx++) {
+        const TextBox& box = boxes[box_idx];
+        std::string_view text = texts[box_idx];
+        float score = scores[box_idx];
+
+        LOGD("Box %zu: %zu bytes, score=%.4f", box_idx, text.size(), score);
 
         if (text.empty()) {
             skipped_empty_text++;
-            box_idx++;
             continue;
         }
 
         if (score < rec_threshold) {
             skipped_low_score++;
-            box_idx++;
             continue;
         }
 
-        if (true) {  // Accepted
-            TextLineResult result;
-
-            // Get bounding box (axis-aligned)
-            float min_x = box.points[0].x, max_x = box.points[0].x;
-            float min_y = box.points[0].y, max_y = box.points[0].y;
-            for (const auto& pt : box.points) {
-                min_x = std::min(min_x, pt.x);
-                max_x = std::max(max_x, pt.x);
-                min_y = std::min(min_y, pt.y);
-                max_y = std::max(max_y, pt.y);
-            }
-
-            result.x1 = min_x;
-            result.y1 = min_y;
-            result.x2 = max_x;
-            result.y2 = max_y;
-            result.score = score;
-            result.text = text;
+        // Get bounding box (axis-aligned)
+        float min_x = box.points[0].x, max_x = box.points[0].x;
+        float min_y = box.points[0].y, max_y = box.points[0].y;
+        for (const auto& pt : box.points) {
+            min_x = std::min(min_x, pt.x);
+            max_x = std::max(max_x, pt.x);
+            min_y = std::min(min_y, pt.y);
+            max_y = std::max(max_y, pt.y);
+        }
 
-            results.push_back(result);
+        results.Add(min_x, min_y, max_x, max_y, score, text);
+        if (line_boxes) {
+            line_boxes->push_back(box_idx);
         }
-        box_idx++;
     }
 
-    auto total_end = std::chrono::high_resolution_clock::now();
-    auto rec_duration = std::chrono::duration_cast<std::chrono::milliseconds>(total_end - rec_start).count();
-    auto total_duration = std::chrono::duration_cast<std::chrono::milliseconds>(total_end - total_start).count();
+    // Empty crops never reached the model and decode as empty text
+    skipped_empty_text -= skipped_empty_region;
+
+    auto rec_end = std::chrono::high_resolution_clock::now();
+    auto rec_duration = std::chrono::duration_cast<std::chrono::milliseconds>(rec_end - rec_start).count();
 
-    LOGD("Recognition summary: %d boxes, skipped: %d empty region, %d empty text, %d low score (threshold=%.2f)",
-         box_idx, skipped_empty_region, skipped_empty_text, skipped_low_score, rec_threshold);
-    LOGD("Recognition: %lld ms, Total OCR: %lld ms, Results: %zu", rec_duration, total_duration, results.size());
+    LOGD("Recognition summary: %zu boxes in %zu batches, skipped: %d empty region, %d empty text, %d low score (threshold=%.2f)",
+         boxes.size(), batch_count, skipped_empty_region, skipped_empty_text, skipped_low_score, rec_threshold);
+    LOGD("Recognition: %lld ms, Results: %zu", (long long)rec_duration, results.size());
 
     return results;
 }
 
 // Legacy function for backward compatibility
-std::vector<TextLineResult> recognizeText(const cv::Mat& image, float conf_threshold) {
+TextLines recognizeText(const cv::Mat& image, float conf_threshold) {
     return OcrEngine::GetInstance().RecognizeText(image, 0.3f, conf_threshold);
 }
 
-std::string getFullText(const std::vector<TextLineResult>& results) {
+std::string getFullText(const TextLines& results) {
     std::ostringstream text;
     for (size_t i = 0; i < results.size(); i++) {
         text << results[i].text;
@@ -806,7 +1478,7 @@ std::string getFullText(const std::vector<TextLineResult>& results) {
     return text.str();
 }
 
-std::string ocrResultsToJson(const std::vector<TextLineResult>& results) {
+std::string ocrResultsToJson(const TextLines& results) {
     std::ostringstream json;
     json << "{\"results\":[";
 
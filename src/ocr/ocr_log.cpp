@@ -0,0 +1,149 @@
+#include "include/ocr_log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#elif defined(__APPLE__)
+#include <os/log.h>
+#endif
+
+// One message. `seq` is 2n+1 while message n is being written into the slot
+// and 2n+2 once it is complete, so readers can tell a finished entry from a
+// torn one by reading it before and after copying (a seqlock).
+struct LogSlot {
+    std::atomic<uint64_t> seq{0};
+    LogLevel level = LogLevel::kDebug;
+    int64_t time_us = 0;
+    uint32_t thread = 0;
+    char text[LOG_MESSAGE_BYTES] = {};
+};
+
+static LogSlot g_slots[LOG_RING_CAPACITY];
+static std::atomic<uint64_t> g_head{0};     // Next message number
+static std::atomic<uint64_t> g_floor{0};    // First message number Dump shows
+static std::atomic<uint64_t> g_dropped{0};  // Lost to a slot another writer held
+
+static void echoMessage(LogLevel level, const char* text) {
+#ifdef __ANDROID__
+    static const int priorities[] = {ANDROID_LOG_ERROR, ANDROID_LOG_WARN, ANDROID_LOG_INFO, ANDROID_LOG_DEBUG};
+    __android_log_write(priorities[static_cast<int>(level)], "OcrKit", text);
+#elif defined(__APPLE__)
+    static const os_log_type_t types[] = {OS_LOG_TYPE_ERROR, OS_LOG_TYPE_DEFAULT, OS_LOG_TYPE_INFO, OS_LOG_TYPE_DEBUG};
+    os_log_with_type(OS_LOG_DEFAULT, types[static_cast<int>(level)], "%{public}s", text);
+#else
+    fprintf(stderr, "[OcrKit %s] %s\n", logLevelName(level), text);
+#endif
+}
+
+void OcrLog::Write(LogLevel level, const char* format, ...) {
+    uint64_t n = g_head.fetch_add(1, std::memory_order_relaxed);
+    LogSlot& slot = g_slots[n % LOG_RING_CAPACITY];
+
+    // Claim the slot. A writer a whole ring behind or ahead still holding it,
+    // or a newer message already there, means this one is dropped: writers
+    // never wait on each other.
+    uint64_t current = slot.seq.load(std::memory_order_relaxed);
+    if ((current & 1) || current > 2 * n ||
+        !slot.seq.compare_exchange_strong(current, 2 * n + 1, std::memory_order_relaxed)) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.level = level;
+    slot.time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    slot.thread = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(slot.text, LOG_MESSAGE_BYTES, format, args);
+    va_end(args);
+
+    // Callers written for printf-style sinks end some messages with a newline
+    size_t end = length < 0 ? 0 : std::min(static_cast<size_t>(length), LOG_MESSAGE_BYTES - 1);
+    while (end > 0 && slot.text[end - 1] == '\n') {
+        end--;
+    }
+    slot.text[end] = '\0';
+
+    if (static_cast<int>(level) <= echo_level_.load(std::memory_order_relaxed)) {
+        echoMessage(level, slot.text);
+    }
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+}
+
+std::vector<LogEntry> OcrLog::Dump(size_t max_entries) {
+    uint64_t head = g_head.load(std::memory_order_acquire);
+    uint64_t first = std::max(g_floor.load(std::memory_order_relaxed),
+                              head > LOG_RING_CAPACITY ? head - LOG_RING_CAPACITY : 0);
+    max_entries = std::min(max_entries, LOG_RING_CAPACITY);
+    if (head - first > max_entries) {
+        first = head - max_entries;
+    }
+
+    std::vector<LogEntry> entries;
+    entries.reserve(head - first);
+    for (uint64_t n = first; n < head; n++) {
+        const LogSlot& slot = g_slots[n % LOG_RING_CAPACITY];
+        uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before != 2 * n + 2) {
+            continue;  // Still being written, or already overwritten
+        }
+
+        LogEntry entry;
+        entry.seq = n;
+        entry.level = slot.level;
+        entry.time_us = slot.time_us;
+        entry.thread = slot.thread;
+        char text[LOG_MESSAGE_BYTES];
+        memcpy(text, slot.text, LOG_MESSAGE_BYTES);
+        text[LOG_MESSAGE_BYTES - 1] = '\0';
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != before) {
+            continue;  // Overwritten while copying
+        }
+        entry.text = text;
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+uint64_t OcrLog::Written() {
+    return g_head.load(std::memory_order_relaxed);
+}
+
+uint64_t OcrLog::Dropped() {
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+void OcrLog::Clear() {
+    g_floor.store(g_head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::kError: return "error";
+        case LogLevel::kWarn: return "warn";
+        case LogLevel::kInfo: return "info";
+        case LogLevel::kDebug: return "debug";
+    }
+    return "debug";
+}
+
+bool logLevelFromName(const std::string& name, LogLevel& level) {
+    for (LogLevel candidate : {LogLevel::kError, LogLevel::kWarn, LogLevel::kInfo, LogLevel::kDebug}) {
+        if (name == logLevelName(candidate)) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,54 @@
+#include "include/ort_env.h"
+#include "include/ocr_log.h"
+#include <mutex>
+
+// Arena settings: grow by exactly what is requested (kSameAsRequested) rather
+// than doubling, which keeps RSS close to the real working set on mobile
+static const int ARENA_EXTEND_SAME_AS_REQUESTED = 1;
+
+static std::mutex g_env_mutex;
+static Ort::Env* g_env = nullptr;
+static int g_env_users = 0;
+static bool g_shared_allocator = false;
+
+Ort::Env& AcquireOrtEnv() {
+    std::lock_guard<std::mutex> lock(g_env_mutex);
+    if (!g_env) {
+        g_env = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "OcrKit");
+
+        try {
+            Ort::ArenaCfg arena_cfg(0, ARENA_EXTEND_SAME_AS_REQUESTED, -1, -1);
+            g_env->CreateAndRegisterAllocator(CpuMemoryInfo(), arena_cfg);
+            g_shared_allocator = true;
+            LOGD("Shared CPU arena registered");
+        } catch (const Ort::Exception& e) {
+            // Sessions fall back to their own arenas
+            g_shared_allocator = false;
+            LOGW("Shared CPU arena unavailable: %s", e.what());
+        }
+    }
+    g_env_users++;
+    return *g_env;
+}
+
+void ReleaseOrtEnv() {
+    std::lock_guard<std::mutex> lock(g_env_mutex);
+    if (g_env_users > 0 && --g_env_users == 0) {
+        delete g_env;
+        g_env = nullptr;
+        g_shared_allocator = false;
+        LOGD("ONNX Runtime environment released");
+    }
+}
+
+void UseSharedAllocator(Ort::SessionOptions& options) {
+    std::lock_guard<std::mutex> lock(g_env_mutex);
+    if (g_shared_allocator) {
+        options.AddConfigEntry("session.use_env_allocators", "1");
+    }
+}
+
+const Ort::MemoryInfo& CpuMemoryInfo() {
+    static const Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    return memory_info;
+}
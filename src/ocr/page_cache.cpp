@@ -0,0 +1,311 @@
+#include "include/page_cache.h"
+#include "include/box_merge.h"
+#include "include/ocr_log.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+// A read is reused for a box whose corners all lie within this fraction of
+// the read box's height of its own (at least 2 px). Moving det_threshold grows
+// or shrinks DB contours by a few pixels without changing what is inside.
+static const float READ_MATCH_TOLERANCE = 0.2f;
+static const float READ_MATCH_MIN_PX = 2.0f;
+// Reads no box matched in this many requests are dropped
+static const uint64_t READ_MAX_IDLE_REQUESTS = 4;
+
+static float boxHeight(const TextBox& box) {
+    float a = static_cast<float>(cv::norm(box.points[1] - box.points[0]));
+    float b = static_cast<float>(cv::norm(box.points[3] - box.points[0]));
+    return std::min(a, b);
+}
+
+static float matchTolerance(const TextBox& read) {
+    return std::max(READ_MATCH_MIN_PX, READ_MATCH_TOLERANCE * boxHeight(read));
+}
+
+static bool sameRegion(const TextBox& read, const TextBox& box) {
+    float tolerance = matchTolerance(read);
+    for (size_t i = 0; i < read.points.size(); i++) {
+        if (std::abs(read.points[i].x - box.points[i].x) > tolerance ||
+            std::abs(read.points[i].y - box.points[i].y) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t PageCache::Page::Bytes() const {
+    size_t total = image.total() * image.elemSize() + map.Bytes() + fixed_boxes.size() * sizeof(TextBox);
+    for (const Read& read : reads) {
+        total += sizeof(Read) + read.text.capacity();
+    }
+    return total;
+}
+
+PageCache& PageCache::GetInstance() {
+    static PageCache instance;
+    return instance;
+}
+
+int PageCache::Open(OcrEngine& engine, const cv::Mat& image, const OcrOptions& options,
+                    const std::string& model_id) {
+    if (image.empty()) {
+        return 0;
+    }
+
+    auto page = std::make_shared<Page>();
+    page->model_id = model_id;
+    page->image = image;
+
+    // Resolve the backend once, the same way DetectText does
+    page->detector = options.detector;
+    if (page->detector == DetectorBackend::kAuto) {
+        page->detector = measureCleanliness(image).clean ? DetectorBackend::kClassic : DetectorBackend::kNeural;
+    }
+    if (page->detector == DetectorBackend::kClassic) {
+        OcrOptions classic = options;
+        classic.detector = DetectorBackend::kClassic;
+        classic.merge_fragments = false;  // Applied per request
+        page->fixed_boxes = engine.DetectText(image, classic);
+    } else if (!engine.DetectMap(image, page->map)) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    int handle = next_handle_++;
+    page->bytes = page->Bytes();
+    page->last_used = ++clock_;
+    bytes_ += page->bytes;
+    pages_[handle] = page;
+    opens_++;
+    LOGD("Page %d opened: %dx%d, %zu KB cached", handle, image.cols, image.rows, page->bytes / 1024);
+    EvictFor(handle);
+    return handle;
+}
+
+std::shared_ptr<PageCache::Page> PageCache::Find(int page) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pages_.find(page);
+    if (it == pages_.end()) {
+        return nullptr;
+    }
+    it->second->last_used = ++clock_;
+    return it->second;
+}
+
+bool PageCache::Recognize(int handle, OcrEngine& engine, const OcrOptions& options, TextLines& lines,
+                          PageOcrStats* stats) {
+    std::shared_ptr<Page> page = Find(handle);
+    if (!page) {
+        return false;
+    }
+    std::lock_guard<std::mutex> page_lock(page->mutex);
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<TextBox> boxes = page->detector == DetectorBackend::kClassic
+                                     ? page->fixed_boxes
+                                     : engine.DetectFromMap(page->map, options.det_threshold, options.det_half_res);
+    if (options.merge_fragments && boxes.size() > 1) {
+        std::vector<MergedBox> merged = mergeCollinearBoxes(boxes);
+        boxes.clear();
+        boxes.reserve(merged.size());
+        for (const MergedBox& line : merged) {
+            boxes.push_back(line.box);
+        }
+    }
+
+    uint64_t request = ++page->requests;
+
+    // Reads by the y of their first corner: a box can only match reads within
+    // the largest tolerance of its own first corner
+    std::vector<size_t> by_y(page->reads.size());
+    std::iota(by_y.begin(), by_y.end(), 0);
+    std::stable_sort(by_y.begin(), by_y.end(), [&](size_t a, size_t b) {
+        return page->reads[a].box.points[0].y < page->reads[b].box.points[0].y;
+    });
+    float max_tolerance = 0.0f;
+    for (const Read& read : page->reads) {
+        max_tolerance = std::max(max_tolerance, matchTolerance(read.box));
+    }
+
+    // Earlier read per box, if any; unread boxes go to the model in one call
+    const size_t kNoRead = static_cast<size_t>(-1);
+    std::vector<size_t> read_index(boxes.size(), kNoRead);
+    std::vector<TextBox> unread;
+    std::vector<size_t> unread_boxes;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        float y = boxes[i].points[0].y;
+        auto it = std::lower_bound(by_y.begin(), by_y.end(), y - max_tolerance, [&](size_t r, float value) {
+            return page->reads[r].box.points[0].y < value;
+        });
+        for (; it != by_y.end() && page->reads[*it].box.points[0].y <= y + max_tolerance; ++it) {
+            if (sameRegion(page->reads[*it].box, boxes[i])) {
+                read_index[i] = *it;
+                page->reads[*it].last_matched = request;
+                break;
+            }
+        }
+        if (read_index[i] == kNoRead) {
+            unread.push_back(boxes[i]);
+            unread_boxes.push_back(i);
+        }
+    }
+
+    size_t failed = 0;
+    if (!unread.empty()) {
+        // Threshold 0 keeps every non-empty read; rec_threshold is applied below
+        std::vector<size_t> line_boxes;
+        bool decoded = false;
+        TextLines fresh = engine.RecognizeBoxes(page->image, unread, 0.0f, &line_boxes, &decoded);
+
+        // A failed pass read nothing: cache no reads, so the next request retries
+        if (decoded) {
+            size_t first = page->reads.size();
+            page->reads.resize(first + unread.size());
+            for (size_t k = 0; k < unread.size(); k++) {
+                page->reads[first + k].box = unread[k];
+                page->reads[first + k].last_matched = request;
+                read_index[unread_boxes[k]] = first + k;
+            }
+            for (size_t l = 0; l < fresh.size(); l++) {
+                Read& read = page->reads[first + line_boxes[l]];
+                read.text = std::string(fresh[l].text);
+                read.score = fresh[l].score;
+            }
+        } else {
+            failed = unread.size();
+            LOGW("Page %d: %zu boxes could not be read", handle, failed);
+        }
+    }
+
+    size_t text_bytes = 0;
+    for (size_t r : read_index) {
+        if (r != kNoRead) {
+            text_bytes += page->reads[r].text.size();
+        }
+    }
+    lines.Clear();
+    lines.Reserve(boxes.size(), text_bytes);
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (read_index[i] == kNoRead) {
+            continue;
+        }
+        const Read& read = page->reads[read_index[i]];
+        if (read.text.empty() || read.score < options.rec_threshold) {
+            continue;
+        }
+        // Axis-aligned extent of this request's box, as RecognizeBoxes reports it
+        const TextBox& box = boxes[i];
+        float min_x = box.points[0].x, max_x = box.points[0].x;
+        float min_y = box.points[0].y, max_y = box.points[0].y;
+        for (const auto& pt : box.points) {
+            min_x = std::min(min_x, pt.x);
+            max_x = std::max(max_x, pt.x);
+            min_y = std::min(min_y, pt.y);
+            max_y = std::max(max_y, pt.y);
+        }
+        lines.Add(min_x, min_y, max_x, max_y, read.score, read.text);
+    }
+
+    if (stats) {
+        stats->boxes = boxes.size();
+        stats->recognized = unread.size();
+        stats->reused = boxes.size() - unread.size();
+        stats->failed = failed;
+    }
+
+    // Forget reads of thresholds the caller has moved away from
+    page->reads.erase(std::remove_if(page->reads.begin(), page->reads.end(), [&](const Read& read) {
+        return request - read.last_matched >= READ_MAX_IDLE_REQUESTS;
+    }), page->reads.end());
+
+    auto end = std::chrono::high_resolution_clock::now();
+    LOGD("Page %d: %zu boxes, %zu reused, %zu recognized, %lld ms", handle, boxes.size(),
+         boxes.size() - unread.size(), unread.size(),
+         (long long)std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+
+    size_t bytes = page->Bytes();
+    std::lock_guard<std::mutex> lock(mutex_);
+    reused_ += boxes.size() - unread.size();
+    recognized_ += unread.size();
+    auto it = pages_.find(handle);
+    if (it != pages_.end() && it->second == page) {
+        bytes_ = bytes_ - page->bytes + bytes;
+        page->bytes = bytes;
+        EvictFor(handle);
+    }
+    return true;
+}
+
+void PageCache::EvictFor(int keep) {
+    if (budget_ == 0) return;
+    while (bytes_ > budget_) {
+        auto victim = pages_.end();
+        for (auto it = pages_.begin(); it != pages_.end(); ++it) {
+            if (it->first == keep) continue;
+            if (victim == pages_.end() || it->second->last_used < victim->second->last_used) {
+                victim = it;
+            }
+        }
+        if (victim == pages_.end()) {
+            LOGW("Page cache budget exceeded by one page (%zu KB)", bytes_ / 1024);
+            return;
+        }
+        LOGI("Evicting page %d (%zu KB)", victim->first, victim->second->bytes / 1024);
+        bytes_ -= victim->second->bytes;
+        pages_.erase(victim);
+        evictions_++;
+    }
+}
+
+bool PageCache::Info(int handle, PageInfo& info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pages_.find(handle);
+    if (it == pages_.end()) {
+        return false;
+    }
+    const Page& page = *it->second;
+    info.model_id = page.model_id;
+    info.detector = page.detector;
+    info.width = page.image.cols;
+    info.height = page.image.rows;
+    info.bytes = page.bytes;
+    return true;
+}
+
+bool PageCache::Close(int handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pages_.find(handle);
+    if (it == pages_.end()) {
+        return false;
+    }
+    bytes_ -= it->second->bytes;
+    pages_.erase(it);
+    return true;
+}
+
+void PageCache::CloseAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pages_.clear();
+    bytes_ = 0;
+}
+
+void PageCache::SetMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = bytes;
+    EvictFor(0);
+}
+
+PageCacheStats PageCache::Stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PageCacheStats stats;
+    stats.pages = pages_.size();
+    stats.bytes = bytes_;
+    stats.budget = budget_;
+    stats.opens = opens_;
+    stats.evictions = evictions_;
+    stats.reused = reused_;
+    stats.recognized = recognized_;
+    return stats;
+}
@@ -0,0 +1,260 @@
+#include "include/pdf_ocr.h"
+#include "include/text_utils.h"
+#include "include/ocr_log.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#ifdef OCR_KIT_WITH_PDFIUM
+#include <fpdfview.h>
+#include <fpdf_text.h>
+#endif
+
+const char* pdfPageSourceName(PdfPageSource source) {
+    return source == PdfPageSource::kOcr ? "ocr" : "text";
+}
+
+#ifdef OCR_KIT_WITH_PDFIUM
+
+static const float PDF_MIN_DPI = 72.0f;
+static const float PDF_MAX_DPI = 300.0f;
+static const float BROKEN_TEXT_RATIO = 0.1f;  // Unmappable glyphs above this share: text layer unusable
+
+// PDFium is not thread-safe: one library instance, one caller at a time
+static std::mutex pdfium_mutex;
+
+static void ensurePdfiumInitialized() {
+    static std::once_flag once;
+    std::call_once(once, [] { FPDF_InitLibrary(); });
+}
+
+// Closes PDFium handles on scope exit
+struct PdfDocumentCloser {
+    FPDF_DOCUMENT doc;
+    ~PdfDocumentCloser() { FPDF_CloseDocument(doc); }
+};
+
+struct PdfPageCloser {
+    FPDF_PAGE page;
+    ~PdfPageCloser() { FPDF_ClosePage(page); }
+};
+
+struct PdfTextPageCloser {
+    FPDF_TEXTPAGE text;
+    ~PdfTextPageCloser() { FPDFText_ClosePage(text); }
+};
+
+// Build lines from the text layer, breaking at PDFium's line ends.
+// Returns false when the layer is missing, too sparse or mostly unmappable glyphs
+// (a scan with a broken OCR layer, or fonts without a ToUnicode map).
+static bool extractTextLayer(FPDF_PAGE page, float page_height, int min_chars,
+                             TextLines& lines) {
+    FPDF_TEXTPAGE text_page = FPDFText_LoadPage(page);
+    if (!text_page) {
+        return false;
+    }
+    PdfTextPageCloser closer{text_page};
+
+    int count = FPDFText_CountChars(text_page);
+    int visible = 0, broken = 0;
+
+    // Current line: box in points and its text, reused across lines
+    float x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+    std::string text;
+    bool has_box = false;
+    char32_t high_surrogate = 0;
+
+    auto end_line = [&]() {
+        // Trim the trailing space PDFium generates before a line break
+        while (!text.empty() && text.back() == ' ') {
+            text.pop_back();
+        }
+        if (has_box && !text.empty()) {
+            lines.Add(x1, y1, x2, y2, 1.0f, text);
+        }
+        text.clear();
+        has_box = false;
+    };
+
+    for (int i = 0; i < count; i++) {
+        char32_t cp = FPDFText_GetUnicode(text_page, i);
+
+        if (cp == '\r' || cp == '\n') {
+            end_line();
+            continue;
+        }
+
+        // Text pages report UTF-16 units; rejoin surrogate pairs
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            high_surrogate = cp;
+            continue;
+        }
+        if (cp >= 0xDC00 && cp <= 0xDFFF) {
+            if (!high_surrogate) {
+                continue;
+            }
+            cp = 0x10000 + ((high_surrogate - 0xD800) << 10) + (cp - 0xDC00);
+        }
+        high_surrogate = 0;
+
+        if (cp == 0 || cp == 0xFFFD) {
+            broken++;
+            continue;
+        }
+        appendUtf8(text, cp);
+
+        if (cp == ' ' || cp == '\t' || FPDFText_IsGenerated(text_page, i) == 1) {
+            continue;
+        }
+        visible++;
+
+        double left, right, bottom, top;
+        if (!FPDFText_GetCharBox(text_page, i, &left, &right, &bottom, &top)) {
+            continue;
+        }
+        float cx1 = static_cast<float>(left);
+        float cx2 = static_cast<float>(right);
+        float cy1 = page_height - static_cast<float>(top);  // PDF y grows upwards
+        float cy2 = page_height - static_cast<float>(bottom);
+        if (!has_box) {
+            x1 = cx1; y1 = cy1; x2 = cx2; y2 = cy2;
+            has_box = true;
+        } else {
+            x1 = std::min(x1, cx1);
+            y1 = std::min(y1, cy1);
+            x2 = std::max(x2, cx2);
+            y2 = std::max(y2, cy2);
+        }
+    }
+    end_line();
+
+    if (visible < min_chars || broken > BROKEN_TEXT_RATIO * (visible + broken)) {
+        LOGD("PDF text layer unusable: %d visible chars, %d unmappable", visible, broken);
+        lines.Clear();
+        return false;
+    }
+    return true;
+}
+
+// Rasterize so the long side is about `long_side` px (det downscales it to its
+// input size; rec crops keep the extra detail). Returns BGR, owned by the caller.
+static cv::Mat renderPage(FPDF_PAGE page, float width_pt, float height_pt, int long_side, float& dpi) {
+    dpi = 72.0f * long_side / std::max(1.0f, std::max(width_pt, height_pt));
+    dpi = std::clamp(dpi, PDF_MIN_DPI, PDF_MAX_DPI);
+    float scale = dpi / 72.0f;
+    int width = std::max(1, static_cast<int>(width_pt * scale + 0.5f));
+    int height = std::max(1, static_cast<int>(height_pt * scale + 0.5f));
+
+    FPDF_BITMAP bitmap = FPDFBitmap_Create(width, height, 0);
+    if (!bitmap) {
+        LOGE("PDF bitmap allocation failed (%dx%d)", width, height);
+        return cv::Mat();
+    }
+    FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
+    FPDF_RenderPageBitmap(bitmap, page, 0, 0, width, height, 0, FPDF_ANNOT);
+
+    // BGRx, so the engine's BGR input is one channel drop away
+    cv::Mat bgrx(height, width, CV_8UC4, FPDFBitmap_GetBuffer(bitmap), FPDFBitmap_GetStride(bitmap));
+    cv::Mat image;
+    cv::cvtColor(bgrx, image, cv::COLOR_BGRA2BGR);
+    FPDFBitmap_Destroy(bitmap);
+    return image;
+}
+
+PdfStatus recognizePdf(OcrEngine& engine, const std::string& pdf_path, const std::string& password,
+                       const PdfOcrOptions& options,
+                       const std::function<void(const PdfPageResult&)>& on_page,
+                       PdfOcrStats* stats) {
+    ensurePdfiumInitialized();
+
+    // Held for PDFium calls only, so concurrent PDF jobs overlap their det/rec
+    std::unique_lock<std::mutex> lock(pdfium_mutex);
+
+    FPDF_DOCUMENT doc = FPDF_LoadDocument(pdf_path.c_str(), password.empty() ? nullptr : password.c_str());
+    if (!doc) {
+        unsigned long error = FPDF_GetLastError();
+        LOGW("PDF load failed: %s (error %lu)", pdf_path.c_str(), error);
+        return error == FPDF_ERR_PASSWORD ? PdfStatus::kPasswordRequired : PdfStatus::kLoadFailed;
+    }
+    PdfDocumentCloser doc_closer{doc};
+
+    int document_pages = FPDF_GetPageCount(doc);
+    int first = std::clamp(options.first_page, 0, document_pages);
+    int last = options.page_count < 0 ? document_pages : std::min(document_pages, first + options.page_count);
+    if (stats) {
+        stats->document_pages = document_pages;
+    }
+
+    for (int index = first; index < last; index++) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        FPDF_PAGE page = FPDF_LoadPage(doc, index);
+        if (!page) {
+            LOGW("PDF page %d failed to load", index);
+            continue;
+        }
+        PdfPageCloser page_closer{page};
+
+        PdfPageResult result;
+        result.page = index;
+        result.width_pt = FPDF_GetPageWidthF(page);
+        result.height_pt = FPDF_GetPageHeightF(page);
+
+        bool from_text = options.use_text_layer &&
+                         extractTextLayer(page, result.height_pt, options.min_text_chars, result.lines);
+        if (from_text) {
+            result.source = PdfPageSource::kTextLayer;
+            if (stats) {
+                stats->pages_text_layer++;
+            }
+        } else {
+            result.source = PdfPageSource::kOcr;
+            cv::Mat image = renderPage(page, result.width_pt, result.height_pt,
+                                       options.render_long_side, result.dpi);
+
+            // Det/rec does not touch PDFium: let other PDF jobs use it meanwhile
+            lock.unlock();
+            if (!image.empty()) {
+                float scale = result.dpi / 72.0f;
+                result.lines = engine.RecognizeText(image, options.ocr);
+                for (TextLineResult& line : result.lines) {
+                    line.x1 /= scale;
+                    line.y1 /= scale;
+                    line.x2 /= scale;
+                    line.y2 /= scale;
+                }
+            }
+            lock.lock();
+            if (stats) {
+                stats->pages_ocr++;
+            }
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        result.time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        LOGD("PDF page %d: %s, %zu lines, %.1f ms", index, pdfPageSourceName(result.source),
+             result.lines.size(), result.time_ms);
+
+        on_page(result);
+    }
+
+    return PdfStatus::kOk;
+}
+
+#else
+
+PdfStatus recognizePdf(OcrEngine& engine, const std::string& pdf_path, const std::string& password,
+                       const PdfOcrOptions& options,
+                       const std::function<void(const PdfPageResult&)>& on_page,
+                       PdfOcrStats* stats) {
+    (void)engine;
+    (void)pdf_path;
+    (void)password;
+    (void)options;
+    (void)on_page;
+    (void)stats;
+    LOGW("PDF input requested but the library was built without PDFium");
+    return PdfStatus::kUnsupported;
+}
+
+#endif // OCR_KIT_WITH_PDFIUM
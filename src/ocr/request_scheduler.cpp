@@ -0,0 +1,125 @@
+#include "include/request_scheduler.h"
+#include "include/ocr_log.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+static thread_local RequestPriority current_priority = RequestPriority::kInteractive;
+static thread_local std::vector<const void*> held_sessions;
+
+RequestPriority requestPriorityFromName(const std::string& name) {
+    if (name == "background") {
+        return RequestPriority::kBackground;
+    }
+    return RequestPriority::kInteractive;
+}
+
+const char* requestPriorityName(RequestPriority priority) {
+    return priority == RequestPriority::kBackground ? "background" : "interactive";
+}
+
+RequestScheduler& RequestScheduler::GetInstance() {
+    static RequestScheduler instance;
+    return instance;
+}
+
+void RequestScheduler::Acquire(const void* session, RequestPriority priority) {
+    PriorityClassStats& stats = stats_[static_cast<int>(priority)];
+    const int interactive = static_cast<int>(RequestPriority::kInteractive);
+
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Node-based map: the reference survives other sessions' inserts and erases
+    Slot& slot = slots_[session];
+    slot.waiting[static_cast<int>(priority)]++;
+    stats.waiting++;
+    stats.peak_waiting = std::max(stats.peak_waiting, stats.waiting);
+
+    changed_.wait(lock, [&] {
+        return !slot.busy && (priority == RequestPriority::kInteractive || slot.waiting[interactive] == 0);
+    });
+
+    slot.waiting[static_cast<int>(priority)]--;
+    stats.waiting--;
+    slot.busy = true;
+
+    uint64_t wait_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    stats.stages++;
+    stats.total_wait_us += wait_us;
+    stats.max_wait_us = std::max(stats.max_wait_us, wait_us);
+}
+
+void RequestScheduler::Release(const void* session) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = slots_.find(session);
+        it->second.busy = false;
+        if (std::all_of(std::begin(it->second.waiting), std::end(it->second.waiting),
+                        [](int n) { return n == 0; })) {
+            slots_.erase(it);
+        }
+    }
+    changed_.notify_all();
+}
+
+void RequestScheduler::BeginRequest(RequestPriority priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PriorityClassStats& stats = stats_[static_cast<int>(priority)];
+    stats.in_flight++;
+    stats.requests++;
+}
+
+void RequestScheduler::EndRequest(RequestPriority priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_[static_cast<int>(priority)].in_flight--;
+}
+
+PriorityClassStats RequestScheduler::Stats(RequestPriority priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_[static_cast<int>(priority)];
+}
+
+void RequestScheduler::ResetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (PriorityClassStats& stats : stats_) {
+        // Live gauges stay, counters restart
+        PriorityClassStats reset;
+        reset.in_flight = stats.in_flight;
+        reset.waiting = stats.waiting;
+        reset.peak_waiting = stats.waiting;
+        stats = reset;
+    }
+}
+
+RequestScheduler::Stage::Stage(const void* session) : session_(session) {
+    if (std::find(held_sessions.begin(), held_sessions.end(), session) != held_sessions.end()) {
+        return;
+    }
+    RequestScheduler::GetInstance().Acquire(session, current_priority);
+    held_sessions.push_back(session);
+    owner_ = true;
+}
+
+RequestScheduler::Stage::~Stage() {
+    if (owner_) {
+        held_sessions.erase(std::find(held_sessions.begin(), held_sessions.end(), session_));
+        RequestScheduler::GetInstance().Release(session_);
+    }
+}
+
+RequestScope::RequestScope(RequestPriority priority)
+    : priority_(priority), previous_(current_priority) {
+    current_priority = priority;
+    RequestScheduler::GetInstance().BeginRequest(priority);
+    LOGD("Request started (%s)", requestPriorityName(priority));
+}
+
+RequestScope::~RequestScope() {
+    RequestScheduler::GetInstance().EndRequest(priority_);
+    current_priority = previous_;
+}
+
+RequestPriority RequestScope::Current() {
+    return current_priority;
+}
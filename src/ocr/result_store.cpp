@@ -0,0 +1,160 @@
+#include "include/result_store.h"
+#include "include/ocr_log.h"
+#include <cstring>
+
+static const size_t AUTO_FLUSH_BYTES = 4 << 20;  // Bound memory held by unflushed pages
+
+uint64_t ResultChunkHeader::BodyBytes() const {
+    return static_cast<uint64_t>(num_pages) * sizeof(ResultPageRecord) +
+           static_cast<uint64_t>(num_lines) * sizeof(ResultLineRecord) +
+           text_bytes;
+}
+
+// Shared instances, one per store path
+static SharedFileInstances<ResultStore> g_stores;
+
+std::shared_ptr<ResultStore> ResultStore::Get(const std::string& path) {
+    return g_stores.Get(path, [](const std::string& p) { return new ResultStore(p); });
+}
+
+void ResultStore::Close(const std::string& path) {
+    g_stores.Close(path);
+}
+
+ResultStore::ResultStore(const std::string& path) {
+    file_.Load(path, "Result store");
+    IndexChunks();
+}
+
+ResultStore::~ResultStore() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushLocked();
+}
+
+void ResultStore::IndexChunks() {
+    chunk_first_page_.clear();
+    page_count_ = 0;
+    line_count_ = 0;
+    for (const auto* header : file_.segments()) {
+        chunk_first_page_.push_back(page_count_);
+        page_count_ += header->num_pages;
+        line_count_ += header->num_lines;
+    }
+}
+
+uint32_t ResultStore::AppendPage(std::string_view source, int image_width, int image_height,
+                                 const TextLines& lines) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    ResultPageRecord page;
+    page.first_line = static_cast<uint32_t>(pending_lines_.size());
+    page.num_lines = static_cast<uint32_t>(lines.size());
+    page.image_width = static_cast<uint32_t>(std::max(0, image_width));
+    page.image_height = static_cast<uint32_t>(std::max(0, image_height));
+    page.source_offset = static_cast<uint32_t>(pending_text_.size());
+    page.source_length = static_cast<uint32_t>(source.size());
+    pending_text_.append(source.data(), source.size());
+    pending_pages_.push_back(page);
+
+    for (const auto& line : lines) {
+        ResultLineRecord record;
+        record.x1 = line.x1;
+        record.y1 = line.y1;
+        record.x2 = line.x2;
+        record.y2 = line.y2;
+        record.score = line.score;
+        record.text_offset = static_cast<uint32_t>(pending_text_.size());
+        record.text_length = static_cast<uint32_t>(line.text.size());
+        pending_text_ += line.text;
+        pending_lines_.push_back(record);
+    }
+
+    uint32_t page_number = static_cast<uint32_t>(page_count_ + pending_pages_.size() - 1);
+
+    size_t pending_bytes = pending_pages_.size() * sizeof(ResultPageRecord) +
+                           pending_lines_.size() * sizeof(ResultLineRecord) +
+                           pending_text_.size();
+    if (pending_bytes >= AUTO_FLUSH_BYTES) {
+        FlushLocked();
+    }
+    return page_number;
+}
+
+bool ResultStore::Flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return FlushLocked();
+}
+
+bool ResultStore::FlushLocked() {
+    if (pending_pages_.empty()) {
+        return true;
+    }
+
+    size_t pages_bytes = pending_pages_.size() * sizeof(ResultPageRecord);
+    size_t lines_bytes = pending_lines_.size() * sizeof(ResultLineRecord);
+    size_t unpadded = sizeof(ResultChunkHeader) + pages_bytes + lines_bytes + pending_text_.size();
+    std::vector<uint8_t> chunk = SegmentFile<ResultChunkHeader>::NewSegment(unpadded);
+
+    auto* header = reinterpret_cast<ResultChunkHeader*>(chunk.data());
+    header->num_pages = static_cast<uint32_t>(pending_pages_.size());
+    header->num_lines = static_cast<uint32_t>(pending_lines_.size());
+    header->text_bytes = static_cast<uint32_t>(pending_text_.size());
+
+    uint8_t* cursor = chunk.data() + sizeof(ResultChunkHeader);
+    memcpy(cursor, pending_pages_.data(), pages_bytes);
+    cursor += pages_bytes;
+    memcpy(cursor, pending_lines_.data(), lines_bytes);
+    cursor += lines_bytes;
+    memcpy(cursor, pending_text_.data(), pending_text_.size());
+
+    SegmentFile<ResultChunkHeader>::Seal(chunk);
+    bool ok = file_.Append(chunk);
+    IndexChunks();
+    if (ok) {
+        pending_pages_.clear();
+        pending_lines_.clear();
+        pending_text_.clear();
+    }
+    LOGD("Result store flush: %s, %zu pages total", ok ? "ok" : "failed", page_count_);
+    return ok;
+}
+
+ResultPageView ResultStore::PageAt(size_t page) const {
+    // Last chunk starting at or before `page`
+    size_t c = std::upper_bound(chunk_first_page_.begin(), chunk_first_page_.end(), page) -
+               chunk_first_page_.begin() - 1;
+    const ResultChunkHeader* header = file_.segments()[c];
+    const auto* pages = reinterpret_cast<const ResultPageRecord*>(header + 1);
+    const auto* lines = reinterpret_cast<const ResultLineRecord*>(pages + header->num_pages);
+
+    ResultPageView view;
+    view.record = &pages[page - chunk_first_page_[c]];
+    view.lines = lines + view.record->first_line;
+    view.text = reinterpret_cast<const char*>(lines + header->num_lines);
+    return view;
+}
+
+size_t ResultStore::PageCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return page_count_;
+}
+
+size_t ResultStore::LineCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return line_count_;
+}
+
+size_t ResultStore::ChunkCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.segments().size();
+}
+
+size_t ResultStore::PendingCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_pages_.size();
+}
+
+uint64_t ResultStore::FileSize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.size();
+}
@@ -0,0 +1,397 @@
+#include "include/search_index.h"
+#include "include/text_utils.h"
+#include "include/ocr_log.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+static const size_t AUTO_COMMIT_LINES = 50000;  // Bound memory held by uncommitted pages
+static const size_t MAX_SEGMENTS = 8;           // Commits past this merge segments, so queries stay bounded
+
+static uint64_t termHash(const std::string& term) {
+    return fnv1a64(term.data(), term.size());
+}
+
+uint64_t IndexSegmentHeader::BodyBytes() const {
+    return static_cast<uint64_t>(num_terms) * sizeof(IndexTermEntry) +
+           static_cast<uint64_t>(num_postings) * sizeof(uint32_t) +
+           static_cast<uint64_t>(num_lines) * sizeof(IndexLineRecord) +
+           text_bytes;
+}
+
+// Shared instances, one per index path
+static SharedFileInstances<SearchIndex> g_indices;
+
+std::shared_ptr<SearchIndex> SearchIndex::Get(const std::string& path) {
+    return g_indices.Get(path, [](const std::string& p) { return new SearchIndex(p); });
+}
+
+void SearchIndex::Close(const std::string& path) {
+    g_indices.Close(path);
+}
+
+SearchIndex::SearchIndex(const std::string& path) {
+    file_.Load(path, "Search index");
+    CountLines();
+}
+
+const IndexTermEntry* SearchIndex::SegmentTerms(const IndexSegmentHeader* header) {
+    return reinterpret_cast<const IndexTermEntry*>(header + 1);
+}
+
+const uint32_t* SearchIndex::SegmentPostings(const IndexSegmentHeader* header) {
+    return reinterpret_cast<const uint32_t*>(SegmentTerms(header) + header->num_terms);
+}
+
+const IndexLineRecord* SearchIndex::SegmentLines(const IndexSegmentHeader* header) {
+    return reinterpret_cast<const IndexLineRecord*>(SegmentPostings(header) + header->num_postings);
+}
+
+const char* SearchIndex::SegmentText(const IndexSegmentHeader* header) {
+    return reinterpret_cast<const char*>(SegmentLines(header) + header->num_lines);
+}
+
+void SearchIndex::CountLines() {
+    line_count_ = 0;
+    for (const auto* header : file_.segments()) {
+        line_count_ += header->num_lines;
+    }
+    LOGD("Search index: %zu segments, %zu lines", file_.segments().size(), line_count_);
+}
+
+void SearchIndex::AddPage(uint32_t doc_id, uint32_t page, const TextLines& lines) {
+    bool flush = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < lines.size(); i++) {
+            const auto& line = lines[i];
+            PendingLine pending;
+            pending.record = {doc_id, page, static_cast<uint32_t>(i),
+                              line.x1, line.y1, line.x2, line.y2, line.score, 0, 0};
+            pending.text.assign(line.text.data(), line.text.size());
+            pending_.push_back(std::move(pending));
+        }
+        flush = pending_.size() >= AUTO_COMMIT_LINES;
+    }
+
+    if (flush) {
+        Commit();
+    }
+}
+
+std::vector<uint8_t> SearchIndex::BuildSegment(const std::vector<PendingLine>& lines) {
+    // Collect postings per term hash (line indices arrive in ascending order)
+    std::unordered_map<uint64_t, std::vector<uint32_t>> postings_by_term;
+    size_t text_bytes = 0;
+    for (size_t i = 0; i < lines.size(); i++) {
+        for (const auto& term : indexTerms(lines[i].text)) {
+            auto& list = postings_by_term[termHash(term)];
+            if (list.empty() || list.back() != i) {
+                list.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        text_bytes += lines[i].text.size();
+    }
+
+    std::vector<uint64_t> hashes;
+    hashes.reserve(postings_by_term.size());
+    size_t num_postings = 0;
+    for (const auto& entry : postings_by_term) {
+        hashes.push_back(entry.first);
+        num_postings += entry.second.size();
+    }
+    std::sort(hashes.begin(), hashes.end());
+
+    size_t unpadded = sizeof(IndexSegmentHeader) +
+                      hashes.size() * sizeof(IndexTermEntry) +
+                      num_postings * sizeof(uint32_t) +
+                      lines.size() * sizeof(IndexLineRecord) +
+                      text_bytes;
+    std::vector<uint8_t> buffer = SegmentFile<IndexSegmentHeader>::NewSegment(unpadded);
+
+    auto* header = reinterpret_cast<IndexSegmentHeader*>(buffer.data());
+    header->num_terms = static_cast<uint32_t>(hashes.size());
+    header->num_postings = static_cast<uint32_t>(num_postings);
+    header->num_lines = static_cast<uint32_t>(lines.size());
+    header->text_bytes = static_cast<uint32_t>(text_bytes);
+
+    auto* terms = reinterpret_cast<IndexTermEntry*>(header + 1);
+    auto* postings = reinterpret_cast<uint32_t*>(terms + hashes.size());
+    uint32_t posting_offset = 0;
+    for (size_t t = 0; t < hashes.size(); t++) {
+        const auto& list = postings_by_term[hashes[t]];
+        terms[t] = {hashes[t], posting_offset, static_cast<uint32_t>(list.size())};
+        std::memcpy(postings + posting_offset, list.data(), list.size() * sizeof(uint32_t));
+        posting_offset += static_cast<uint32_t>(list.size());
+    }
+
+    auto* records = reinterpret_cast<IndexLineRecord*>(postings + num_postings);
+    char* text = reinterpret_cast<char*>(records + lines.size());
+    uint32_t text_offset = 0;
+    for (size_t i = 0; i < lines.size(); i++) {
+        records[i] = lines[i].record;
+        records[i].text_offset = text_offset;
+        records[i].text_length = static_cast<uint32_t>(lines[i].text.size());
+        std::memcpy(text + text_offset, lines[i].text.data(), lines[i].text.size());
+        text_offset += static_cast<uint32_t>(lines[i].text.size());
+    }
+
+    SegmentFile<IndexSegmentHeader>::Seal(buffer);
+    return buffer;
+}
+
+bool SearchIndex::Commit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.empty()) {
+        return true;
+    }
+
+    std::vector<uint8_t> segment = BuildSegment(pending_);
+
+    bool ok = file_.Append(segment);
+    CountLines();
+    if (ok) {
+        pending_.clear();
+    }
+    LOGD("Search index commit: %s, %zu lines total", ok ? "ok" : "failed", line_count_);
+
+    if (ok && file_.segments().size() > MAX_SEGMENTS) {
+        MergeSegmentsLocked();
+    }
+    return ok;
+}
+
+std::vector<SearchIndex::PendingLine> SearchIndex::SegmentRange(size_t first, size_t last) const {
+    size_t count = 0;
+    for (size_t s = first; s < last; s++) {
+        count += file_.segments()[s]->num_lines;
+    }
+    std::vector<PendingLine> lines;
+    lines.reserve(count);
+    for (size_t s = first; s < last; s++) {
+        const IndexLineRecord* records = SegmentLines(file_.segments()[s]);
+        const char* text = SegmentText(file_.segments()[s]);
+        for (uint32_t i = 0; i < file_.segments()[s]->num_lines; i++) {
+            lines.push_back({records[i], std::string(text + records[i].text_offset, records[i].text_length)});
+        }
+    }
+    return lines;
+}
+
+void SearchIndex::MergeSegmentsLocked() {
+    // Size-tiered: the newest segment absorbs older ones no larger than what
+    // it has gathered so far, so a line's segment at least doubles each time
+    // the line is re-indexed. When the newest is smaller than its neighbour,
+    // the adjacent pair with the fewest lines is merged instead.
+    size_t last = file_.segments().size();
+    size_t first = last - 1;
+    size_t merged_lines = file_.segments()[first]->num_lines;
+    while (first > 0 && file_.segments()[first - 1]->num_lines <= merged_lines) {
+        first--;
+        merged_lines += file_.segments()[first]->num_lines;
+    }
+    if (last - first < 2) {
+        size_t best = 0;
+        for (size_t s = 1; s + 1 < file_.segments().size(); s++) {
+            if (file_.segments()[s]->num_lines + file_.segments()[s + 1]->num_lines <
+                file_.segments()[best]->num_lines + file_.segments()[best + 1]->num_lines) {
+                best = s;
+            }
+        }
+        first = best;
+        last = best + 2;
+    }
+
+    // Segments outside the merged range are carried over byte for byte
+    std::vector<uint8_t> merged = BuildSegment(SegmentRange(first, last));
+    const uint8_t* base = file_.data();
+    size_t head = reinterpret_cast<const uint8_t*>(file_.segments()[first]) - base;
+    size_t tail = last < file_.segments().size() ? reinterpret_cast<const uint8_t*>(file_.segments()[last]) - base : file_.size();
+    std::vector<uint8_t> file;
+    file.reserve(head + merged.size() + (file_.size() - tail));
+    file.insert(file.end(), base, base + head);
+    file.insert(file.end(), merged.begin(), merged.end());
+    file.insert(file.end(), base + tail, base + file_.size());
+
+    size_t before = file_.segments().size();
+    bool ok = file_.Replace(file);
+    CountLines();
+    LOGD("Search index merge: %s, %zu -> %zu segments", ok ? "ok" : "failed", before, file_.segments().size());
+}
+
+bool SearchIndex::Compact() {
+    if (!Commit()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_.segments().size() <= 1) {
+        return true;
+    }
+
+    std::vector<uint8_t> segment = BuildSegment(SegmentRange(0, file_.segments().size()));
+
+    bool ok = file_.Replace(segment);
+    CountLines();
+    LOGD("Search index compact: %s, %zu lines", ok ? "ok" : "failed", line_count_);
+    return ok;
+}
+
+std::vector<SearchHit> SearchIndex::Search(const std::string& query, size_t max_hits, float min_coverage) {
+    std::vector<SearchHit> hits;
+
+    std::vector<std::string> terms = queryTerms(query);
+    if (terms.empty() || max_hits == 0) {
+        return hits;
+    }
+
+    std::vector<uint64_t> hashes;
+    hashes.reserve(terms.size());
+    for (const auto& term : terms) {
+        hashes.push_back(termHash(term));
+    }
+
+    size_t num_terms = hashes.size();
+    size_t required = static_cast<size_t>(std::ceil(std::max(0.0f, std::min(min_coverage, 1.0f)) * num_terms));
+    required = std::max<size_t>(required, 1);
+
+    struct Candidate {
+        const IndexSegmentHeader* segment;
+        uint32_t line;
+        float rank;
+    };
+    std::vector<Candidate> candidates;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto* header : file_.segments()) {
+        const IndexTermEntry* entries = SegmentTerms(header);
+        const IndexTermEntry* entries_end = entries + header->num_terms;
+        const uint32_t* postings = SegmentPostings(header);
+        const IndexLineRecord* records = SegmentLines(header);
+
+        // Posting lists for the query terms present in this segment
+        std::vector<std::pair<const uint32_t*, const uint32_t*>> lists;
+        for (uint64_t hash : hashes) {
+            const IndexTermEntry* entry = std::lower_bound(entries, entries_end, hash,
+                [](const IndexTermEntry& e, uint64_t h) { return e.hash < h; });
+            if (entry != entries_end && entry->hash == hash) {
+                lists.push_back({postings + entry->offset, postings + entry->offset + entry->count});
+            }
+        }
+        if (lists.size() < required) {
+            continue;
+        }
+
+        auto rankLine = [&](uint32_t line, size_t matched) {
+            float coverage = static_cast<float>(matched) / num_terms;
+            float length_ratio = std::min(1.0f, static_cast<float>(query.size()) /
+                                                std::max<uint32_t>(1, records[line].text_length));
+            candidates.push_back({header, line, coverage + 0.1f * length_ratio});
+        };
+
+        if (required == num_terms) {
+            // All terms required: walk the rarest list and probe the others
+            std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) {
+                return (a.second - a.first) < (b.second - b.first);
+            });
+            for (const uint32_t* p = lists[0].first; p != lists[0].second; ++p) {
+                bool all = true;
+                for (size_t k = 1; k < lists.size() && all; k++) {
+                    all = std::binary_search(lists[k].first, lists[k].second, *p);
+                }
+                if (all) {
+                    rankLine(*p, num_terms);
+                }
+            }
+        } else {
+            std::unordered_map<uint32_t, uint32_t> counts;
+            for (const auto& list : lists) {
+                for (const uint32_t* p = list.first; p != list.second; ++p) {
+                    counts[*p]++;
+                }
+            }
+            for (const auto& entry : counts) {
+                if (entry.second >= required) {
+                    rankLine(entry.first, entry.second);
+                }
+            }
+        }
+    }
+
+    size_t keep = std::min(max_hits, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(),
+        [](const Candidate& a, const Candidate& b) {
+            if (a.rank != b.rank) return a.rank > b.rank;
+            return SegmentLines(a.segment)[a.line].score > SegmentLines(b.segment)[b.line].score;
+        });
+
+    hits.reserve(keep);
+    for (size_t i = 0; i < keep; i++) {
+        const IndexLineRecord& r = SegmentLines(candidates[i].segment)[candidates[i].line];
+        const char* text = SegmentText(candidates[i].segment);
+        hits.push_back({r.doc_id, r.page, r.box_id, r.x1, r.y1, r.x2, r.y2, r.score,
+                        candidates[i].rank, std::string(text + r.text_offset, r.text_length)});
+    }
+
+    return hits;
+}
+
+size_t SearchIndex::LineCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return line_count_;
+}
+
+size_t SearchIndex::SegmentCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.segments().size();
+}
+
+size_t SearchIndex::PendingCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+std::string searchHitsToJson(const std::vector<SearchHit>& hits) {
+    std::ostringstream json;
+    json << "{\"hits\":[";
+
+    for (size_t i = 0; i < hits.size(); i++) {
+        const auto& h = hits[i];
+        json << "{";
+        json << "\"doc_id\":" << h.doc_id << ",";
+        json << "\"page\":" << h.page << ",";
+        json << "\"box_id\":" << h.box_id << ",";
+        json << "\"x1\":" << std::fixed << std::setprecision(2) << h.x1 << ",";
+        json << "\"y1\":" << h.y1 << ",";
+        json << "\"x2\":" << h.x2 << ",";
+        json << "\"y2\":" << h.y2 << ",";
+        json << "\"score\":" << std::setprecision(4) << h.score << ",";
+        json << "\"rank\":" << h.rank << ",";
+        json << "\"text\":\"";
+
+        // Escape special characters in text
+        for (char c : h.text) {
+            switch (c) {
+                case '"': json << "\\\""; break;
+                case '\\': json << "\\\\"; break;
+                case '\n': json << "\\n"; break;
+                case '\r': json << "\\r"; break;
+                case '\t': json << "\\t"; break;
+                default: json << c;
+            }
+        }
+        json << "\"}";
+
+        if (i < hits.size() - 1) {
+            json << ",";
+        }
+    }
+
+    json << "],\"count\":" << hits.size() << "}";
+    return json.str();
+}
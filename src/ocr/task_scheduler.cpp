@@ -0,0 +1,272 @@
+#include "include/task_scheduler.h"
+#include "include/thread_config.h"
+#include "include/ocr_log.h"
+#include <opencv2/core.hpp>
+#include <algorithm>
+
+// Index of the calling thread in the pool, -1 outside it
+static thread_local int t_worker_index = -1;
+
+static int resolvedThreads(const TaskSchedulerConfig& config) {
+    if (config.threads > 0) {
+        return config.threads;
+    }
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    return std::clamp(hardware - 1, 1, 4);
+}
+
+TaskScheduler& TaskScheduler::GetInstance() {
+    static TaskScheduler instance;
+    return instance;
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+bool TaskScheduler::Configure(const TaskSchedulerConfig& config) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    if (started_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    config_ = config;
+    return true;
+}
+
+TaskSchedulerConfig TaskScheduler::Config() {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return config_;
+}
+
+int TaskScheduler::WorkerCount() {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return started_.load(std::memory_order_acquire) ? static_cast<int>(workers_.size())
+                                                     : resolvedThreads(config_);
+}
+
+void TaskScheduler::EnsureStarted() {
+    if (started_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    if (started_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    int count = resolvedThreads(config_);
+    // Tasks are the unit of parallelism; see the note in task_scheduler.h
+    cv::setNumThreads(1);
+    // Every deque exists before any worker looks for work to steal
+    for (int i = 0; i < count; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < count; i++) {
+        workers_[i]->thread = std::thread([this, i] { WorkerLoop(i); });
+    }
+    started_.store(true, std::memory_order_release);
+}
+
+void TaskScheduler::Execute(std::function<void()> task) {
+    EnsureStarted();
+    int self = t_worker_index;
+    if (self >= 0) {
+        std::lock_guard<std::mutex> lock(workers_[self]->mutex);
+        workers_[self]->tasks.push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        injected_.push_back(std::move(task));
+    }
+    pending_.fetch_add(1);
+    {
+        // Pairs with the predicate check in WorkerLoop, so no wakeup is lost
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    wake_.notify_one();
+}
+
+bool TaskScheduler::TakeTask(int self, std::function<void()>& task, bool& stolen) {
+    stolen = false;
+    if (self >= 0) {
+        // Newest first: its data is most likely still in this core's cache
+        Worker& own = *workers_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        if (!injected_.empty()) {
+            task = std::move(injected_.front());
+            injected_.pop_front();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+    // Oldest first from the others, starting past ourselves to spread thieves out
+    int count = static_cast<int>(workers_.size());
+    for (int k = 1; k <= count; k++) {
+        int victim = (std::max(self, 0) + k) % count;
+        if (victim == self) {
+            continue;
+        }
+        Worker& other = *workers_[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            pending_.fetch_sub(1);
+            stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::WorkerLoop(int index) {
+    t_worker_index = index;
+    ScopedThreadAffinity pin(Config().cpus);
+
+    for (;;) {
+        std::function<void()> task;
+        bool stolen = false;
+        if (TakeTask(index, task, stolen)) {
+            RunTask(task);
+            executed_.fetch_add(1, std::memory_order_relaxed);
+            if (stolen) {
+                stolen_.fetch_add(1, std::memory_order_relaxed);
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+        if (stopping_ && pending_.load() <= 0) {
+            return;  // Stopping and drained
+        }
+    }
+}
+
+void TaskScheduler::RunTask(std::function<void()>& task) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        LOGE("Scheduler task threw: %s", e.what());
+    } catch (...) {
+        LOGE("Scheduler task threw an unknown exception");
+    }
+}
+
+TaskSchedulerStats TaskScheduler::Stats() {
+    TaskSchedulerStats stats;
+    stats.threads = WorkerCount();
+    stats.running = started_.load(std::memory_order_acquire);
+    stats.executed = executed_.load(std::memory_order_relaxed);
+    stats.stolen = stolen_.load(std::memory_order_relaxed);
+    stats.helped = helped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler)
+    : scheduler_(scheduler), state_(std::make_shared<State>()) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        Wait();
+    } catch (...) {
+    }
+}
+
+bool TaskGroup::RunQueued(State& state) {
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.queue.empty()) {
+            return false;
+        }
+        task = std::move(state.queue.front());
+        state.queue.pop_front();
+    }
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.error) {
+            state.error = std::current_exception();
+        }
+    }
+    if (state.pending.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.changed.notify_all();
+    }
+    return true;
+}
+
+void TaskGroup::Run(std::function<void()> task) {
+    state_->pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->queue.push_back(std::move(task));
+        state_->changed.notify_all();
+    }
+    // One ticket per task. Tickets hold the state, not the group, and find
+    // the queue empty when Wait() already ran their task
+    std::shared_ptr<State> state = state_;
+    scheduler_.Execute([state]() { RunQueued(*state); });
+}
+
+void TaskGroup::Wait() {
+    while (state_->pending.load() > 0) {
+        if (RunQueued(*state_)) {
+            if (t_worker_index < 0) {
+                scheduler_.helped_.fetch_add(1, std::memory_order_relaxed);
+            }
+            continue;
+        }
+        // Everything of ours is running elsewhere; sleep until it finishes
+        // or one of those tasks queues more work on this group
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->changed.wait(lock, [this] { return state_->pending.load() == 0 || !state_->queue.empty(); });
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        std::swap(error, state_->error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    size_t chunks = (count + grain - 1) / grain;
+    chunks = std::min(chunks, static_cast<size_t>(TaskScheduler::GetInstance().WorkerCount()) + 1);
+    if (chunks <= 1) {
+        fn(0, count);
+        return;
+    }
+
+    size_t step = (count + chunks - 1) / chunks;
+    TaskGroup group;
+    for (size_t begin = step; begin < count; begin += step) {
+        size_t end = std::min(count, begin + step);
+        group.Run([&fn, begin, end] { fn(begin, end); });
+    }
+    fn(0, step);
+    group.Wait();
+}
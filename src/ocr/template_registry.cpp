@@ -0,0 +1,311 @@
+#include "include/template_registry.h"
+#include "include/ocr_log.h"
+#include <opencv2/calib3d.hpp>
+#include <opencv2/features2d.hpp>
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+
+static const int SIGNATURE_EDGE_INPUT = 64;     // Gradients are taken at 64x64, then pooled to the grid
+static const int SIGNATURE_REGION_INPUT = 128;  // Ink is thresholded at 128x128
+static const int ANCHOR_MAX_SIDE = 1024;        // ORB runs on pages scaled down to this
+static const int ANCHOR_TEMPLATE_FEATURES = 500;
+static const int ANCHOR_PAGE_FEATURES = 1500;   // Filled-in pages carry extra features
+static const size_t ANCHOR_MIN_COUNT = 30;      // References with fewer anchors are rejected
+static const float ANCHOR_RATIO_TEST = 0.75f;   // Lowe's ratio for descriptor matches
+static const double ANCHOR_REPROJ_ERROR = 3.0;  // RANSAC tolerance, in anchor-scale pixels
+static const double ALIGN_MIN_AREA = 0.05;      // Aligned reference must cover this much of the page
+
+static cv::Mat toGray(const cv::Mat& image) {
+    if (image.channels() == 1) {
+        return image;
+    }
+    cv::Mat gray;
+    cv::cvtColor(image, gray, image.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    return gray;
+}
+
+TemplateSignature computeTemplateSignature(const cv::Mat& image) {
+    TemplateSignature signature;
+    if (image.empty()) {
+        return signature;
+    }
+    cv::Mat gray = toGray(image);
+    signature.aspect = static_cast<float>(gray.cols) / gray.rows;
+
+    // Edge fingerprint: where the page's structure (rules, boxes, logos) is
+    cv::Mat small, dx, dy, magnitude, pooled;
+    cv::resize(gray, small, cv::Size(SIGNATURE_EDGE_INPUT, SIGNATURE_EDGE_INPUT), 0, 0, cv::INTER_AREA);
+    cv::Sobel(small, dx, CV_32F, 1, 0);
+    cv::Sobel(small, dy, CV_32F, 0, 1);
+    cv::magnitude(dx, dy, magnitude);
+    cv::resize(magnitude, pooled, cv::Size(TEMPLATE_EDGE_GRID, TEMPLATE_EDGE_GRID), 0, 0, cv::INTER_AREA);
+
+    std::vector<float> values(pooled.begin<float>(), pooled.end<float>());
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    float median = values[values.size() / 2];
+    const float* cells = pooled.ptr<float>();
+    for (size_t i = 0; i < values.size(); i++) {
+        if (cells[i] > median) {
+            signature.edges[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+
+    // Region histogram: how the ink is spread over the page
+    cv::Mat mid, ink;
+    cv::resize(gray, mid, cv::Size(SIGNATURE_REGION_INPUT, SIGNATURE_REGION_INPUT), 0, 0, cv::INTER_AREA);
+    cv::threshold(mid, ink, 0, 255, cv::THRESH_BINARY_INV | cv::THRESH_OTSU);
+    const int cell = SIGNATURE_REGION_INPUT / TEMPLATE_REGION_GRID;
+    float total = 0.0f;
+    for (int gy = 0; gy < TEMPLATE_REGION_GRID; gy++) {
+        for (int gx = 0; gx < TEMPLATE_REGION_GRID; gx++) {
+            float count = static_cast<float>(cv::countNonZero(ink(cv::Rect(gx * cell, gy * cell, cell, cell))));
+            signature.regions[gy * TEMPLATE_REGION_GRID + gx] = count;
+            total += count;
+        }
+    }
+    if (total > 0.0f) {
+        for (float& share : signature.regions) {
+            share /= total;
+        }
+    }
+    return signature;
+}
+
+float templateEdgeDistance(const TemplateSignature& a, const TemplateSignature& b) {
+    size_t differing = 0;
+    for (size_t w = 0; w < TEMPLATE_EDGE_WORDS; w++) {
+        differing += std::bitset<64>(a.edges[w] ^ b.edges[w]).count();
+    }
+    return static_cast<float>(differing) / (TEMPLATE_EDGE_WORDS * 64);
+}
+
+float templateRegionDistance(const TemplateSignature& a, const TemplateSignature& b) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < TEMPLATE_REGION_CELLS; i++) {
+        sum += std::abs(a.regions[i] - b.regions[i]);
+    }
+    return sum / 2.0f;
+}
+
+// ORB keypoints and descriptors, found at anchor scale and reported in image pixels
+static void findAnchors(const cv::Mat& image, int features, std::vector<cv::Point2f>& points,
+                        cv::Mat& descriptors, double& scale) {
+    cv::Mat gray = toGray(image);
+    scale = std::min(1.0, static_cast<double>(ANCHOR_MAX_SIDE) / std::max(gray.cols, gray.rows));
+    cv::Mat scaled = gray;
+    if (scale < 1.0) {
+        cv::resize(gray, scaled, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+
+    std::vector<cv::KeyPoint> keypoints;
+    cv::ORB::create(features)->detectAndCompute(scaled, cv::noArray(), keypoints, descriptors);
+    points.resize(keypoints.size());
+    for (size_t i = 0; i < keypoints.size(); i++) {
+        points[i] = keypoints[i].pt * static_cast<float>(1.0 / scale);
+    }
+}
+
+TemplateRegistry& TemplateRegistry::GetInstance() {
+    static TemplateRegistry instance;
+    return instance;
+}
+
+bool TemplateRegistry::Register(const std::string& id, const cv::Mat& reference,
+                                const std::vector<TemplateField>& fields) {
+    if (reference.empty()) {
+        return false;
+    }
+
+    auto entry = std::make_shared<Template>();
+    entry->id = id;
+    entry->size = reference.size();
+    entry->signature = computeTemplateSignature(reference);
+    entry->fields = fields;
+    double scale = 1.0;
+    findAnchors(reference, ANCHOR_TEMPLATE_FEATURES, entry->anchors, entry->descriptors, scale);
+    if (entry->anchors.size() < ANCHOR_MIN_COUNT) {
+        LOGW("Template %s rejected: %zu anchors", id.c_str(), entry->anchors.size());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Requests already holding the old template finish with it
+    templates_[id] = std::move(entry);
+    matches_[id] = 0;
+    LOGI("Template registered: %s (%zu fields)", id.c_str(), fields.size());
+    return true;
+}
+
+bool TemplateRegistry::Unregister(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    matches_.erase(id);
+    return templates_.erase(id) > 0;
+}
+
+std::vector<TemplateInfo> TemplateRegistry::List() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<TemplateInfo> list;
+    list.reserve(templates_.size());
+    for (const auto& [id, entry] : templates_) {
+        TemplateInfo info;
+        info.id = id;
+        info.width = entry->size.width;
+        info.height = entry->size.height;
+        info.anchors = entry->anchors.size();
+        info.fields = entry->fields.size();
+        info.matches = matches_[id];
+        list.push_back(std::move(info));
+    }
+    std::sort(list.begin(), list.end(), [](const TemplateInfo& a, const TemplateInfo& b) { return a.id < b.id; });
+    return list;
+}
+
+std::vector<std::pair<float, std::shared_ptr<const TemplateRegistry::Template>>> TemplateRegistry::Candidates(
+    const TemplateSignature& signature, const TemplateMatchOptions& match, TemplateOcrResult& result) {
+    std::vector<std::pair<float, std::shared_ptr<const Template>>> candidates;
+    float best = 2.0f;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [id, entry] : templates_) {
+        float aspect = signature.aspect / entry->signature.aspect;
+        if (std::max(aspect, 1.0f / aspect) > match.max_aspect_ratio) {
+            continue;
+        }
+        float edge = templateEdgeDistance(signature, entry->signature);
+        float region = templateRegionDistance(signature, entry->signature);
+        if (edge + region < best) {
+            best = edge + region;
+            result.edge_distance = edge;
+            result.region_distance = region;
+        }
+        if (edge <= match.max_edge_distance && region <= match.max_region_distance) {
+            candidates.emplace_back(edge + region, entry);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    return candidates;
+}
+
+// Reference-to-page homography from descriptor matches, or empty when too
+// few matches agree or the aligned reference is not a plausible page
+static cv::Mat alignToPage(const std::vector<cv::Point2f>& anchors, const cv::Mat& anchor_descriptors,
+                           const std::vector<cv::Point2f>& page_points, const cv::Mat& page_descriptors,
+                           double page_scale, const cv::Size& reference, const cv::Size& page,
+                           int min_inliers, int& inliers) {
+    inliers = 0;
+    if (anchor_descriptors.empty() || page_descriptors.empty()) {
+        return cv::Mat();
+    }
+
+    std::vector<std::vector<cv::DMatch>> knn;
+    cv::BFMatcher(cv::NORM_HAMMING).knnMatch(anchor_descriptors, page_descriptors, knn, 2);
+    std::vector<cv::Point2f> src, dst;
+    for (const auto& pair : knn) {
+        if (pair.size() == 2 && pair[0].distance < ANCHOR_RATIO_TEST * pair[1].distance) {
+            src.push_back(anchors[pair[0].queryIdx]);
+            dst.push_back(page_points[pair[0].trainIdx]);
+        }
+    }
+    if (static_cast<int>(src.size()) < min_inliers) {
+        return cv::Mat();
+    }
+
+    std::vector<uchar> mask;
+    cv::Mat homography = cv::findHomography(src, dst, cv::RANSAC, ANCHOR_REPROJ_ERROR / page_scale, mask);
+    inliers = cv::countNonZero(mask);
+    if (homography.empty() || inliers < min_inliers) {
+        return cv::Mat();
+    }
+
+    std::vector<cv::Point2f> corners = {
+        {0.0f, 0.0f}, {static_cast<float>(reference.width), 0.0f},
+        {static_cast<float>(reference.width), static_cast<float>(reference.height)},
+        {0.0f, static_cast<float>(reference.height)}};
+    std::vector<cv::Point2f> projected;
+    cv::perspectiveTransform(corners, projected, homography);
+    if (!cv::isContourConvex(projected) ||
+        cv::contourArea(projected) < ALIGN_MIN_AREA * page.area()) {
+        return cv::Mat();
+    }
+    return homography;
+}
+
+TemplateOcrResult TemplateRegistry::Recognize(OcrEngine& engine, const cv::Mat& image, const OcrOptions& options,
+                                              const TemplateMatchOptions& match) {
+    TemplateOcrResult result;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    TemplateSignature signature = computeTemplateSignature(image);
+    auto candidates = Candidates(signature, match, result);
+    if (!candidates.empty()) {
+        std::vector<cv::Point2f> page_points;
+        cv::Mat page_descriptors;
+        double page_scale = 1.0;
+        findAnchors(image, ANCHOR_PAGE_FEATURES, page_points, page_descriptors, page_scale);
+
+        for (const auto& [distance, entry] : candidates) {
+            int inliers = 0;
+            cv::Mat homography = alignToPage(entry->anchors, entry->descriptors, page_points, page_descriptors,
+                                             page_scale, entry->size, image.size(), match.min_inliers, inliers);
+            result.inliers = std::max(result.inliers, inliers);
+            if (homography.empty()) {
+                LOGD("Template %s: signature %.3f but alignment failed (%d inliers)",
+                     entry->id.c_str(), distance, inliers);
+                continue;
+            }
+
+            // Field regions mapped onto the page, all recognized in one call
+            std::vector<TextBox> boxes(entry->fields.size());
+            result.fields.resize(entry->fields.size());
+            for (size_t f = 0; f < entry->fields.size(); f++) {
+                const cv::Rect2f& roi = entry->fields[f].roi;
+                std::vector<cv::Point2f> corners = {
+                    roi.tl(), {roi.x + roi.width, roi.y}, roi.br(), {roi.x, roi.y + roi.height}};
+                std::vector<cv::Point2f> projected;
+                cv::perspectiveTransform(corners, projected, homography);
+                std::copy(projected.begin(), projected.end(), boxes[f].points.begin());
+                boxes[f].score = 1.0f;
+                result.fields[f].name = entry->fields[f].name;
+                result.fields[f].points = boxes[f].points;
+            }
+
+            std::vector<size_t> line_boxes;
+            TextLines lines = engine.RecognizeBoxes(image, boxes, options.rec_threshold, &line_boxes);
+            for (size_t k = 0; k < lines.size(); k++) {
+                TemplateFieldValue& value = result.fields[line_boxes[k]];
+                value.found = true;
+                value.text = std::string(lines[k].text);
+                value.score = lines[k].score;
+            }
+
+            result.matched = true;
+            result.template_id = entry->id;
+            result.inliers = inliers;
+            result.edge_distance = templateEdgeDistance(signature, entry->signature);
+            result.region_distance = templateRegionDistance(signature, entry->signature);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto counter = matches_.find(entry->id);
+                if (counter != matches_.end()) {
+                    counter->second++;
+                }
+            }
+            break;
+        }
+    }
+
+    if (!result.matched) {
+        result.fields.clear();
+        result.detector = options.detector;
+        result.lines = engine.RecognizeText(image, options, &result.detector);
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    LOGD("Template OCR: %s, %zu candidates, %lld ms",
+         result.matched ? result.template_id.c_str() : "no match", candidates.size(), (long long)elapsed);
+    return result;
+}
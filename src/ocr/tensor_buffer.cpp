@@ -0,0 +1,121 @@
+#include "include/tensor_buffer.h"
+#include "include/ocr_log.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+static const size_t HUGE_PAGE_SIZE = 2 << 20;
+static const size_t GROWTH_GRANULE = 64 << 10;  // Round capacity so small size changes reuse the buffer
+
+static std::atomic<bool> g_huge_pages{false};
+static std::atomic<size_t> g_total_bytes{0};
+
+TensorBuffer::~TensorBuffer() {
+    if (data_) {
+        g_total_bytes -= capacity_ * sizeof(float);
+        free(data_);
+    }
+}
+
+float* TensorBuffer::Reserve(size_t count) {
+    if (count <= capacity_) {
+        return data_;
+    }
+
+    size_t bytes = (count * sizeof(float) + GROWTH_GRANULE - 1) / GROWTH_GRANULE * GROWTH_GRANULE;
+    bool huge = g_huge_pages && bytes >= HUGE_PAGE_SIZE;
+    size_t alignment = huge ? HUGE_PAGE_SIZE : TENSOR_ALIGNMENT;
+    if (huge) {
+        bytes = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, bytes) != 0) {
+        throw std::bad_alloc();
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (huge && madvise(ptr, bytes, MADV_HUGEPAGE) != 0) {
+        LOGD("MADV_HUGEPAGE not applied to %zu byte tensor", bytes);
+    }
+#endif
+
+    if (data_) {
+        g_total_bytes -= capacity_ * sizeof(float);
+        free(data_);
+    }
+    data_ = static_cast<float*>(ptr);
+    capacity_ = bytes / sizeof(float);
+    g_total_bytes += bytes;
+    return data_;
+}
+
+void TensorBuffer::SetHugePages(bool enable) {
+    g_huge_pages = enable;
+}
+
+bool TensorBuffer::HugePagesEnabled() {
+    return g_huge_pages;
+}
+
+size_t TensorBuffer::TotalBytes() {
+    return g_total_bytes;
+}
+
+TensorBufferPool::Lease TensorBufferPool::Acquire() {
+    std::unique_ptr<TensorBuffer> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_.empty()) {
+            buffer = std::move(idle_.back());
+            idle_.pop_back();
+        }
+    }
+    if (!buffer) {
+        buffer.reset(new TensorBuffer());
+    }
+    return Lease(*this, std::move(buffer));
+}
+
+void TensorBufferPool::Return(std::unique_ptr<TensorBuffer> buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_back(std::move(buffer));
+}
+
+void TensorBufferPool::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.clear();
+}
+
+ProcessMemory readProcessMemory() {
+    ProcessMemory memory;
+#ifdef __APPLE__
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        memory.rss_kb = info.resident_size / 1024;
+        memory.peak_rss_kb = info.resident_size_max / 1024;
+    }
+#else
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file) {
+        char line[256];
+        while (fgets(line, sizeof(line), file)) {
+            if (strncmp(line, "VmRSS:", 6) == 0) {
+                memory.rss_kb = strtoul(line + 6, nullptr, 10);
+            } else if (strncmp(line, "VmHWM:", 6) == 0) {
+                memory.peak_rss_kb = strtoul(line + 6, nullptr, 10);
+            }
+        }
+        fclose(file);
+    }
+#endif
+    return memory;
+}
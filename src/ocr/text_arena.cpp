@@ -0,0 +1,67 @@
+#include "include/text_arena.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// Hand-written so the source lets go of the cursor into a block it no longer owns
+TextArena::TextArena(TextArena&& other) noexcept
+    : blocks_(std::move(other.blocks_)),
+      block_size_(other.block_size_),
+      cursor_(std::exchange(other.cursor_, nullptr)),
+      remaining_(std::exchange(other.remaining_, 0)),
+      used_(std::exchange(other.used_, 0)) {
+    other.blocks_.clear();
+}
+
+TextArena& TextArena::operator=(TextArena&& other) noexcept {
+    if (this != &other) {
+        blocks_ = std::move(other.blocks_);
+        block_size_ = other.block_size_;
+        cursor_ = std::exchange(other.cursor_, nullptr);
+        remaining_ = std::exchange(other.remaining_, 0);
+        used_ = std::exchange(other.used_, 0);
+        other.blocks_.clear();
+    }
+    return *this;
+}
+
+void TextArena::AddBlock(size_t min_size) {
+    size_t size = std::max(block_size_, min_size);
+    blocks_.push_back({std::unique_ptr<char[]>(new char[size]), size});
+    cursor_ = blocks_.back().data.get();
+    remaining_ = size;
+}
+
+std::string_view TextArena::Store(std::string_view text) {
+    if (text.empty()) {
+        return std::string_view();
+    }
+    if (text.size() > remaining_) {
+        AddBlock(text.size());
+    }
+    char* dst = cursor_;
+    std::memcpy(dst, text.data(), text.size());
+    cursor_ += text.size();
+    remaining_ -= text.size();
+    used_ += text.size();
+    return std::string_view(dst, text.size());
+}
+
+void TextArena::Reserve(size_t bytes) {
+    if (bytes > remaining_) {
+        AddBlock(bytes);
+    }
+}
+
+void TextArena::Clear() {
+    if (blocks_.size() > 1) {
+        auto largest = std::max_element(blocks_.begin(), blocks_.end(),
+                                        [](const Block& a, const Block& b) { return a.size < b.size; });
+        Block keep = std::move(*largest);
+        blocks_.clear();
+        blocks_.push_back(std::move(keep));
+    }
+    cursor_ = blocks_.empty() ? nullptr : blocks_.back().data.get();
+    remaining_ = blocks_.empty() ? 0 : blocks_.back().size;
+    used_ = 0;
+}
@@ -0,0 +1,180 @@
+#include "include/text_utils.h"
+#include <algorithm>
+
+static const char32_t REPLACEMENT_CHAR = 0xFFFD;
+
+// Tag bytes that keep the three term kinds apart
+static const char TERM_TOKEN = 'T';
+static const char TERM_BIGRAM = 'B';
+static const char TERM_UNIGRAM = 'U';
+
+char32_t nextUtf8CodePoint(std::string_view text, size_t& i) {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    int extra;
+    char32_t cp;
+    if (c < 0x80) {
+        i++;
+        return c;
+    } else if ((c & 0xE0) == 0xC0) {
+        extra = 1;
+        cp = c & 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+        extra = 2;
+        cp = c & 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+        extra = 3;
+        cp = c & 0x07;
+    } else {
+        i++;
+        return REPLACEMENT_CHAR;
+    }
+
+    if (i + extra >= text.size()) {
+        i = text.size();
+        return REPLACEMENT_CHAR;
+    }
+    for (int k = 1; k <= extra; k++) {
+        unsigned char cc = static_cast<unsigned char>(text[i + k]);
+        if ((cc & 0xC0) != 0x80) {
+            i += k;
+            return REPLACEMENT_CHAR;
+        }
+        cp = (cp << 6) | (cc & 0x3F);
+    }
+    i += extra + 1;
+    return cp;
+}
+
+std::u32string decodeUtf8(std::string_view text) {
+    std::u32string out;
+    out.reserve(text.size());
+    size_t i = 0;
+    while (i < text.size()) {
+        out.push_back(nextUtf8CodePoint(text, i));
+    }
+    return out;
+}
+
+void appendUtf8(std::string& out, char32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+std::string encodeUtf8(const std::u32string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char32_t cp : text) {
+        appendUtf8(out, cp);
+    }
+    return out;
+}
+
+std::vector<uint32_t> utf8CodePointOffsets(std::string_view text) {
+    std::vector<uint32_t> offsets;
+    offsets.reserve(text.size() + 1);
+    size_t i = 0;
+    while (i < text.size()) {
+        offsets.push_back(static_cast<uint32_t>(i));
+        nextUtf8CodePoint(text, i);
+    }
+    offsets.push_back(static_cast<uint32_t>(text.size()));
+    return offsets;
+}
+
+bool isCjkCodePoint(char32_t cp) {
+    return (cp >= 0x4E00 && cp <= 0x9FFF) ||    // CJK Unified Ideographs
+           (cp >= 0x3400 && cp <= 0x4DBF) ||    // Extension A
+           (cp >= 0x20000 && cp <= 0x2FA1F) ||  // Extensions B+ and compatibility supplement
+           (cp >= 0xF900 && cp <= 0xFAFF) ||    // Compatibility Ideographs
+           (cp >= 0x3040 && cp <= 0x30FF) ||    // Hiragana, Katakana
+           (cp >= 0xAC00 && cp <= 0xD7AF);      // Hangul syllables
+}
+
+bool isLatinWordCodePoint(char32_t cp) {
+    if (cp < 0x80) {
+        return (cp >= '0' && cp <= '9') || (cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z');
+    }
+    // Fullwidth digits and letters (common in CJK documents)
+    if ((cp >= 0xFF10 && cp <= 0xFF19) || (cp >= 0xFF21 && cp <= 0xFF3A) || (cp >= 0xFF41 && cp <= 0xFF5A)) {
+        return true;
+    }
+    return cp >= 0xC0 && cp <= 0x24F && cp != 0xD7 && cp != 0xF7;
+}
+
+char32_t foldCase(char32_t cp) {
+    // Fullwidth forms fold to ASCII so "ＡＢ１" matches "ab1"
+    if (cp >= 0xFF01 && cp <= 0xFF5E) {
+        cp -= 0xFEE0;
+    }
+    if ((cp >= 'A' && cp <= 'Z') || (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7)) {
+        return cp + 0x20;
+    }
+    return cp;
+}
+
+static void appendTerm(std::vector<std::string>& terms, char tag, const char32_t* cps, size_t count) {
+    std::string term(1, tag);
+    for (size_t i = 0; i < count; i++) {
+        appendUtf8(term, cps[i]);
+    }
+    terms.push_back(std::move(term));
+}
+
+static std::vector<std::string> collectTerms(const std::string& text, bool for_query) {
+    std::vector<std::string> terms;
+    std::u32string cps = decodeUtf8(text);
+
+    size_t i = 0;
+    while (i < cps.size()) {
+        char32_t cp = cps[i];
+        if (isCjkCodePoint(cp)) {
+            size_t start = i;
+            while (i < cps.size() && isCjkCodePoint(cps[i])) {
+                i++;
+            }
+            size_t run = i - start;
+            for (size_t k = start; k + 1 < i; k++) {
+                appendTerm(terms, TERM_BIGRAM, &cps[k], 2);
+            }
+            if (!for_query || run == 1) {
+                for (size_t k = start; k < i; k++) {
+                    appendTerm(terms, TERM_UNIGRAM, &cps[k], 1);
+                }
+            }
+        } else if (isLatinWordCodePoint(cp)) {
+            std::u32string token;
+            while (i < cps.size() && isLatinWordCodePoint(cps[i])) {
+                token.push_back(foldCase(cps[i]));
+                i++;
+            }
+            appendTerm(terms, TERM_TOKEN, token.data(), token.size());
+        } else {
+            i++;
+        }
+    }
+
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    return terms;
+}
+
+std::vector<std::string> indexTerms(const std::string& text) {
+    return collectTerms(text, false);
+}
+
+std::vector<std::string> queryTerms(const std::string& query) {
+    return collectTerms(query, true);
+}
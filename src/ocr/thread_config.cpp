@@ -0,0 +1,127 @@
+#include "include/thread_config.h"
+#include "include/ocr_log.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+// First integer in a sysfs file, 0 if missing
+static long readSysfsLong(const std::string& path) {
+    std::ifstream file(path);
+    long value = 0;
+    if (!(file >> value)) {
+        return 0;
+    }
+    return value;
+}
+
+CpuTopology detectCpuTopology() {
+    CpuTopology topology;
+
+    long count = sysconf(_SC_NPROCESSORS_CONF);
+    if (count <= 0) {
+        return topology;
+    }
+
+    topology.capacity.resize(count, 0);
+    for (long cpu = 0; cpu < count; cpu++) {
+        std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        long capacity = readSysfsLong(base + "/cpu_capacity");
+        if (capacity <= 0) {
+            capacity = readSysfsLong(base + "/cpufreq/cpuinfo_max_freq");
+        }
+        topology.capacity[cpu] = static_cast<int>(capacity);
+    }
+
+    auto [min_it, max_it] = std::minmax_element(topology.capacity.begin(), topology.capacity.end());
+    int threshold = (*min_it + *max_it) / 2;
+    for (long cpu = 0; cpu < count; cpu++) {
+        // Symmetric or unknown (all equal): every core is a performance core
+        if (*min_it == *max_it || topology.capacity[cpu] > threshold) {
+            topology.performance.push_back(static_cast<int>(cpu));
+        } else {
+            topology.efficiency.push_back(static_cast<int>(cpu));
+        }
+    }
+    return topology;
+}
+
+std::vector<int> cpuSetByName(const CpuTopology& topology, const std::string& name) {
+    if (name == "performance") {
+        return topology.performance;
+    }
+    if (name == "efficiency") {
+        return topology.efficiency.empty() ? topology.performance : topology.efficiency;
+    }
+    if (name == "all") {
+        std::vector<int> all(topology.performance);
+        all.insert(all.end(), topology.efficiency.begin(), topology.efficiency.end());
+        std::sort(all.begin(), all.end());
+        return all;
+    }
+    return {};
+}
+
+void applyThreadConfig(Ort::SessionOptions& options, const ThreadPoolConfig& config) {
+    options.SetIntraOpNumThreads(config.intra_op_threads);
+    options.SetInterOpNumThreads(config.inter_op_threads);
+
+#if defined(__linux__)
+    if (config.cpus.empty() || config.intra_op_threads <= 1) {
+        return;
+    }
+
+    // One entry per worker thread (the calling thread is not listed);
+    // ORT numbers logical processors from 1
+    std::ostringstream affinities;
+    for (int t = 0; t < config.intra_op_threads - 1; t++) {
+        if (t > 0) {
+            affinities << ";";
+        }
+        affinities << config.cpus[t % config.cpus.size()] + 1;
+    }
+    options.AddConfigEntry("session.intra_op_thread_affinities", affinities.str().c_str());
+    LOGD("Intra-op thread affinities: %s", affinities.str().c_str());
+#endif
+}
+
+ScopedThreadAffinity::ScopedThreadAffinity(const std::vector<int>& cpus) {
+#if defined(__linux__)
+    if (cpus.empty()) {
+        return;
+    }
+
+    cpu_set_t saved;
+    CPU_ZERO(&saved);
+    if (sched_getaffinity(0, sizeof(saved), &saved) != 0) {
+        return;
+    }
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &mask);
+        }
+    }
+    if (sched_setaffinity(0, sizeof(mask), &mask) == 0) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&saved);
+        saved_mask_.assign(bytes, bytes + sizeof(saved));
+        pinned_ = true;
+    }
+#else
+    (void)cpus;
+#endif
+}
+
+ScopedThreadAffinity::~ScopedThreadAffinity() {
+#if defined(__linux__)
+    if (pinned_) {
+        sched_setaffinity(0, saved_mask_.size(), reinterpret_cast<const cpu_set_t*>(saved_mask_.data()));
+    }
+#endif
+}
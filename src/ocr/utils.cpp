@@ -1,4 +1,5 @@
 #include "include/utils.h"
+#include "include/pipeline_kernels.h"
 
 std::pair<cv::Mat, std::vector<float>> preprocessImage(const cv::Mat& img, int target_width, int target_height) {
     int orig_height = img.rows;
@@ -18,14 +19,5 @@ std::pair<cv::Mat, std::vector<float>> preprocessImage(const cv::Mat& img, int t
 }
 
 cv::Mat imageToBlob(const cv::Mat& img) {
-    cv::Mat blob = cv::dnn::blobFromImage(
-        img,
-        1.0 / 255.0,
-        cv::Size(),
-        cv::Scalar(0, 0, 0),
-        false,
-        false,
-        CV_32F
-    );
-    return blob;
+    return MakeInputBlob<LayoutInputPipeline>(img);
 }
@@ -0,0 +1,162 @@
+#include "include/video_ocr.h"
+#include "include/ocr_log.h"
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+static const int THUMB_WIDTH = 64;  // Width of the downscaled frame used for change detection
+
+// Small blurred grayscale thumbnail, cheap to compare between frames
+static cv::Mat makeThumbnail(const cv::Mat& frame) {
+    int thumb_h = std::max(1, static_cast<int>(std::lround(
+        static_cast<double>(frame.rows) * THUMB_WIDTH / std::max(1, frame.cols))));
+
+    cv::Mat gray;
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+
+    cv::Mat thumb;
+    cv::resize(gray, thumb, cv::Size(THUMB_WIDTH, thumb_h), 0, 0, cv::INTER_AREA);
+    cv::GaussianBlur(thumb, thumb, cv::Size(3, 3), 0);
+    return thumb;
+}
+
+// Mean absolute difference of two thumbnails, normalized to 0-1
+static float thumbnailDiff(const cv::Mat& a, const cv::Mat& b) {
+    if (a.empty() || b.empty() || a.size() != b.size()) {
+        return 1.0f;
+    }
+    cv::Mat diff;
+    cv::absdiff(a, b, diff);
+    return static_cast<float>(cv::mean(diff)[0] / 255.0);
+}
+
+// Text key used to decide whether two keyframes show the same content:
+// whitespace removed and Latin letters lowercased, so small spacing noise is ignored
+static std::string normalizeText(const std::string& text) {
+    std::string key;
+    key.reserve(text.size());
+    for (unsigned char c : text) {
+        if (std::isspace(c)) {
+            continue;
+        }
+        key += static_cast<char>(c < 0x80 ? std::tolower(c) : c);
+    }
+    return key;
+}
+
+std::vector<VideoTextSegment> recognizeVideo(const std::string& video_path,
+                                             const VideoOcrOptions& options,
+                                             VideoOcrStats* stats) {
+    std::vector<VideoTextSegment> segments;
+    VideoOcrStats local_stats;
+
+    cv::VideoCapture capture(video_path);
+    if (!capture.isOpened()) {
+        LOGW("Could not open video: %s", video_path.c_str());
+        if (stats) *stats = local_stats;
+        return segments;
+    }
+
+    double fps = capture.get(cv::CAP_PROP_FPS);
+    if (!(fps > 0.0)) {
+        fps = 30.0;
+    }
+    int step = std::max(1, static_cast<int>(std::lround(fps * options.sample_interval_ms / 1000.0)));
+
+    local_stats.video_width = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH));
+    local_stats.video_height = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT));
+
+    LOGD("Video OCR: %s, %.2f fps, sampling every %d frames", video_path.c_str(), fps, step);
+
+    OcrEngine& engine = OcrEngine::GetInstance();
+
+    cv::Mat last_key_thumb;
+    std::string current_key;  // Normalized text of the open segment (empty = none open)
+    bool segment_open = false;
+
+    cv::Mat frame;
+    for (int frame_idx = 0; capture.grab(); frame_idx++) {
+        local_stats.frames_total++;
+
+        // Only decode the sampled frames; grab() keeps the stream position moving
+        if (frame_idx % step != 0) {
+            continue;
+        }
+        if (!capture.retrieve(frame) || frame.empty()) {
+            continue;
+        }
+
+        double timestamp_ms = frame_idx * 1000.0 / fps;
+        local_stats.frames_sampled++;
+
+        cv::Rect frame_rect(0, 0, frame.cols, frame.rows);
+        cv::Rect roi = options.roi.area() > 0 ? (options.roi & frame_rect) : frame_rect;
+        if (roi.area() == 0) {
+            roi = frame_rect;
+        }
+        cv::Mat view = frame(roi);
+
+        // Cheap change check on a downscaled copy of the watched region
+        cv::Mat thumb = makeThumbnail(view);
+        if (!last_key_thumb.empty() && thumbnailDiff(thumb, last_key_thumb) < options.change_threshold) {
+            if (segment_open) {
+                segments.back().end_ms = timestamp_ms;
+            }
+            continue;
+        }
+
+        last_key_thumb = thumb;
+        local_stats.keyframes++;
+
+        // Detection first: a changed frame without any text closes the open segment
+        std::vector<TextBox> boxes = engine.DetectText(view, options.det_threshold);
+        TextLines lines;
+        if (!boxes.empty()) {
+            lines = engine.RecognizeBoxes(view, boxes, options.rec_threshold);
+            local_stats.ocr_runs++;
+        }
+
+        std::string text = getFullText(lines);
+        std::string key = normalizeText(text);
+
+        if (key.empty()) {
+            segment_open = false;
+            current_key.clear();
+            continue;
+        }
+
+        // Same text as the open segment (e.g. a camera cut behind a subtitle): extend it
+        if (segment_open && key == current_key) {
+            segments.back().end_ms = timestamp_ms;
+            continue;
+        }
+
+        // Map lines back to full frame coordinates
+        for (auto& line : lines) {
+            line.x1 += roi.x;
+            line.x2 += roi.x;
+            line.y1 += roi.y;
+            line.y2 += roi.y;
+        }
+
+        VideoTextSegment segment;
+        segment.start_ms = timestamp_ms;
+        segment.end_ms = timestamp_ms;
+        segment.text = std::move(text);
+        segment.lines = std::move(lines);
+        segments.push_back(std::move(segment));
+
+        segment_open = true;
+        current_key = std::move(key);
+    }
+
+    local_stats.duration_ms = local_stats.frames_total * 1000.0 / fps;
+
+    LOGD("Video OCR done: %d frames, %d sampled, %d keyframes, %d OCR runs, %zu segments",
+         local_stats.frames_total, local_stats.frames_sampled, local_stats.keyframes,
+         local_stats.ocr_runs, segments.size());
+
+    if (stats) *stats = local_stats;
+    return segments;
+}
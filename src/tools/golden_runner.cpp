@@ -0,0 +1,62 @@
+// Golden corpus runner (desktop). Replays a corpus against the current build
+// and prints the JSON report; exits 1 if any image or kernel is out of tolerance.
+//
+//   ocr_golden <det.onnx> <rec.onnx> <dict.txt> <manifest.json> [--iterations N] [--half-res] [--record]
+//
+// --record rewrites the manifest's expected lines from this build's output
+// (bump "version" in the manifest when doing so on purpose). --half-res runs
+// detection with half-resolution post-processing against the same goldens.
+
+#include "ocr/include/golden_corpus.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::fprintf(stderr,
+                     "usage: %s <det.onnx> <rec.onnx> <dict.txt> <manifest.json> "
+                     "[--iterations N] [--half-res] [--record]\n", argv[0]);
+        return 2;
+    }
+
+    int iterations = 3;
+    bool record = false;
+    bool half_res = false;
+    for (int i = 5; i < argc; i++) {
+        if (std::strcmp(argv[i], "--record") == 0) {
+            record = true;
+        } else if (std::strcmp(argv[i], "--half-res") == 0) {
+            half_res = true;
+        } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        }
+    }
+
+    GoldenCorpus corpus;
+    if (!loadGoldenCorpus(argv[4], corpus)) {
+        std::fprintf(stderr, "cannot read corpus manifest %s\n", argv[4]);
+        return 2;
+    }
+
+    OcrEngine& engine = OcrEngine::GetInstance();
+    engine.Init(argv[1], argv[2], argv[3]);
+    if (!engine.IsInitialized()) {
+        std::fprintf(stderr, "cannot load models\n");
+        return 2;
+    }
+
+    if (record) {
+        recordGoldenCorpus(engine, corpus);
+        if (!saveGoldenCorpus(argv[4], corpus)) {
+            std::fprintf(stderr, "cannot write %s\n", argv[4]);
+            return 2;
+        }
+        std::printf("recorded %zu images into %s (version %d)\n", corpus.items.size(), argv[4], corpus.version);
+        return 0;
+    }
+
+    GoldenReport report = runGoldenCorpus(engine, corpus, GoldenTolerance(), iterations, half_res);
+    std::printf("%s\n", goldenReportToJson(report).c_str());
+    return report.passed ? 0 : 1;
+}